@@ -0,0 +1,70 @@
+#ifndef _DG_ADT_ARENA_H_
+#define _DG_ADT_ARENA_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dg {
+namespace ADT {
+
+// A bump allocator. The memory is taken from big chunks,
+// so the objects allocated one after another lie next to each other
+// in memory. The memory is freed all at once when the arena is destroyed,
+// the arena does not call the destructors of the objects.
+class Arena
+{
+    static const size_t CHUNK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> chunks;
+    uintptr_t cur{0};
+    uintptr_t end{0};
+
+    static uintptr_t alignUp(uintptr_t p, size_t align) {
+        return (p + align - 1) & ~static_cast<uintptr_t>(align - 1);
+    }
+
+public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    Arena(Arena&& oth)
+    : chunks(std::move(oth.chunks)), cur(oth.cur), end(oth.end) {
+        oth.cur = oth.end = 0;
+    }
+
+    Arena& operator=(Arena&& oth) {
+        chunks = std::move(oth.chunks);
+        cur = oth.cur;
+        end = oth.end;
+        oth.cur = oth.end = 0;
+        return *this;
+    }
+
+    void *allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        assert(align > 0 && (align & (align - 1)) == 0
+               && "The alignment must be a power of two");
+
+        uintptr_t p = alignUp(cur, align);
+        if (cur == 0 || p + size > end) {
+            size_t chunkSize = size + align > CHUNK_SIZE ?
+                                size + align : CHUNK_SIZE;
+            chunks.emplace_back(new char[chunkSize]);
+            cur = reinterpret_cast<uintptr_t>(chunks.back().get());
+            end = cur + chunkSize;
+            p = alignUp(cur, align);
+        }
+
+        assert(p + size <= end);
+        cur = p + size;
+        return reinterpret_cast<void *>(p);
+    }
+};
+
+} // namespace ADT
+} // namespace dg
+
+#endif // _DG_ADT_ARENA_H_
@@ -0,0 +1,514 @@
+#ifndef _DG_BDD_H_
+#define _DG_BDD_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dg {
+namespace ADT {
+
+///
+// A small package of reduced ordered binary decision diagrams.
+// The nodes are hash-consed in the unique table of the manager,
+// so every boolean function has exactly one node and two
+// functions are equal iff their nodes are the same number.
+// The results of the operations are memoized in a computed table
+// of a fixed size where a new result overwrites the old result
+// with the same hash (as in BuDDy or CUDD), so the table does not
+// grow with the number of operations. The nodes are never released
+// (there is no garbage collection), the memory is freed together
+// with the manager.
+//
+// The variables are identified by their levels (the order
+// of the variables in the diagrams), the lower level is closer
+// to the root. Numbers are encoded in the diagrams using a vector
+// of levels, the first level holds the most significant bit.
+class BDDManager {
+public:
+    using NodeT = uint32_t;
+    using LevelT = uint32_t;
+
+    // the terminal nodes
+    enum : NodeT { ZERO = 0, ONE = 1 };
+    // the level of the terminal nodes (below all variables)
+    enum : LevelT { TERMINAL_LEVEL = ~static_cast<LevelT>(0) };
+
+private:
+    struct Node {
+        LevelT level;
+        NodeT low;
+        NodeT high;
+
+        bool operator==(const Node& rhs) const {
+            return level == rhs.level && low == rhs.low && high == rhs.high;
+        }
+    };
+
+    struct NodeHash {
+        size_t operator()(const Node& n) const {
+            size_t h = std::hash<LevelT>()(n.level);
+            h ^= std::hash<NodeT>()(n.low) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= std::hash<NodeT>()(n.high) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+
+    enum class Op : uint32_t { AND, OR, DIFF, EXISTS, RELPROD, REPLACE };
+
+    struct OpKey {
+        Op op;
+        NodeT a, b, c;
+
+        bool operator==(const OpKey& rhs) const {
+            return op == rhs.op && a == rhs.a && b == rhs.b && c == rhs.c;
+        }
+    };
+
+    static size_t hashKey(const OpKey& k) {
+        size_t h = std::hash<uint32_t>()(static_cast<uint32_t>(k.op));
+        h ^= std::hash<NodeT>()(k.a) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= std::hash<NodeT>()(k.b) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= std::hash<NodeT>()(k.c) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h;
+    }
+
+    // an entry of the computed table, only the entries
+    // from the current generation are valid
+    struct CacheEntry {
+        OpKey key{Op::AND, ZERO, ZERO, ZERO};
+        NodeT result{ZERO};
+        uint32_t generation{0};
+    };
+
+    std::vector<Node> nodes;
+    std::unordered_map<Node, NodeT, NodeHash> unique;
+    // the computed table (the size is a power of two)
+    std::vector<CacheEntry> cache;
+    // clearing the manager invalidates the computed table
+    // by starting a new generation of entries
+    uint32_t generation{1};
+    // renamings of variables, indexed by the old level
+    std::vector<std::vector<LevelT>> renamings;
+
+    NodeT cofactor(NodeT n, LevelT l, bool high) const {
+        if (level(n) != l)
+            return n;
+        return high ? nodes[n].high : nodes[n].low;
+    }
+
+    CacheEntry& cacheEntry(const OpKey& key) {
+        return cache[hashKey(key) & (cache.size() - 1)];
+    }
+
+    bool lookup(const OpKey& key, NodeT& result) {
+        const CacheEntry& entry = cacheEntry(key);
+        if (entry.generation != generation || !(entry.key == key))
+            return false;
+        result = entry.result;
+        return true;
+    }
+
+    NodeT store(const OpKey& key, NodeT result) {
+        CacheEntry& entry = cacheEntry(key);
+        entry.key = key;
+        entry.result = result;
+        entry.generation = generation;
+        return result;
+    }
+
+    // skip the variables of the cube that are above the level 'l'
+    NodeT skipCube(NodeT cube, LevelT l) const {
+        while (cube != ONE && level(cube) < l)
+            cube = nodes[cube].high;
+        return cube;
+    }
+
+    NodeT apply(Op op, NodeT a, NodeT b) {
+        switch (op) {
+        case Op::AND:
+            if (a == ZERO || b == ZERO)
+                return ZERO;
+            if (a == ONE || a == b)
+                return b;
+            if (b == ONE)
+                return a;
+            break;
+        case Op::OR:
+            if (a == ONE || b == ONE)
+                return ONE;
+            if (a == ZERO || a == b)
+                return b;
+            if (b == ZERO)
+                return a;
+            break;
+        case Op::DIFF:
+            if (a == ZERO || b == ONE || a == b)
+                return ZERO;
+            if (b == ZERO)
+                return a;
+            break;
+        default:
+            assert(0 && "Not a binary operation");
+        }
+
+        // AND and OR are commutative
+        if (op != Op::DIFF && a > b)
+            std::swap(a, b);
+
+        OpKey key{op, a, b, 0};
+        NodeT result;
+        if (lookup(key, result))
+            return result;
+
+        LevelT l = std::min(level(a), level(b));
+        NodeT low = apply(op, cofactor(a, l, false), cofactor(b, l, false));
+        NodeT high = apply(op, cofactor(a, l, true), cofactor(b, l, true));
+        return store(key, makeNode(l, low, high));
+    }
+
+public:
+    // 'cacheSize' is the number of entries of the computed table
+    // (rounded up to a power of two)
+    BDDManager(size_t cacheSize = 1 << 16) {
+        size_t size = 1;
+        while (size < cacheSize)
+            size <<= 1;
+        cache.resize(size);
+
+        // the terminals
+        nodes.push_back({TERMINAL_LEVEL, ZERO, ZERO});
+        nodes.push_back({TERMINAL_LEVEL, ONE, ONE});
+    }
+
+    BDDManager(const BDDManager&) = delete;
+    BDDManager& operator=(const BDDManager&) = delete;
+
+    // remove all the nodes and renamings except the terminals
+    // (all the BDDs but ZERO and ONE are invalid then)
+    void clear() {
+        nodes.resize(2);
+        std::vector<Node>(nodes).swap(nodes);
+        std::unordered_map<Node, NodeT, NodeHash>().swap(unique);
+        std::vector<std::vector<LevelT>>().swap(renamings);
+
+        if (++generation == 0) {
+            std::fill(cache.begin(), cache.end(), CacheEntry());
+            generation = 1;
+        }
+    }
+
+    LevelT level(NodeT n) const { return nodes[n].level; }
+    NodeT low(NodeT n) const { return nodes[n].low; }
+    NodeT high(NodeT n) const { return nodes[n].high; }
+    bool isTerminal(NodeT n) const { return n <= ONE; }
+
+    // the number of nodes in the manager
+    size_t size() const { return nodes.size(); }
+
+    // the approximate number of bytes taken by the nodes,
+    // the unique table and the computed table
+    size_t memoryUsage() const {
+        size_t mem = nodes.capacity() * sizeof(Node)
+                     + unique.bucket_count() * sizeof(void *)
+                     // the key, the value and the pointer to the next entry
+                     + unique.size() * (sizeof(Node) + sizeof(NodeT) + sizeof(void *))
+                     + cache.capacity() * sizeof(CacheEntry);
+        for (const auto& r : renamings)
+            mem += r.capacity() * sizeof(LevelT);
+        return mem;
+    }
+
+    NodeT makeNode(LevelT l, NodeT low, NodeT high) {
+        assert(l < level(low) && l < level(high) && "Unordered BDD");
+        if (low == high)
+            return low;
+
+        Node n{l, low, high};
+        auto it = unique.emplace(n, static_cast<NodeT>(nodes.size()));
+        if (it.second)
+            nodes.push_back(n);
+
+        return it.first->second;
+    }
+
+    NodeT var(LevelT l) { return makeNode(l, ZERO, ONE); }
+    NodeT nvar(LevelT l) { return makeNode(l, ONE, ZERO); }
+
+    NodeT bddAnd(NodeT a, NodeT b) { return apply(Op::AND, a, b); }
+    NodeT bddOr(NodeT a, NodeT b) { return apply(Op::OR, a, b); }
+    // a and not b
+    NodeT bddDiff(NodeT a, NodeT b) { return apply(Op::DIFF, a, b); }
+
+    // the conjunction of the variables, used as the set
+    // of the variables for quantification
+    NodeT cube(std::vector<LevelT> levels) {
+        std::sort(levels.begin(), levels.end());
+        NodeT n = ONE;
+        for (auto it = levels.rbegin(), et = levels.rend(); it != et; ++it)
+            n = makeNode(*it, ZERO, n);
+        return n;
+    }
+
+    // existential quantification of the variables from 'cube'
+    NodeT exists(NodeT n, NodeT cube) {
+        if (isTerminal(n))
+            return n;
+
+        cube = skipCube(cube, level(n));
+        if (cube == ONE)
+            return n;
+
+        OpKey key{Op::EXISTS, n, cube, 0};
+        NodeT result;
+        if (lookup(key, result))
+            return result;
+
+        LevelT l = level(n);
+        if (level(cube) == l) {
+            NodeT rest = nodes[cube].high;
+            NodeT lowRes = exists(nodes[n].low, rest);
+            if (lowRes == ONE)
+                return store(key, ONE);
+            return store(key, bddOr(lowRes, exists(nodes[n].high, rest)));
+        }
+
+        NodeT lowRes = exists(nodes[n].low, cube);
+        return store(key, makeNode(l, lowRes, exists(nodes[n].high, cube)));
+    }
+
+    // relational product: exists cube. (a and b), computed
+    // without building the whole conjunction
+    NodeT relProd(NodeT a, NodeT b, NodeT cube) {
+        if (a == ZERO || b == ZERO)
+            return ZERO;
+        if (a == ONE)
+            return exists(b, cube);
+        if (b == ONE || a == b)
+            return exists(a, cube);
+
+        LevelT l = std::min(level(a), level(b));
+        cube = skipCube(cube, l);
+        if (cube == ONE)
+            return bddAnd(a, b);
+
+        if (a > b)
+            std::swap(a, b);
+
+        OpKey key{Op::RELPROD, a, b, cube};
+        NodeT result;
+        if (lookup(key, result))
+            return result;
+
+        if (level(cube) == l) {
+            NodeT rest = nodes[cube].high;
+            NodeT lowRes = relProd(cofactor(a, l, false),
+                                   cofactor(b, l, false), rest);
+            if (lowRes == ONE)
+                return store(key, ONE);
+            return store(key, bddOr(lowRes,
+                                    relProd(cofactor(a, l, true),
+                                            cofactor(b, l, true), rest)));
+        }
+
+        NodeT lowRes = relProd(cofactor(a, l, false), cofactor(b, l, false), cube);
+        NodeT highRes = relProd(cofactor(a, l, true), cofactor(b, l, true), cube);
+        return store(key, makeNode(l, lowRes, highRes));
+    }
+
+    // register the renaming of the variables 'from[i]' -> 'to[i]'
+    // (the new variables must not be used in the renamed diagrams)
+    // and return its ID for replace()
+    unsigned addRenaming(const std::vector<LevelT>& from,
+                         const std::vector<LevelT>& to) {
+        assert(from.size() == to.size());
+        std::vector<LevelT> map;
+        for (size_t i = 0; i < from.size(); ++i) {
+            if (map.size() <= from[i])
+                map.resize(from[i] + 1, TERMINAL_LEVEL);
+            map[from[i]] = to[i];
+        }
+
+        renamings.push_back(std::move(map));
+        return static_cast<unsigned>(renamings.size() - 1);
+    }
+
+    NodeT replace(NodeT n, unsigned renaming) {
+        if (isTerminal(n))
+            return n;
+
+        OpKey key{Op::REPLACE, n, renaming, 0};
+        NodeT result;
+        if (lookup(key, result))
+            return result;
+
+        const auto& map = renamings[renaming];
+        LevelT l = level(n);
+        if (l < map.size() && map[l] != TERMINAL_LEVEL)
+            l = map[l];
+
+        NodeT lowRes = replace(nodes[n].low, renaming);
+        NodeT highRes = replace(nodes[n].high, renaming);
+        // if the renaming keeps the order, this is just a new node
+        if (l < level(lowRes) && l < level(highRes))
+            return store(key, makeNode(l, lowRes, highRes));
+
+        return store(key, bddOr(bddAnd(var(l), highRes),
+                                bddAnd(nvar(l), lowRes)));
+    }
+
+    // the diagram of the single number 'value' encoded in 'levels'
+    // (the levels must be sorted)
+    NodeT minterm(uint64_t value, const std::vector<LevelT>& levels) {
+        assert(levels.size() <= 64);
+        NodeT n = ONE;
+        for (size_t i = levels.size(); i > 0; --i) {
+            bool bit = (value >> (levels.size() - i)) & 1;
+            n = bit ? makeNode(levels[i - 1], ZERO, n)
+                    : makeNode(levels[i - 1], n, ZERO);
+        }
+        return n;
+    }
+
+    // is the number 'value' encoded in 'levels' in the set 'n'?
+    bool contains(NodeT n, uint64_t value,
+                  const std::vector<LevelT>& levels) const {
+        size_t i = 0;
+        while (!isTerminal(n)) {
+            while (i < levels.size() && levels[i] < level(n))
+                ++i;
+            assert(i < levels.size() && levels[i] == level(n)
+                   && "The diagram uses other variables");
+
+            bool bit = (value >> (levels.size() - 1 - i)) & 1;
+            n = bit ? nodes[n].high : nodes[n].low;
+        }
+
+        return n == ONE;
+    }
+
+    // the number of the numbers encoded in 'levels'
+    // that are in the set 'n'
+    uint64_t count(NodeT n, const std::vector<LevelT>& levels) const {
+        std::unordered_map<NodeT, uint64_t> counts;
+        // the index of the level of the node in 'levels'
+        auto position = [&levels](LevelT l) -> size_t {
+            return std::lower_bound(levels.begin(), levels.end(), l)
+                    - levels.begin();
+        };
+
+        // the number of assignments to the variables from
+        // the level of the node downwards
+        std::function<uint64_t(NodeT)> countFrom = [&](NodeT m) -> uint64_t {
+            if (isTerminal(m))
+                return m == ONE ? 1 : 0;
+
+            auto it = counts.find(m);
+            if (it != counts.end())
+                return it->second;
+
+            size_t pos = position(level(m));
+            uint64_t num = 0;
+            for (NodeT succ : {nodes[m].low, nodes[m].high})
+                num += countFrom(succ) << (position(level(succ)) - pos - 1);
+
+            counts.emplace(m, num);
+            return num;
+        };
+
+        return countFrom(n) << position(level(n));
+    }
+
+    ///
+    // Iterate over the numbers (encoded in 'levels')
+    // from the set 'n' in the ascending order.
+    class const_iterator {
+        const BDDManager *manager{nullptr};
+        const std::vector<LevelT> *levels{nullptr};
+        // the node on the path for every level and the chosen bit
+        std::vector<NodeT> path;
+        uint64_t value{0};
+        bool atEnd{true};
+
+        NodeT child(size_t i, bool bit) const {
+            return manager->cofactor(path[i], (*levels)[i], bit);
+        }
+
+        // go down from the level 'i' using the smallest values
+        void descend(size_t i, NodeT n) {
+            for (; i < levels->size(); ++i) {
+                path[i] = n;
+                // a reduced non-zero node always has a path to one
+                bool bit = child(i, false) == ZERO;
+                value = (value & ~bit_mask(i)) | (bit ? bit_mask(i) : 0);
+                n = child(i, bit);
+            }
+            assert(n == ONE);
+        }
+
+        uint64_t bit_mask(size_t i) const {
+            return static_cast<uint64_t>(1) << (levels->size() - 1 - i);
+        }
+
+    public:
+        const_iterator() = default;
+        const_iterator(const BDDManager *m, NodeT n,
+                       const std::vector<LevelT> *lvls)
+        : manager(m), levels(lvls), path(lvls->size()), atEnd(n == ZERO) {
+            if (!atEnd)
+                descend(0, n);
+        }
+
+        const_iterator& operator++() {
+            assert(!atEnd && "Incrementing the end iterator");
+            // find the deepest level where we can take the one branch
+            for (size_t i = levels->size(); i > 0; --i) {
+                if ((value & bit_mask(i - 1)) == 0 &&
+                    child(i - 1, true) != ZERO) {
+                    value |= bit_mask(i - 1);
+                    descend(i, child(i - 1, true));
+                    return *this;
+                }
+            }
+
+            atEnd = true;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        uint64_t operator*() const {
+            assert(!atEnd && "Dereferencing the end iterator");
+            return value;
+        }
+
+        bool operator==(const const_iterator& rhs) const {
+            if (atEnd || rhs.atEnd)
+                return atEnd == rhs.atEnd;
+            return value == rhs.value;
+        }
+
+        bool operator!=(const const_iterator& rhs) const {
+            return !operator==(rhs);
+        }
+    };
+
+    const_iterator begin(NodeT n, const std::vector<LevelT> *levels) const {
+        return const_iterator(this, n, levels);
+    }
+
+    const_iterator end() const { return const_iterator(); }
+};
+
+} // namespace ADT
+} // namespace dg
+
+#endif // _DG_BDD_H_
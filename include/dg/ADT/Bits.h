@@ -27,12 +27,9 @@ public:
     }
 
     size_t size() const {
-        size_t num = 0;
-        for (size_t i = 0; i < bitsNum(); ++i)
-            if (_bits & (static_cast<InnerT>(1) << i))
-                ++num;
-
-        return num;
+        static_assert(sizeof(InnerT) <= sizeof(unsigned long long),
+                      "Unsupported type of bits");
+        return __builtin_popcountll(_bits);
     }
 
     bool empty() const { return _bits == 0; }
@@ -135,12 +132,9 @@ public:
     bool mayContain(size_t i) const { return i < bitsNum(); }
 
     size_t size() const {
-        size_t num = 0;
-        for (size_t i = 0; i < bitsNum(); ++i)
-            if (_bits & (static_cast<InnerT>(1) << i))
-                ++num;
-
-        return num;
+        static_assert(sizeof(InnerT) <= sizeof(unsigned long long),
+                      "Unsupported type of bits");
+        return __builtin_popcountll(_bits);
     }
 
     bool get(size_t i) const {
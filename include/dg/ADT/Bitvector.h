@@ -1,39 +1,84 @@
 #ifndef _DG_SPARSE_BITVECTOR_H_
 #define _DG_SPARSE_BITVECTOR_H_
 
-#include <map>
+#include <vector>
+#include <algorithm>
 #include <cassert>
 
 namespace dg {
 namespace ADT {
 
+///
+// Sparse bitvector. The bits are stored in elements of SCALE words
+// (each word being of type BitsT) that are kept in a vector sorted
+// by the index of their first bit (the shift). Compared to a tree,
+// this layout is cache-friendly and allocates only when the vector
+// needs to grow, not for every new element.
 template <typename BitsT = uint64_t, typename ShiftT = uint64_t, size_t SCALE = 1>
 class SparseBitvectorImpl {
-    // mapping from shift to bits
-    using BitsContainerT = std::map<ShiftT, BitsT>;
+    static_assert(SCALE > 0, "Element must have at least one word");
+
+    struct Element {
+        ShiftT shift;
+        BitsT bits[SCALE];
+
+        Element(ShiftT s) : shift(s), bits{} {}
+
+        bool merge(const Element& rhs) {
+            assert(shift == rhs.shift);
+            bool changed = false;
+            for (size_t w = 0; w < SCALE; ++w) {
+                BitsT newBits = bits[w] | rhs.bits[w];
+                if (newBits != bits[w]) {
+                    bits[w] = newBits;
+                    changed = true;
+                }
+            }
+            return changed;
+        }
+    };
+
+    // sorted sequence of elements
+    using BitsContainerT = std::vector<Element>;
     BitsContainerT _bits{};
 
     static size_t _bitsNum() { return sizeof(BitsT) * 8; }
-    static ShiftT _shift(size_t i) { return i - (i % _bitsNum()); }
+    static size_t _elemBitsNum() { return _bitsNum() * SCALE; }
+    static ShiftT _shift(size_t i) { return i - (i % _elemBitsNum()); }
+    static BitsT _mask(size_t i) {
+        return static_cast<BitsT>(1) << (i % _bitsNum());
+    }
 
     static size_t _countBits(BitsT bits) {
-        size_t num = 0;
-        while (bits) {
-            if (bits & 0x1)
-                ++num;
+        static_assert(sizeof(BitsT) <= sizeof(unsigned long long),
+                      "Unsupported type of bits");
+        return __builtin_popcountll(bits);
+    }
 
-            bits = bits >> 1;
-        }
+    // find the first element whose shift is not less than sft
+    typename BitsContainerT::iterator _lowerBound(ShiftT sft) {
+        // fast path -- the numbers are often inserted in increasing order
+        if (_bits.empty() || _bits.back().shift < sft)
+            return _bits.end();
 
-        return num;
+        return std::lower_bound(_bits.begin(), _bits.end(), sft,
+                                [](const Element& e, ShiftT s) {
+                                    return e.shift < s;
+                                });
     }
 
-    void _addBits(size_t i) {
-        // for now we just push it back,
-        // but we would rather do it somehow
-        // more smartly (probably not using the vector)
-        auto sft = _shift(i);
-        _bits.emplace(sft, (1UL << (i - sft)));
+    typename BitsContainerT::const_iterator _lowerBound(ShiftT sft) const {
+        return const_cast<SparseBitvectorImpl *>(this)->_lowerBound(sft);
+    }
+
+    static BitsT& _word(Element& e, size_t i) {
+        assert(i - e.shift < _elemBitsNum());
+        return e.bits[(i - e.shift) / _bitsNum()];
+    }
+
+    static const BitsT& _word(const Element& e, size_t i) {
+        assert(i - e.shift < _elemBitsNum());
+        return e.bits[(i - e.shift) / _bitsNum()];
     }
 
 public:
@@ -42,6 +87,8 @@ public:
 
     SparseBitvectorImpl(const SparseBitvectorImpl&) = default;
     SparseBitvectorImpl(SparseBitvectorImpl&&) = default;
+    SparseBitvectorImpl& operator=(const SparseBitvectorImpl&) = default;
+    SparseBitvectorImpl& operator=(SparseBitvectorImpl&&) = default;
 
     void reset() { _bits.clear(); }
     bool empty() const { return _bits.empty(); }
@@ -49,70 +96,130 @@ public:
 
     bool get(size_t i) const {
         auto sft = _shift(i);
-        assert(sft % _bitsNum() == 0);
+        assert(sft % _elemBitsNum() == 0);
 
-        auto it = _bits.find(sft);
-        if (it == _bits.end()) {
+        auto it = _lowerBound(sft);
+        if (it == _bits.end() || it->shift != sft) {
             return false;
         }
 
-        return (it->second & (1UL << (i - sft)));
+        return _word(*it, i) & _mask(i);
     }
 
     // returns the previous value of the i-th bit
     bool set(size_t i) {
         auto sft = _shift(i);
-        auto it = _bits.find(sft);
-        if (it == _bits.end()) {
-            _addBits(i);
+        auto it = _lowerBound(sft);
+        if (it == _bits.end() || it->shift != sft) {
+            it = _bits.emplace(it, sft);
+            _word(*it, i) |= _mask(i);
             return false;
         }
 
-        bool prev = (it->second & (1UL << (i - sft)));
-        it->second |= (1UL << (i - sft));
+        BitsT& word = _word(*it, i);
+        bool prev = word & _mask(i);
+        word |= _mask(i);
 
         return prev;
     }
 
-    // this is the union operation
+    // this is the union operation. We walk both (sorted) containers
+    // at once and OR whole words, so the merge is linear
+    // in the number of words of both bitvectors.
     bool merge(const SparseBitvectorImpl& rhs) {
+        if (this == &rhs || rhs._bits.empty())
+            return false;
+
+        if (_bits.empty()) {
+            _bits = rhs._bits;
+            return true;
+        }
+
+        // first merge the elements that we already have
+        // and count the elements that we are missing
         bool changed = false;
-        // FIXME: this is inefficient
-        for (size_t i : rhs) {
-            // if we changed a bit from false to true,
-            // we changed the bitvector
-            changed |= (set(i) == false);
+        size_t missing = 0;
+        auto it = _bits.begin();
+        auto et = _bits.end();
+        for (const Element& re : rhs._bits) {
+            while (it != et && it->shift < re.shift)
+                ++it;
+
+            if (it != et && it->shift == re.shift) {
+                changed |= it->merge(re);
+                ++it;
+            } else {
+                ++missing;
+            }
         }
 
-        return changed;
+        if (missing == 0)
+            return changed;
+
+        // now merge in the missing elements from the back,
+        // so that we move every element at most once
+        size_t i = _bits.size();
+        size_t j = rhs._bits.size();
+        _bits.resize(i + missing, Element(0));
+        size_t k = _bits.size();
+        while (j > 0) {
+            const Element& re = rhs._bits[j - 1];
+            if (i > 0 && _bits[i - 1].shift >= re.shift) {
+                // the elements with the same shift were merged above
+                if (_bits[i - 1].shift == re.shift)
+                    --j;
+                _bits[--k] = _bits[--i];
+            } else {
+                _bits[--k] = re;
+                --j;
+            }
+        }
+        assert(k == i && "Merged wrong number of elements");
+
+        return true;
     }
 
     size_t size() const {
         size_t num = 0;
-        for (auto& it : _bits)
-            num += _countBits(it.second);
+        for (const Element& e : _bits) {
+            for (size_t w = 0; w < SCALE; ++w)
+                num += _countBits(e.bits[w]);
+        }
 
         return num;
     }
 
     class const_iterator {
-        typename BitsContainerT::const_iterator container_it;
-        typename BitsContainerT::const_iterator container_end;
+        typename BitsContainerT::const_iterator container_it{};
+        typename BitsContainerT::const_iterator container_end{};
+        // position of the bit in the current element
         size_t pos{0};
 
         const_iterator(const BitsContainerT& cont, bool end = false)
         :container_it(end ? cont.end() : cont.begin()),
          container_end(cont.end()) {
             // set-up the initial position
-            if (!end && !cont.empty())
+            if (!end)
                 _findClosestBit();
         }
 
+        // move to the closest set bit starting at the current position
+        // (inclusive), possibly moving to next elements
         void _findClosestBit() {
-            assert(pos < (sizeof(BitsT)*8));
-            while (!(container_it->second & (1UL << pos))) {
-                if (++pos == sizeof(BitsT)*8)
-                    return;
+            while (container_it != container_end) {
+                while (pos < _elemBitsNum()) {
+                    size_t w = pos / _bitsNum();
+                    BitsT word = container_it->bits[w] >> (pos % _bitsNum());
+                    if (word) {
+                        pos += __builtin_ctzll(word);
+                        return;
+                    }
+
+                    pos = (w + 1) * _bitsNum();
+                }
+
+                ++container_it;
+                pos = 0;
             }
         }
 
@@ -120,17 +227,10 @@ public:
         const_iterator() = default;
         const_iterator& operator++() {
             // shift to the next bit in the current bits
-            assert(pos < (sizeof(BitsT)*8));
-            if (++pos != 64)
-                _findClosestBit();
-
-            if (pos == 64) {
-                ++container_it;
-                pos = 0;
-                if (container_it != container_end) {
-                    _findClosestBit();
-                }
-            }
+            assert(container_it != container_end);
+            assert(pos < _elemBitsNum());
+            ++pos;
+            _findClosestBit();
             return *this;
         }
 
@@ -141,7 +241,7 @@ public:
         }
 
         size_t operator*() const {
-            return container_it->first + pos;
+            return container_it->shift + pos;
         }
 
         bool operator==(const const_iterator& rhs) const {
@@ -161,7 +261,8 @@ public:
     friend class const_iterator;
 };
 
-using SparseBitvector = SparseBitvectorImpl<uint64_t, uint64_t, 1>;
+// elements of 128 bits -- the numbers we store are usually small and clustered
+using SparseBitvector = SparseBitvectorImpl<uint64_t, uint64_t, 2>;
 
 } // namespace ADT
 } // namespace dg
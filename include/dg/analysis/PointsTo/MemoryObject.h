@@ -6,7 +6,9 @@
 #include <set>
 #include <cassert>
 
+#include "OffsetMap.h"
 #include "PointsToSet.h"
+#include "PSNode.h"
 
 namespace dg {
 namespace analysis {
@@ -14,7 +16,7 @@ namespace pta {
 
 struct MemoryObject
 {
-    using PointsToMapT = std::map<Offset, PointsToSetT>;
+    using PointsToMapT = OffsetMap<PointsToSetT>;
 
     MemoryObject(/*uint64_t s = 0, bool isheap = false, */PSNode *n = nullptr)
         : node(n) /*, is_heap(isheap), size(s)*/ {}
@@ -23,9 +25,40 @@ struct MemoryObject
     PSNode *node;
     // possible pointers stored in this memory object
     PointsToMapT pointsTo;
+    // the state of memory (see PointerAnalysis::memoryStamp)
+    // when this object was changed the last time
+    size_t lastChange{0};
 
     PointsToSetT& getPointsTo(const Offset off) { return pointsTo[off]; }
 
+    // the number of the known offsets that have some pointers
+    size_t getFieldsNum() const {
+        return static_cast<size_t>(pointsTo.knownEnd() - pointsTo.begin());
+    }
+
+    // is the allocation of this memory collapsed into one field?
+    bool isCollapsed() const {
+        PSNodeAlloc *alloc = node ? PSNodeAlloc::get(node) : nullptr;
+        return alloc && alloc->isCollapsed();
+    }
+
+    // move the pointers from all the known offsets to the unknown offset,
+    // return false if there were no pointers on known offsets
+    bool collapse() {
+        if (getFieldsNum() == 0)
+            return false;
+
+        PointsToSetT S;
+        for (const auto& it : pointsTo) {
+            for (const Pointer& ptr : it.second)
+                S.add(ptr);
+        }
+
+        pointsTo.clear();
+        pointsTo[Offset::UNKNOWN] = std::move(S);
+        return true;
+    }
+
     PointsToMapT::iterator find(const Offset off) {
         return pointsTo.find(off);
     }
@@ -49,6 +82,9 @@ struct MemoryObject
         assert(ptr.target != nullptr
                && "Cannot have NULL target, use unknown instead");
 
+        if (isCollapsed())
+            return pointsTo[Offset::UNKNOWN].add(ptr);
+
         return pointsTo[off].add(ptr);
     }
 
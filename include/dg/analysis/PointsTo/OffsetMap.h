@@ -0,0 +1,101 @@
+#ifndef _DG_OFFSET_MAP_H_
+#define _DG_OFFSET_MAP_H_
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "dg/analysis/Offset.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+///
+// A map from offsets to values (the pointers stored in memory objects)
+// kept in a sorted vector. The objects have usually only a few fields
+// and we look them up much more often than we add new ones, so this is
+// faster and smaller than std::map. The value on the unknown offset
+// is always the last element (Offset::UNKNOWN is the greatest offset),
+// so it can be found in constant time. Iterating over the map goes
+// over the known offsets in ascending order and then over the unknown
+// offset, the same as with std::map<Offset, ValueT>.
+//
+// Adding a new offset invalidates the iterators and references
+// to the values.
+template <typename ValueT>
+class OffsetMap
+{
+public:
+    using value_type = std::pair<Offset, ValueT>;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+private:
+    std::vector<value_type> fields;
+
+    bool hasUnknown() const {
+        return !fields.empty() && fields.back().first.isUnknown();
+    }
+
+    static bool lessOffset(const value_type& v, const Offset& off) {
+        return v.first < off;
+    }
+
+    template <typename ItT>
+    static ItT lowerBound(ItT b, ItT e, const Offset& off) {
+        return std::lower_bound(b, e, off, lessOffset);
+    }
+
+public:
+    iterator begin() { return fields.begin(); }
+    iterator end() { return fields.end(); }
+    const_iterator begin() const { return fields.begin(); }
+    const_iterator end() const { return fields.end(); }
+
+    // the end of the known offsets (the unknown offset or end())
+    iterator knownEnd() { return hasUnknown() ? end() - 1 : end(); }
+    const_iterator knownEnd() const { return hasUnknown() ? end() - 1 : end(); }
+
+    size_t size() const { return fields.size(); }
+    bool empty() const { return fields.empty(); }
+    void clear() { fields.clear(); }
+
+    // the first known offset that is not less than 'off'
+    // (to go over a range of offsets up to knownEnd())
+    iterator lower_bound(const Offset& off) {
+        return off.isUnknown() ? knownEnd() : lowerBound(begin(), knownEnd(), off);
+    }
+
+    const_iterator lower_bound(const Offset& off) const {
+        return off.isUnknown() ? knownEnd() : lowerBound(begin(), knownEnd(), off);
+    }
+
+    iterator find(const Offset& off) {
+        auto it = lower_bound(off);
+        return it != end() && it->first == off ? it : end();
+    }
+
+    const_iterator find(const Offset& off) const {
+        auto it = lower_bound(off);
+        return it != end() && it->first == off ? it : end();
+    }
+
+    size_t count(const Offset& off) const { return find(off) != end() ? 1 : 0; }
+
+    ValueT& operator[](const Offset& off) {
+        auto it = lower_bound(off);
+        if (it != end() && it->first == off)
+            return it->second;
+
+        // the offsets are usually added in the ascending order,
+        // so this is mostly an insertion at the end
+        return fields.emplace(it, off, ValueT())->second;
+    }
+};
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif // _DG_OFFSET_MAP_H_
@@ -2,8 +2,10 @@
 #define _DG_PS_NODE_H_
 
 #include <cassert>
-#include <cstdarg>
+#include <initializer_list>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "dg/analysis/PointsTo/Pointer.h"
 #include "dg/analysis/PointsTo/PointsToSet.h"
@@ -28,7 +30,7 @@ enum class PSNodeType {
         // advantage of type checking
         FUNCTION,
         // support for interprocedural analysis,
-        // operands are null terminated. It is a noop,
+        // it has no operands. It is a noop,
         // just for the user's convenience
         CALL,
         // call via function pointer
@@ -127,7 +129,8 @@ protected:
     ///
     // Construct a PSNode
     // \param t     type of the node
-    // Different types take different arguments:
+    // Different types take different arguments
+    // (see PointerSubgraph::create()):
     //
     // ALLOC:        no argument
     // DYN_ALLOC:    no argument
@@ -152,19 +155,14 @@ protected:
     // CONSTANT:     node that keeps constant points-to information
     //               the argument is the pointer it points to
     // PHI:          phi node that gathers pointers from different paths in CFG
-    //               arguments are null-terminated list of the relevant nodes
-    //               from predecessors
-    // CALL:         represents call of subprocedure,
-    //               XXX: get rid of the arguments here?
-    //               arguments are null-terminated list of nodes that can user
-    //               use arbitrarily - they are not used by the analysis itself.
-    //               The arguments can be used e. g. when mapping call arguments
-    //               back to original CFG. Actually, the CALL node is not needed
+    //               arguments are the relevant nodes from predecessors
+    //               (any number of them)
+    // CALL:         represents call of subprocedure, no argument.
+    //               Actually, the CALL node is not needed
     //               in most cases (just 'inline' the subprocedure into the PointerSubgraph
     //               when building it)
     // CALL_FUNCPTR: call via function pointer. The argument is the node that
     //               bears the pointers.
-    //               FIXME: use more nodes (null-terminated list of pointer nodes)
     // CALL_RETURN:  site where given call returns. Bears the pointers
     //               returned from the subprocedure. Works like PHI
     // RETURN:       represents returning value from a subprocedure,
@@ -192,21 +190,13 @@ protected:
         }
     }
 
-    // ctor for memcpy
-    PSNode(unsigned id, PSNodeType t, PSNode *op1, PSNode *op2)
+    // ctor for the nodes whose only arguments are the operands
+    PSNode(unsigned id, PSNodeType t, std::initializer_list<PSNode *> ops)
     : PSNode(id, t)
     {
-        assert(t == PSNodeType::MEMCPY);
-        addOperand(op1);
-        addOperand(op2);
-    }
-
-    // ctor for gep
-    PSNode(unsigned id, PSNodeType t, PSNode *op1)
-    : PSNode(id, t)
-    {
-        assert(t == PSNodeType::GEP);
-        addOperand(op1);
+        operands.reserve(ops.size());
+        for (PSNode *op : ops)
+            addOperand(op);
     }
 
     // ctor of constant
@@ -219,45 +209,6 @@ protected:
         pointsTo.add(Pointer(op, offset));
     }
 
-    PSNode(unsigned id, PSNodeType t, va_list args)
-    : PSNode(id, t) {
-        PSNode *op;
-
-        switch(type) {
-            case PSNodeType::NOOP:
-            case PSNodeType::ENTRY:
-            case PSNodeType::FUNCTION:
-                // no operands (and FUNCTION has been set up
-                // in the super ctor)
-                break;
-            case PSNodeType::CAST:
-            case PSNodeType::LOAD:
-            case PSNodeType::CALL_FUNCPTR:
-            case PSNodeType::INVALIDATE_OBJECT:
-            case PSNodeType::INVALIDATE_LOCALS:
-            case PSNodeType::FREE:
-                addOperand(va_arg(args, PSNode *));
-                break;
-            case PSNodeType::STORE:
-                addOperand(va_arg(args, PSNode *));
-                addOperand(va_arg(args, PSNode *));
-                break;
-            case PSNodeType::CALL_RETURN:
-            case PSNodeType::PHI:
-            case PSNodeType::RETURN:
-            case PSNodeType::CALL:
-                op = va_arg(args, PSNode *);
-                // the operands are null terminated
-                while (op) {
-                    addOperand(op);
-                    op = va_arg(args, PSNode *);
-                }
-                break;
-            default:
-                assert(0 && "Unknown type");
-        }
-    }
-
 public:
 
     PSNode(PSNodeType t)
@@ -299,10 +250,38 @@ public:
     // reason the PointerSubgraph node exists, so don't hide it
     PointsToSetT pointsTo;
 
+    // Bookkeeping for difference propagation in the pointer analysis.
+    // Allocated by the analysis only for the nodes that it tracks.
+    // If an operand of the node is replaced during the analysis,
+    // the bookkeeping of the node must be reset.
+    struct PointsToDiff {
+        // pointers added to 'pointsTo' that were not processed
+        // by all users of this node yet
+        std::vector<Pointer> added;
+        // how many pointers were dropped from the front of 'added'
+        size_t base{0};
+        // try to drop the processed pointers when 'added'
+        // reaches this size (so that we do not check
+        // the users of the node every time)
+        size_t pruneAt{0};
+        // for every operand, the number of pointers added
+        // to the operand that this node has already processed
+        std::vector<size_t> processed;
+        // the state of memory when this node was processed the last time
+        size_t memoryStamp{0};
+    };
+
+    std::unique_ptr<PointsToDiff> diff;
+
     // convenient helper
     bool addPointsTo(PSNode *n, Offset o)
     {
-        return pointsTo.add(Pointer(n, o));
+        if (!pointsTo.add(Pointer(n, o)))
+            return false;
+
+        if (diff)
+            diff->added.emplace_back(n, o);
+        return true;
     }
 
     bool addPointsTo(const Pointer& ptr)
@@ -312,7 +291,20 @@ public:
 
     bool addPointsTo(const PointsToSetT& ptrs)
     {
-        return pointsTo.merge(ptrs);
+        if (!diff)
+            return pointsTo.merge(ptrs);
+
+        size_t num = diff->added.size();
+        for (const Pointer& ptr : ptrs) {
+            if (!pointsTo.count(ptr))
+                diff->added.push_back(ptr);
+        }
+
+        if (num == diff->added.size())
+            return false;
+
+        pointsTo.merge(ptrs);
+        return true;
     }
 
     bool doesPointsTo(const Pointer& p)
@@ -356,6 +348,9 @@ class PSNodeAlloc : public PSNode {
     bool is_heap = false;
     // is it a global value?
     bool is_global = false;
+    // does the analysis keep all pointers stored in this memory
+    // on the unknown offset? (see PointerAnalysisOptions::objectFieldsBudget)
+    bool is_collapsed = false;
 
 public:
     PSNodeAlloc(unsigned id, PSNodeType t)
@@ -369,7 +364,7 @@ public:
             static_cast<PSNodeAlloc *>(n) : nullptr;
     }
 
-    void setZeroInitialized() { zeroInitialized = true; }
+    void setZeroInitialized(bool b = true) { zeroInitialized = b; }
     bool isZeroInitialized() const { return zeroInitialized; }
 
     void setIsHeap() { is_heap = true; }
@@ -377,6 +372,9 @@ public:
 
     void setIsGlobal() { is_global = true; }
     bool isGlobal() { return is_global; }
+
+    void setIsCollapsed(bool b = true) { is_collapsed = b; }
+    bool isCollapsed() const { return is_collapsed; }
 };
 
 class PSNodeMemcpy : public PSNode {
@@ -384,7 +382,7 @@ class PSNodeMemcpy : public PSNode {
 
 public:
     PSNodeMemcpy(unsigned id, PSNode *src, PSNode *dest, Offset len)
-    :PSNode(id, PSNodeType::MEMCPY, src, dest), len(len) {}
+    :PSNode(id, PSNodeType::MEMCPY, {src, dest}), len(len) {}
 
     static PSNodeMemcpy *get(PSNode *n) {
         return isa<PSNodeType::MEMCPY>(n) ? static_cast<PSNodeMemcpy *>(n) : nullptr;
@@ -400,7 +398,7 @@ class PSNodeGep : public PSNode {
 
 public:
     PSNodeGep(unsigned id, PSNode *src, Offset o)
-    :PSNode(id, PSNodeType::GEP, src), offset(o) {}
+    :PSNode(id, PSNodeType::GEP, {src}), offset(o) {}
 
     static PSNodeGep *get(PSNode *n) {
         return isa<PSNodeType::GEP>(n) ? static_cast<PSNodeGep *>(n) : nullptr;
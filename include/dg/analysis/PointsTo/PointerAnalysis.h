@@ -2,8 +2,13 @@
 #define _DG_POINTER_ANALYSIS_H_
 
 #include <cassert>
+#include <cstdint>
+#include <queue>
+#include <set>
+#include <unordered_map>
 #include <vector>
 
+#include "dg/analysis/Analysis.h"
 #include "dg/analysis/PointsTo/Pointer.h"
 #include "dg/analysis/PointsTo/MemoryObject.h"
 #include "dg/analysis/PointsTo/PointerSubgraph.h"
@@ -19,24 +24,107 @@ namespace pta {
 extern PSNode *NULLPTR;
 extern PSNode *UNKNOWN_MEMORY;
 
+struct PointerAnalysisStatistics : public AnalysisStatistics {
+    PointerAnalysisStatistics()
+        : AnalysisStatistics(), changedNodes(0), iterationsNum(0),
+          collapsedObjects(0) {}
+
+    // how many times processing a node changed something
+    uint64_t changedNodes;
+    // the number of batches of the batch solver
+    uint64_t iterationsNum;
+    // the number of allocations collapsed into one field
+    // (see PointerAnalysisOptions::objectFieldsBudget)
+    uint64_t collapsedObjects;
+
+    uint64_t getChangedNodes() const { return changedNodes; }
+    uint64_t getIterationsNum() const { return iterationsNum; }
+    uint64_t getCollapsedObjects() const { return collapsedObjects; }
+};
+
 class PointerAnalysis
 {
     // the pointer state subgraph
     PointerSubgraph *PS{nullptr};
     const PointerAnalysisOptions options{};
 
+    PointerAnalysisStatistics statistics;
+
     // strongly connected components of the PointerSubgraph
-    std::vector<std::vector<PSNode *> > SCCs;
+    // (updated when the graph changes during the analysis)
+    IncrementalSCC<PSNode> SCCs;
 
+    // the state of memory -- increased every time some memory
+    // object changes (used with difference propagation)
+    size_t memoryStamp{0};
+
+protected:
+    // (re-)compute the strongly connected components of the graph
+    // (the analysis must call it when it changes the graph
+    // before the fixpoint computation starts)
     void initPointerAnalysis() {
         assert(PS && "Need PointerSubgraph object");
 
         // compute the strongly connected components
-        SCC<PSNode> scc_comp;
-        SCCs = std::move(scc_comp.compute(PS->getRoot()));
+        SCCs.compute(PS->getRoot());
+    }
+
+    // Incremental solving (used by the demand-driven analysis): the worklist
+    // solver processes only the nodes that were activated and propagates
+    // the changes only among them. Flow-insensitive analysis only.
+    void startIncremental();
+    // let the solver process the node (and queue it)
+    void activate(PSNode *n);
+    bool isActive(const PSNode *n) const {
+        return n->getID() < priority.size() &&
+               priority[n->getID()] != NO_PRIORITY;
+    }
+    // process the queued active nodes until the fixpoint is reached
+    void solveIncremental();
+    // has some processed node read the memory object?
+    bool isRead(const MemoryObject *o) const { return readers.count(o) > 0; }
+
+    // mark the allocation as collapsed, the pointers
+    // into it get the unknown offset from now on
+    void collapseTarget(PSNode *target) {
+        PSNodeAlloc *alloc = PSNodeAlloc::get(target);
+        if (alloc && !alloc->isCollapsed()) {
+            alloc->setIsCollapsed();
+            ++statistics.collapsedObjects;
+        }
+    }
+
+    // Should the memory object be collapsed? It should if its allocation
+    // is collapsed or if it has got too many fields (see objectFieldsBudget)
+    bool needsCollapse(const MemoryObject *o) const {
+        size_t fields = o->getFieldsNum();
+        if (o->isCollapsed())
+            return fields > 0;
+
+        return options.objectFieldsBudget > 0 &&
+               fields > options.objectFieldsBudget;
+    }
+
+    // collapse the changed memory object if needed,
+    // return true if the object changed
+    bool collapseIfNeeded(MemoryObject *o) {
+        if (!needsCollapse(o))
+            return false;
+
+        collapseTarget(o->node);
+        return o->collapse();
+    }
+
+    // the pointer that the GEP with the given offset makes from 'ptr'
+    static Pointer gepPointer(const Pointer& ptr, Offset gepOffset,
+                              Offset fieldSensitivity);
+
+    // the memory objects read by the processed nodes
+    // (in the order in which they were read for the first time)
+    const std::vector<const MemoryObject *>& getReadObjects() const {
+        return readObjects;
     }
 
-protected:
     // a set of changed nodes that are going to be
     // processed by the analysis
     std::vector<PSNode *> to_process;
@@ -81,16 +169,48 @@ public:
         return false;
     }
 
+    // Does the node only see the memory state of its (single) predecessor?
+    // Then the node must pass a change of that state to its successors
+    // even if processing the node did not change anything.
+    virtual bool sharesMemoryState(PSNode *) const {
+        return false;
+    }
+
+    // Does the analysis keep only one memory state for the whole program?
+    // Then the memory objects only grow and the nodes working with memory
+    // (load, store, memcpy) may skip the objects that have not changed
+    // since the node was processed the last time.
+    virtual bool isFlowInsensitive() const {
+        return false;
+    }
+
+    // Does the analysis propagate the memory state along the def-use chains
+    // of memory instead of the control flow? Then the solver does not queue
+    // the successors of the nodes and the analysis must queue the nodes
+    // that read the changed memory itself.
+    virtual bool isSparse() const {
+        return false;
+    }
+
     PointerSubgraph *getPS() const { return PS; }
 
-    const std::vector<std::vector<PSNode *> > &getSCCs() const { return SCCs; }
+    const std::vector<std::vector<PSNode *> > &getSCCs() const { return SCCs.getSCCs(); }
+
+    // statistics of the last run
+    const PointerAnalysisStatistics& getStatistics() const { return statistics; }
+
+    const PointerAnalysisOptions& getOptions() const { return options; }
 
+    // queue the node to be processed again
     virtual void enqueue(PSNode *n)
     {
-        changed.push_back(n);
+        if (options.solver == PointerAnalysisOptions::Solver::worklist)
+            pushToWorklist(n);
+        else
+            changed.push_back(n);
     }
 
-    void preprocess() {
+    virtual void preprocess() {
         // do some optimizations
         if (options.preprocessGeps)
             preprocessGEPs();
@@ -109,14 +229,23 @@ public:
     bool iteration() {
         assert(changed.empty());
 
+        ++statistics.iterationsNum;
         for (PSNode *cur : to_process) {
             bool enq = false;
             enq |= beforeProcessed(cur);
             enq |= processNode(cur);
             enq |= afterProcessed(cur);
 
-            if (enq)
+            ++statistics.processedNodes;
+            if (enq) {
+                ++statistics.changedNodes;
                 enqueue(cur);
+            }
+
+            // the nodes affected by a change of the graph
+            // (a call via a function pointer, see graphChanged())
+            changed.insert(changed.end(), spliced.begin(), spliced.end());
+            spliced.clear();
         }
 
         return !changed.empty();
@@ -142,18 +271,32 @@ public:
 
     void run()
     {
+        statistics = PointerAnalysisStatistics();
+        spliced.clear();
+        PS->takeChangedNodes();
+
         // do preprocessing and queue the nodes
         preprocess();
-        initialize_queue();
-
-        // check that the current state of pointer analysis makes sense
-        sanityCheck();
-
-        // do fixpoint
-        do {
-            iteration();
-            queue_changed();
-        } while (!to_process.empty());
+        resetDiffs();
+
+        if (useParallelSolver()) {
+            sanityCheck();
+            solveParallel();
+        } else if (options.solver == PointerAnalysisOptions::Solver::worklist) {
+            sanityCheck();
+            solveWorklist();
+        } else {
+            initialize_queue();
+
+            // check that the current state of pointer analysis makes sense
+            sanityCheck();
+
+            // do fixpoint
+            do {
+                iteration();
+                queue_changed();
+            } while (!to_process.empty());
+        }
 
         assert(to_process.empty());
         assert(changed.empty());
@@ -168,9 +311,19 @@ public:
         // unreachable from the point where the information is
         // generated, so this is OK.
 
+        // the bookkeeping of difference propagation is not needed anymore
+        resetDiffs();
+
         sanityCheck();
     }
 
+    // forget which pointers of its operands the node has already processed
+    // (must be called when the operands of the node are changed)
+    void resetDiff(PSNode *n) {
+        if (n->diff)
+            n->diff->processed.clear();
+    }
+
     // generic error
     // @msg - message for the user
     // XXX: maybe create some enum that will represent the error
@@ -211,7 +364,7 @@ private:
         // in the loop will end up with Offset::UNKNOWN after some
         // number of iterations, so we can do that right now
         // and save iterations
-        for (const auto& scc : SCCs) {
+        for (const auto& scc : SCCs.getSCCs()) {
             if (scc.size() > 1) {
                 for (PSNode *n : scc) {
                     if (PSNodeGep *gep = PSNodeGep::get(n))
@@ -221,10 +374,171 @@ private:
         }
     }
 
+    // difference propagation
+    static const size_t NOT_PROCESSED = ~static_cast<size_t>(0);
+
+    void resetDiffs() {
+        for (const auto& nd : PS->getNodes()) {
+            if (nd)
+                nd->diff.reset();
+        }
+    }
+
+    // mark the pointers of the idx-th operand of the node as processed
+    // and return how many of them were processed before
+    // (or NOT_PROCESSED if the node has never processed the operand)
+    size_t consumePointers(PSNode *node, unsigned idx);
+    // drop the pointers that were processed by all users of the node
+    void pruneProcessedPointers(PSNode *node);
+
+    // Call 'f' on every pointer of the idx-th operand of the node that
+    // the node has not processed yet. Return true if that were all
+    // the pointers of the operand (the node sees the operand for the first
+    // time or the difference propagation is turned off).
+    template <typename F>
+    bool forEachNewPointer(PSNode *node, unsigned idx, F f) {
+        PSNode *op = node->getOperand(idx);
+        size_t from = NOT_PROCESSED;
+        if (options.diffPropagation)
+            from = consumePointers(node, idx);
+
+        if (from == NOT_PROCESSED) {
+            for (const Pointer& ptr : op->pointsTo)
+                f(ptr);
+            return true;
+        }
+
+        // 'f' may add pointers to the operand, so use indices
+        const PSNode::PointsToDiff *diff = op->diff.get();
+        size_t end = node->diff->processed[idx];
+        for (size_t i = from; i < end; ++i)
+            f(diff->added[i - diff->base]);
+
+        return false;
+    }
+
+    // is the node on a loop (a scc that has more than one node)?
+    bool isInLoop(const PSNode *n) const {
+        return SCCs.hasComponent(n) &&
+               SCCs.getSCCs()[n->getSCCId()].size() > 1;
+    }
+
+    void touch(MemoryObject *o) {
+        collapseIfNeeded(o);
+        o->lastChange = ++memoryStamp;
+        if (trackReaders)
+            touched.push_back(o);
+    }
+
+    // worklist solver
+    static const size_t NO_PRIORITY = ~static_cast<size_t>(0);
+
+    struct WorklistEntry {
+        size_t priority;
+        int64_t order;
+        PSNode *node;
+
+        // std::priority_queue returns the greatest element and we want
+        // the one with the lowest priority (and then order)
+        bool operator<(const WorklistEntry& oth) const {
+            return priority > oth.priority ||
+                   (priority == oth.priority && order > oth.order);
+        }
+    };
+
+    std::priority_queue<WorklistEntry> worklist;
+    // the priority of nodes (the topological order of their SCC)
+    std::vector<size_t> priority;
+    // is the node in the worklist?
+    std::vector<bool> queued;
+    // may the memory state seen by the node have changed?
+    std::vector<bool> memoryDirty;
+    int64_t worklistOrder{0};
+
+    // With flow-insensitive memory, a change of a memory object
+    // affects only the nodes that read the object.
+    bool trackReaders{false};
+    std::unordered_map<const MemoryObject *, std::set<unsigned>> readers;
+    std::vector<const MemoryObject *> readObjects;
+    std::vector<MemoryObject *> touched;
+
+    void addReader(PSNode *node, const std::vector<MemoryObject *>& objects) {
+        if (!trackReaders)
+            return;
+        for (const MemoryObject *o : objects) {
+            auto& r = readers[o];
+            if (r.empty())
+                readObjects.push_back(o);
+            r.insert(node->getID());
+        }
+    }
+
+    void solveWorklist();
+    void runWorklist();
+    void resizeWorklist();
+    // the topological order of the SCCs of the nodes
+    std::vector<size_t> getSCCsOrder() const;
+    bool incremental{false};
+
+    // The graph was changed by functionPointerCall(): update the SCCs
+    // and remember what must be processed because of the change
+    // (the nodes with the ID 'firstNew' and higher are new)
+    void graphChanged(size_t firstNew);
+    // the nodes that must be processed because of the changes of the graph
+    std::vector<PSNode *> spliced;
+    void pushSpliced();
+    int64_t reserveWorklistOrder(size_t num);
+    void pushToWorklist(PSNode *node, int64_t order, bool memoryChanged);
+    void pushToWorklist(PSNode *node, bool memoryChanged = false) {
+        pushToWorklist(node, reserveWorklistOrder(1), memoryChanged);
+    }
+    void pushUsers(PSNode *node);
+
+    // parallel solver (only for the flow-insensitive analysis,
+    // the lazy cycle detection changes the graph during processing
+    // of the nodes, so it works only with the sequential solvers)
+    bool useParallelSolver() const {
+        return options.threads > 1 && isFlowInsensitive() &&
+               !options.collapseCycles;
+    }
+
+    struct ParallelResult;
+    // the memory objects of the targets of pointers (indexed by the ID
+    // of the target), so that the threads can find them without
+    // modifying anything
+    std::vector<MemoryObject *> targetObjects;
+    void addTargetObject(const Pointer& ptr);
+    MemoryObject *getTargetObject(const Pointer& ptr) const {
+        unsigned id = ptr.target->getID();
+        return id < targetObjects.size() ? targetObjects[id] : nullptr;
+    }
+    bool isReader(const PSNode *node, const MemoryObject *o) const {
+        auto it = readers.find(o);
+        return it != readers.end() && it->second.count(node->getID()) > 0;
+    }
+
+    void solveParallel();
+    void computeParallel(PSNode *node, ParallelResult& res) const;
+    void computeLoad(PSNode *node, ParallelResult& res) const;
+    void computeStore(PSNode *node, ParallelResult& res) const;
+    bool applyParallel(PSNode *node, ParallelResult& res);
+
     bool processNode(PSNode *);
     bool processLoad(PSNode *node);
+    bool processLoad(PSNode *node, const Pointer& ptr);
+    bool loadFromObjects(PSNode *node, const Pointer& ptr,
+                         const std::vector<MemoryObject *>& objects);
+    bool processStore(PSNode *node);
+    template <typename ContT>
+    bool storeTo(PSNode *node, const Pointer& ptr, const ContT& values);
     bool processGep(PSNode *node);
+    bool processPhi(PSNode *node);
+    bool processFuncptrCall(PSNode *node);
     bool processMemcpy(PSNode *node);
+    template <typename ContT>
+    bool memcpyTo(PSNode *node, const Pointer& sptr,
+                  std::vector<MemoryObject *>& srcObjects,
+                  const ContT& dests);
     bool processMemcpy(std::vector<MemoryObject *>& srcObjects,
                        std::vector<MemoryObject *>& destObjects,
                        const Pointer& sptr, const Pointer& dptr,
@@ -0,0 +1,405 @@
+#ifndef _DG_ANALYSIS_POINTS_TO_DEMAND_H_
+#define _DG_ANALYSIS_POINTS_TO_DEMAND_H_
+
+#include <cassert>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "MemoryObject.h"
+#include "PointerSubgraph.h"
+#include "PointerAnalysisFI.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+///
+// Demand-driven flow-insensitive pointer analysis.
+//
+// The analysis computes the points-to sets only for the queried nodes
+// and for the nodes that they depend on: their operands, the stores
+// and memcpys that may write to the memory that they read,
+// and (transitively) the nodes that these depend on. The stores
+// whose target can be found syntactically (a store to a variable)
+// are added only when the variable is read, for the others we must
+// compute where their address points to first (only if some of the read
+// variables has its address taken, i.e. it may be written through
+// a pointer). Every query may add at most 'queryBudget' nodes
+// to the computation. If it needs more, the query fails and the caller
+// should assume that the pointer may point anywhere. The calls via
+// pointers are resolved for all the queries (they may give new
+// operands to any node), so they do not count against the budget.
+// The computed points-to sets are kept, so the next queries reuse them.
+// The points-to sets of the successfully queried nodes are the same
+// as the results of PointerAnalysisFI.
+//
+class PointerAnalysisDemand : public PointerAnalysisFI
+{
+    // the stores (and memcpys) to variables that have not been read yet
+    std::unordered_map<const MemoryObject *, std::vector<PSNode *>> storesTo;
+    // the stores through pointers that do not write to memory
+    // read by the active nodes (as far as we know now)
+    std::vector<PSNode *> pending;
+    // the number of changes of points-to sets when we checked
+    // the pending stores the last time
+    uint64_t pendingChecked{~static_cast<uint64_t>(0)};
+    // the calls via pointers (they are always active)
+    std::vector<PSNode *> funcptrCalls;
+    // the calls via pointers that we have not resolved yet
+    std::vector<PSNode *> newFuncptrCalls;
+    size_t funcptrTargets{0};
+    // the number of the read objects that we have checked for stores
+    size_t readChecked{0};
+    // the constants that point to the allocations
+    std::unordered_map<const PSNode *, std::vector<PSNode *>> constantsOf;
+    // may some of the read objects be written through a pointer?
+    bool readAddressTaken{false};
+    // the number of the read objects that we have checked
+    // for their address being taken
+    size_t takenChecked{0};
+
+    // the nodes that are processed by the solver
+    std::vector<PSNode *> active;
+    // the nodes that were going to be activated
+    // when the budget of a query ran out
+    std::vector<PSNode *> unfinished;
+    // the nodes whose points-to set is final
+    std::vector<bool> complete;
+    // the number of the active nodes that are marked as complete
+    size_t completeNum{0};
+    // the number of nodes of the graph that we searched
+    // for stores, memcpys and calls via pointers
+    size_t scanned{0};
+    bool started{false};
+
+    // the number of nodes activated by the current query
+    size_t activatedNum{0};
+    // the budget of the current query (0 is unlimited)
+    size_t budget{0};
+    bool resolvingCalls{false};
+
+    static bool canBeDereferenced(const Pointer& ptr) {
+        return ptr.isValid() && !ptr.isInvalidated() &&
+               ptr.target->getType() != PSNodeType::FUNCTION;
+    }
+
+    bool isInGraph(const PSNode *n) const {
+        const auto& nodes = getPS()->getNodes();
+        return n->getID() < nodes.size() && nodes[n->getID()].get() == n;
+    }
+
+    bool isComplete(const PSNode *n) const {
+        return n->getID() < complete.size() && complete[n->getID()];
+    }
+
+    // activate the nodes and everything that they depend on,
+    // return false if the budget of the query ran out
+    bool activateAll(std::vector<PSNode *>&& stack) {
+        while (!stack.empty()) {
+            PSNode *cur = stack.back();
+            // the special nodes (null, unknown memory) are not in the graph
+            if (isActive(cur) || !isInGraph(cur)) {
+                stack.pop_back();
+                continue;
+            }
+
+            if (budget > 0 && activatedNum >= budget) {
+                unfinished.insert(unfinished.end(), stack.begin(), stack.end());
+                return false;
+            }
+
+            stack.pop_back();
+            ++activatedNum;
+            activate(cur);
+            active.push_back(cur);
+            for (PSNode *op : cur->getOperands())
+                stack.push_back(op);
+        }
+
+        return true;
+    }
+
+    bool activateAll(PSNode *n) {
+        return activateAll(std::vector<PSNode *>{n});
+    }
+
+    // the memory object that the pointer in the node 'n' points to
+    // if we can find it without the analysis (nullptr otherwise)
+    MemoryObject *getBaseObject(PSNode *n) {
+        while (n->getType() == PSNodeType::CAST ||
+               n->getType() == PSNodeType::GEP)
+            n = n->getOperand(0);
+
+        Pointer ptr(n, 0);
+        if (n->getType() == PSNodeType::CONSTANT)
+            ptr = *n->pointsTo.begin();
+        else if (n->getType() != PSNodeType::ALLOC &&
+                 n->getType() != PSNodeType::DYN_ALLOC)
+            return nullptr;
+
+        if (!canBeDereferenced(ptr))
+            return nullptr;
+
+        std::vector<MemoryObject *> objects;
+        getMemoryObjects(n, ptr, objects);
+        return objects.size() == 1 ? objects[0] : nullptr;
+    }
+
+    // may the object be written through a pointer (is its address
+    // used otherwise than as the address of loads and stores)?
+    bool isAddressTaken(const MemoryObject *o) const {
+        PSNode *alloc = o->node;
+        if (!alloc || !isInGraph(alloc))
+            return true;
+
+        std::vector<PSNode *> addresses{alloc};
+        auto it = constantsOf.find(alloc);
+        if (it != constantsOf.end())
+            addresses.insert(addresses.end(),
+                             it->second.begin(), it->second.end());
+
+        while (!addresses.empty()) {
+            PSNode *addr = addresses.back();
+            addresses.pop_back();
+            for (PSNode *user : addr->getUsers()) {
+                switch (user->getType()) {
+                    case PSNodeType::LOAD:
+                    case PSNodeType::MEMCPY:
+                        break;
+                    case PSNodeType::STORE:
+                        // storing the address itself
+                        if (user->getOperand(0) == addr)
+                            return true;
+                        break;
+                    case PSNodeType::CAST:
+                    case PSNodeType::GEP:
+                        addresses.push_back(user);
+                        break;
+                    default:
+                        return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    // find the stores, memcpys and calls via pointers
+    // among the nodes that we have not seen yet
+    void scanNewNodes() {
+        const auto& nodes = getPS()->getNodes();
+        // the new nodes may take the address of the read objects
+        if (scanned < nodes.size() && !readAddressTaken)
+            takenChecked = 0;
+
+        for (; scanned < nodes.size(); ++scanned) {
+            PSNode *n = nodes[scanned].get();
+            if (!n)
+                continue;
+
+            switch (n->getType()) {
+                case PSNodeType::STORE:
+                case PSNodeType::MEMCPY:
+                    // the address of the store is the second operand,
+                    // the destination of memcpy too
+                    if (MemoryObject *o = getBaseObject(n->getOperand(1)))
+                        storesTo[o].push_back(n);
+                    else
+                        pending.push_back(n);
+                    break;
+                case PSNodeType::CALL_FUNCPTR:
+                    // the called functions may get new arguments,
+                    // so we must resolve all the calls via pointers
+                    funcptrCalls.push_back(n);
+                    newFuncptrCalls.push_back(n);
+                    break;
+                case PSNodeType::CONSTANT:
+                    constantsOf[(*n->pointsTo.begin()).target].push_back(n);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    // may the active nodes read the memory written by the store?
+    bool isRelevant(PSNode *store) {
+        std::vector<MemoryObject *> objects;
+        for (const Pointer& ptr : store->getOperand(1)->pointsTo) {
+            if (!canBeDereferenced(ptr))
+                continue;
+
+            objects.clear();
+            getMemoryObjects(store, ptr, objects);
+            for (const MemoryObject *o : objects) {
+                if (isRead(o))
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Resolve the calls via pointers that we have not seen yet and
+    // everything that they depend on. This is shared by all the queries,
+    // so it does not count against the budget of the current query.
+    void resolveFuncptrCalls() {
+        size_t queryBudget = budget;
+        size_t queryActivated = activatedNum;
+        budget = 0;
+        resolvingCalls = true;
+
+        scanNewNodes();
+        while (!newFuncptrCalls.empty()) {
+            std::vector<PSNode *> calls;
+            calls.swap(newFuncptrCalls);
+            bool ok = activateAll(std::move(calls));
+            do {
+                solveIncremental();
+            } while (expand(ok));
+        }
+
+        resolvingCalls = false;
+        budget = queryBudget;
+        activatedNum = queryActivated;
+    }
+
+    // activate what the active nodes newly depend on, return false
+    // if nothing changed ('ok' is set to false if the budget ran out)
+    bool expand(bool& ok) {
+        bool changed = false;
+
+        scanNewNodes();
+        // (when resolving the calls, the caller takes care of the new ones)
+        if (!resolvingCalls && !newFuncptrCalls.empty()) {
+            resolveFuncptrCalls();
+            changed = true;
+        }
+
+        if (!unfinished.empty()) {
+            std::vector<PSNode *> nodes;
+            nodes.swap(unfinished);
+            ok &= activateAll(std::move(nodes));
+            changed = true;
+        }
+
+        // resolving a call via a pointer may give new operands
+        // to the nodes of the called function and to the return node
+        size_t targets = 0;
+        for (PSNode *call : funcptrCalls)
+            targets += call->pointsTo.size();
+        if (ok && targets != funcptrTargets) {
+            funcptrTargets = targets;
+            std::vector<PSNode *> nodes;
+            for (PSNode *a : active) {
+                for (PSNode *op : a->getOperands()) {
+                    if (!isActive(op))
+                        nodes.push_back(op);
+                }
+            }
+
+            if (!nodes.empty()) {
+                ok &= activateAll(std::move(nodes));
+                changed = true;
+            }
+        }
+
+        // the stores to the variables that are read now
+        const auto& read = getReadObjects();
+        bool newReads = readChecked < read.size();
+        while (ok && readChecked < read.size()) {
+            auto it = storesTo.find(read[readChecked]);
+            if (it != storesTo.end()) {
+                ok &= activateAll(std::move(it->second));
+                storesTo.erase(it);
+                changed = true;
+            }
+            ++readChecked;
+        }
+
+        // the stores through pointers, we must know where they write
+        // (if something that may be written through a pointer is read)
+        bool wasTaken = readAddressTaken;
+        for (; !readAddressTaken && takenChecked < read.size(); ++takenChecked)
+            readAddressTaken = isAddressTaken(read[takenChecked]);
+
+        uint64_t changes = getStatistics().getChangedNodes();
+        bool recheck = newReads || changes != pendingChecked ||
+                       readAddressTaken != wasTaken;
+        for (size_t i = 0; ok && readAddressTaken && i < pending.size();) {
+            PSNode *st = pending[i];
+            PSNode *address = st->getOperand(1);
+            if (!isActive(address)) {
+                ok &= activateAll(address);
+                changed = true;
+            } else if (recheck && isRelevant(st)) {
+                ok &= activateAll(st);
+                changed = true;
+                pending[i] = pending.back();
+                pending.pop_back();
+                continue;
+            }
+
+            ++i;
+        }
+
+        if (ok)
+            pendingChecked = changes;
+
+        return changed;
+    }
+
+public:
+    PointerAnalysisDemand(PointerSubgraph *ps,
+                          const PointerAnalysisOptions& opts)
+    : PointerAnalysisFI(ps, opts) {}
+
+    // default options
+    PointerAnalysisDemand(PointerSubgraph *ps)
+    : PointerAnalysisDemand(ps, {}) {}
+
+    // Compute the points-to set of the node. Return false if the query
+    // ran out of its budget, the points-to set of the node
+    // may not be complete then.
+    bool query(PSNode *n) {
+        if (!started) {
+            startIncremental();
+            started = true;
+        }
+
+        if (isComplete(n))
+            return true;
+
+        resolveFuncptrCalls();
+
+        activatedNum = 0;
+        budget = getOptions().queryBudget;
+        bool ok = activateAll(n);
+        while (ok) {
+            solveIncremental();
+            if (!expand(ok))
+                break;
+        }
+
+        if (!ok) {
+            // process what we have, the next query continues from here
+            solveIncremental();
+            return false;
+        }
+
+        // everything that the active nodes depend on is active,
+        // so their points-to sets are final
+        complete.resize(getPS()->size(), false);
+        for (; completeNum < active.size(); ++completeNum)
+            complete[active[completeNum]->getID()] = true;
+
+        return true;
+    }
+};
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif // _DG_ANALYSIS_POINTS_TO_DEMAND_H_
@@ -4,8 +4,12 @@
 #include <cassert>
 #include <vector>
 #include <memory>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "PointerAnalysis.h"
+#include "PointsToMapping.h"
 
 namespace dg {
 namespace analysis {
@@ -18,15 +22,223 @@ class PointerAnalysisFI : public PointerAnalysis
 {
     std::vector<std::unique_ptr<MemoryObject>> memory_objects;
 
+    // Lazy cycle detection (Hardekopf and Lin): if the both ends
+    // of a copy edge have the same points-to set, the edge is likely
+    // to lie on a cycle, so we look for cycles from there.
+    // Every edge is checked only once.
+    std::set<std::pair<unsigned, unsigned>> checked_edges;
+    // the nodes on collapsed cycles -> their representative
+    PointsToMapping<PSNode *> collapsed;
+
+    static bool isCopyNode(PSNode *n) {
+        return n->getType() == PSNodeType::PHI
+                || n->getType() == PSNodeType::CAST;
+    }
+
+    static bool samePointsTo(const PSNode *a, const PSNode *b) {
+        if (a->pointsTo.size() != b->pointsTo.size())
+            return false;
+
+        for (const Pointer& ptr : a->pointsTo) {
+            if (!b->pointsTo.count(ptr))
+                return false;
+        }
+
+        return true;
+    }
+
+    // find the cycles of copy nodes (edges go from operands to users)
+    // that are reachable from 'start' (Tarjan's algorithm)
+    std::vector<std::vector<PSNode *>> findCycles(PSNode *start) {
+        struct Frame {
+            PSNode *node;
+            size_t nextUser;
+        };
+
+        // dfs index and lowpoint
+        std::unordered_map<PSNode *, std::pair<unsigned, unsigned>> num;
+        std::vector<PSNode *> stack;
+        std::unordered_set<PSNode *> on_stack;
+        std::vector<Frame> dfs;
+        std::vector<std::vector<PSNode *>> cycles;
+        unsigned index = 0;
+
+        auto visit = [&](PSNode *n) {
+            num[n] = {index, index};
+            ++index;
+            stack.push_back(n);
+            on_stack.insert(n);
+            dfs.push_back({n, 0});
+        };
+
+        visit(start);
+        while (!dfs.empty()) {
+            PSNode *cur = dfs.back().node;
+            const auto& users = cur->getUsers();
+            if (dfs.back().nextUser < users.size()) {
+                PSNode *user = users[dfs.back().nextUser++];
+                if (!isCopyNode(user))
+                    continue;
+
+                auto it = num.find(user);
+                if (it == num.end())
+                    visit(user);
+                else if (on_stack.count(user))
+                    num[cur].second = std::min(num[cur].second,
+                                               it->second.first);
+                continue;
+            }
+
+            dfs.pop_back();
+            if (!dfs.empty()) {
+                auto& parent = num[dfs.back().node];
+                parent.second = std::min(parent.second, num[cur].second);
+            }
+
+            if (num[cur].first != num[cur].second)
+                continue;
+
+            std::vector<PSNode *> component;
+            PSNode *n;
+            do {
+                n = stack.back();
+                stack.pop_back();
+                on_stack.erase(n);
+                component.push_back(n);
+            } while (n != cur);
+
+            if (component.size() > 1)
+                cycles.push_back(std::move(component));
+        }
+
+        return cycles;
+    }
+
+    // Merge the nodes on the cycle into one representative.
+    // The other nodes stay in the graph (the builder of the graph
+    // may have references to them) and just copy the pointers
+    // from the representative.
+    bool collapse(const std::vector<PSNode *>& cycle) {
+        // the representative must be able to have several operands
+        PSNode *rep = nullptr;
+        for (PSNode *n : cycle) {
+            if (n->getType() == PSNodeType::PHI) {
+                rep = n;
+                break;
+            }
+        }
+
+        if (!rep)
+            return false;
+
+        std::set<PSNode *> members(cycle.begin(), cycle.end());
+        std::vector<PSNode *> inputs;
+        for (PSNode *n : cycle) {
+            for (PSNode *op : n->getOperands()) {
+                if (members.count(op) == 0 &&
+                    std::find(inputs.begin(), inputs.end(), op) == inputs.end())
+                    inputs.push_back(op);
+            }
+        }
+
+        for (PSNode *n : cycle)
+            n->removeAllOperands();
+
+        for (PSNode *op : inputs)
+            rep->addOperand(op);
+
+        for (PSNode *n : cycle) {
+            if (n == rep)
+                continue;
+
+            rep->addPointsTo(n->pointsTo);
+
+            // the users of the node now use the representative
+            for (PSNode *user : n->getUsers())
+                resetDiff(user);
+            n->replaceAllUsesWith(rep);
+
+            n->addOperand(rep);
+            resetDiff(n);
+            collapsed.set(n, rep);
+            enqueue(n);
+        }
+
+        resetDiff(rep);
+        enqueue(rep);
+
+        return true;
+    }
+
 protected:
     PointerAnalysisFI() = default;
 
 public:
-    PointerAnalysisFI(PointerSubgraph *ps)
-    : PointerAnalysis(ps) {
+    PointerAnalysisFI(PointerSubgraph *ps,
+                      const PointerAnalysisOptions& opts)
+    : PointerAnalysis(ps, opts) {
         memory_objects.reserve(std::max(ps->size() / 100, static_cast<size_t>(8)));
     }
 
+    // default options
+    PointerAnalysisFI(PointerSubgraph *ps) : PointerAnalysisFI(ps, {}) {}
+
+    bool isFlowInsensitive() const override { return true; }
+
+    bool beforeProcessed(PSNode *n) override {
+        if (!getOptions().collapseCycles)
+            return false;
+
+        PSNode *rep = collapsed.get(n);
+        if (!rep || n->getOperandsNum() == 1)
+            return false;
+
+        // the node got new operands after it had been collapsed
+        // (e.g. it is a parameter of a function called via a pointer),
+        // pass them to the representative
+        auto operands = n->getOperands();
+        for (PSNode *op : operands) {
+            if (op != rep && !rep->hasOperand(op))
+                rep->addOperand(op);
+        }
+
+        n->removeAllOperands();
+        n->addOperand(rep);
+        resetDiff(n);
+        resetDiff(rep);
+        enqueue(rep);
+
+        return false;
+    }
+
+    bool afterProcessed(PSNode *n) override {
+        if (!getOptions().collapseCycles || !isCopyNode(n) ||
+            n->pointsTo.empty() || collapsed.get(n))
+            return false;
+
+        bool changed = false;
+        for (PSNode *op : n->getOperands()) {
+            if (!isCopyNode(op) ||
+                !checked_edges.emplace(op->getID(), n->getID()).second)
+                continue;
+
+            if (samePointsTo(op, n)) {
+                for (const auto& cycle : findCycles(n))
+                    changed |= collapse(cycle);
+                // the operands of the node may have changed
+                break;
+            }
+        }
+
+        return changed;
+    }
+
+    // the nodes that were merged with another node on a cycle
+    // mapped to the node that represents the cycle
+    const PointsToMapping<PSNode *>& getCollapsedNodes() const {
+        return collapsed;
+    }
+
     void getMemoryObjects(PSNode *where, const Pointer& pointer,
                           std::vector<MemoryObject *>& objects) override
     {
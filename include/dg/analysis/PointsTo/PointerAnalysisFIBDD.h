@@ -0,0 +1,47 @@
+#ifndef _DG_ANALYSIS_POINTS_TO_FLOW_INSENSITIVE_BDD_H_
+#define _DG_ANALYSIS_POINTS_TO_FLOW_INSENSITIVE_BDD_H_
+
+#include "PointerAnalysisFI.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+///
+// Flow-insensitive inclusion-based pointer analysis that propagates
+// the points-to information of the whole graph at once. The points-to
+// sets of the nodes and the contents of the memory are relations encoded
+// in BDDs and the copy, load and store rules are applied to the whole
+// relations as relational products. GEPs are applied node by node
+// between the rounds. The rest (memcpy, calls via function pointers,
+// loads from zero-initialized memory, ...) is left to the regular
+// solver of PointerAnalysisFI that runs after the relations
+// reach the fixpoint and has then usually very little work to do.
+// The relations do not care about the order of the nodes, so a load
+// that precedes all stores on the paths from the root may get some
+// pointers that the regular solver alone would not give it.
+class PointerAnalysisFIBDD : public PointerAnalysisFI
+{
+    // compute the fixpoint of the relations and store
+    // the results to the nodes and memory objects
+    void solveRelations();
+
+public:
+    PointerAnalysisFIBDD(PointerSubgraph *ps,
+                         const PointerAnalysisOptions& opts)
+    : PointerAnalysisFI(ps, opts) {}
+
+    // default options
+    PointerAnalysisFIBDD(PointerSubgraph *ps) : PointerAnalysisFIBDD(ps, {}) {}
+
+    void preprocess() override {
+        PointerAnalysisFI::preprocess();
+        solveRelations();
+    }
+};
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif // _DG_ANALYSIS_POINTS_TO_FLOW_INSENSITIVE_BDD_H_
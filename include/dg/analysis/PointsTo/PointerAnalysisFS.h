@@ -18,7 +18,10 @@ class PointerAnalysisFS : public PointerAnalysis
 {
 public:
     //using MemoryObjectsSetT = std::set<MemoryObject *>;
-    using MemoryMapT = std::map<PSNode *, std::unique_ptr<MemoryObject>>;
+    // The memory objects are shared between the memory maps
+    // and copied only when a node writes to them (copy-on-write),
+    // so a merge node does not duplicate all the memory of its predecessors.
+    using MemoryMapT = std::map<PSNode *, std::shared_ptr<MemoryObject>>;
 
     // this is an easy but not very efficient implementation,
     // works for testing
@@ -60,6 +63,10 @@ public:
         return true;
     }
 
+    bool sharesMemoryState(PSNode *n) const override {
+        return !needsMerge(n);
+    }
+
     bool afterProcessed(PSNode *n) override
     {
         bool changed = false;
@@ -92,6 +99,17 @@ public:
             }
         }
 
+        // the node wrote into the memory before we merged the memory
+        // from the predecessors, so the objects may have got more fields
+        if (n->getType() == PSNodeType::STORE ||
+            n->getType() == PSNodeType::MEMCPY) {
+            for (const auto& ptr : n->getOperand(1)->pointsTo) {
+                auto it = mm->find(ptr.target);
+                if (it != mm->end() && needsCollapse(it->second.get()))
+                    changed |= collapseIfNeeded(makeUnique(it->second));
+            }
+        }
+
         return changed;
     }
 
@@ -101,19 +119,18 @@ public:
         MemoryMapT *mm = where->getData<MemoryMapT>();
         assert(mm && "Node does not have memory map");
 
+        // this psnode may write to the memory, so it must get its own
+        // copy of the object. If we haven't found any memory object,
+        // create a new one, so that the write has something to write to
+        if (canChangeMM(where)) {
+            objects.push_back(getOrCreateMO(mm, pointer.target));
+            return;
+        }
+
         auto I = mm->find(pointer.target);
         if (I != mm->end()) {
             objects.push_back(I->second.get());
         }
-
-        // if we haven't found any memory object, but this psnode
-        // is a write to memory, create a new one, so that
-        // the write has something to write to
-        if (objects.empty() && canChangeMM(where)) {
-            MemoryObject *mo = new MemoryObject(pointer.target);
-            mm->emplace(pointer.target, std::unique_ptr<MemoryObject>(mo));
-            objects.push_back(mo);
-        }
     }
 
 protected:
@@ -153,12 +170,14 @@ protected:
                              PointsToSetT *overwritten) {
         bool changed = false;
 
+        // the pointers in collapsed memory are on the unknown offset
+        bool collapsed = to->isCollapsed();
         for (auto& fromIt : from->pointsTo) {
             if (overwritten &&
                 overwritten->count(Pointer(node, fromIt.first)))
                 continue;
 
-            auto& S = to->pointsTo[fromIt.first];
+            auto& S = to->pointsTo[collapsed ? Offset::UNKNOWN : fromIt.first];
             for (const auto& ptr : fromIt.second)
                 changed |= S.add(ptr);
         }
@@ -166,6 +185,74 @@ protected:
         return changed;
     }
 
+    // does 'to' contain all the pointers from 'from'
+    // that are not overwritten?
+    static bool containsObject(PSNode *node,
+                               MemoryObject *to,
+                               MemoryObject *from,
+                               PointsToSetT *overwritten) {
+        for (auto& fromIt : from->pointsTo) {
+            if (fromIt.second.empty())
+                continue;
+
+            if (overwritten &&
+                overwritten->count(Pointer(node, fromIt.first)))
+                continue;
+
+            auto toIt = to->pointsTo.find(fromIt.first);
+            if (toIt == to->pointsTo.end())
+                return false;
+
+            for (const auto& ptr : fromIt.second) {
+                if (!toIt->second.count(ptr))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    static bool isEmpty(const MemoryObject *mo) {
+        for (const auto& it : mo->pointsTo) {
+            if (!it.second.empty())
+                return false;
+        }
+
+        return true;
+    }
+
+    static bool overwritesTarget(PointsToSetT *overwritten, PSNode *target) {
+        if (!overwritten)
+            return false;
+
+        for (const auto& ptr : *overwritten) {
+            if (ptr.target == target)
+                return true;
+        }
+
+        return false;
+    }
+
+    // copy the object if it is shared with another memory map,
+    // so that we can write to it
+    static MemoryObject *makeUnique(std::shared_ptr<MemoryObject>& mo) {
+        assert(mo && "No memory object");
+        if (mo.use_count() > 1)
+            mo = std::make_shared<MemoryObject>(*mo);
+        return mo.get();
+    }
+
+    // get a memory object from the memory map that can be written to
+    static MemoryObject *getOrCreateMO(MemoryMapT *mm, PSNode *target) {
+        std::shared_ptr<MemoryObject>& moptr = (*mm)[target];
+        if (!moptr) {
+            moptr = std::make_shared<MemoryObject>(target);
+            return moptr.get();
+        }
+
+        return makeUnique(moptr);
+    }
+
     // Merge two Memory maps, return true if any new information was created,
     // otherwise return false
     static bool mergeMaps(MemoryMapT *mm, MemoryMapT *from,
@@ -173,12 +260,25 @@ protected:
         bool changed = false;
         for (auto& it : *from) {
             PSNode *fromTarget = it.first;
-            std::unique_ptr<MemoryObject>& toMo = (*mm)[fromTarget];
+            MemoryObject *fromMo = it.second.get();
+            std::shared_ptr<MemoryObject>& toMo = (*mm)[fromTarget];
+
+            // just share the object if no pointer in it is overwritten
+            if (toMo == nullptr && !overwritesTarget(overwritten, fromTarget)) {
+                toMo = it.second;
+                changed |= !isEmpty(fromMo);
+                continue;
+            }
+
             if (toMo == nullptr)
-                toMo.reset(new MemoryObject(fromTarget));
+                toMo = std::make_shared<MemoryObject>(fromTarget);
+            else if (toMo == it.second ||
+                     containsObject(fromTarget, toMo.get(),
+                                    fromMo, overwritten))
+                continue;
 
-            changed |= mergeObjects(fromTarget, toMo.get(),
-                                    it.second.get(), overwritten);
+            changed |= mergeObjects(fromTarget, makeUnique(toMo),
+                                    fromMo, overwritten);
         }
 
         return changed;
@@ -23,15 +23,6 @@ class PointerAnalysisFSInv : public PointerAnalysisFS
         return n->predecessorsNum() > 1 || canChangeMM(n);
     }
 
-    static MemoryObject *getOrCreateMO(MemoryMapT *mm, PSNode *target) {
-        std::unique_ptr<MemoryObject>& moptr = (*mm)[target];
-        if (!moptr)
-            moptr.reset(new MemoryObject(target));
-
-        assert(mm->find(target) != mm->end());
-        return moptr.get();
-    }
-
     PSNode *strongUpdateVariable{nullptr};
 
 public:
@@ -73,6 +64,10 @@ public:
         return true;
     }
 
+    bool sharesMemoryState(PSNode *n) const override {
+        return !needsMerge(n);
+    }
+
     bool afterProcessed(PSNode *n) override
     {
         if (n->getType() == PSNodeType::INVALIDATE_LOCALS)
@@ -171,7 +166,9 @@ public:
                 if (predS.empty())
                     continue;
 
-                PointsToSetT& S = mo->pointsTo[it.first];
+                // the pointers in collapsed memory are on the unknown offset
+                PointsToSetT& S = mo->pointsTo[mo->isCollapsed() ? Offset::UNKNOWN
+                                                                 : it.first];
 
                 // merge pointers from the previous states
                 // but do not include the pointers
@@ -345,7 +342,9 @@ public:
                 if (predS.empty()) // keep the map clean
                     continue;
 
-                PointsToSetT& S = mo->pointsTo[it.first];
+                // the pointers in collapsed memory are on the unknown offset
+                PointsToSetT& S = mo->pointsTo[mo->isCollapsed() ? Offset::UNKNOWN
+                                                                 : it.first];
 
                 // merge pointers from the previous states
                 // but do not include the pointers
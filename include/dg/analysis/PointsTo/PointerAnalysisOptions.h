@@ -1,6 +1,8 @@
 #ifndef _DG_POINTER_ANALYSIS_OPTIONS_H_
 #define _DG_POINTER_ANALYSIS_OPTIONS_H_
 
+#include <cstddef>
+
 #include "dg/analysis/AnalysisOptions.h"
 
 namespace dg {
@@ -19,8 +21,62 @@ struct PointerAnalysisOptions : AnalysisOptions {
     // INVALIDATED object.
     bool invalidateNodes{false};
 
+    // Process only the pointers that were added to the operands
+    // since the node was processed the last time (difference
+    // propagation), instead of the whole points-to sets.
+    bool diffPropagation{true};
+
+    // How to compute the fixpoint: in batches (every batch consists
+    // of all the nodes reachable from the nodes that changed in the previous
+    // batch), or using a worklist ordered by the topological order
+    // of strongly connected components that contains only the nodes
+    // that may be affected by a change.
+    enum class Solver { batch, worklist } solver{Solver::batch};
+
+    // the order of the nodes with the same priority in the worklist
+    enum class WorklistPolicy { fifo, lifo } worklistPolicy{WorklistPolicy::fifo};
+
+    // Detect cycles of copy nodes (PHI and CAST nodes) during the analysis
+    // and collapse every such cycle into one node, as all the nodes
+    // on the cycle have the same points-to set (lazy cycle detection).
+    // Only the flow-insensitive analysis supports this.
+    bool collapseCycles{false};
+
+    // The number of threads that solve the flow-insensitive analysis.
+    // With more than one thread, the analysis is computed in rounds:
+    // the threads compute the new pointers of all the nodes
+    // of the round in parallel from the state of the previous round
+    // and the results are merged sequentially (in the order of the nodes),
+    // so the results do not depend on the number of threads.
+    unsigned threads{1};
+
+    // The maximal number of nodes that one query of the demand-driven
+    // analysis may add to the computation (0 means no limit).
+    // If a query needs more nodes, its answer is the unknown pointer.
+    size_t queryBudget{0};
+
+    // Collapse a memory object into a single field on the unknown offset
+    // when pointers are stored into it on more than 'objectFieldsBudget'
+    // distinct offsets (0 means no limit). Unlike 'fieldSensitivity',
+    // this makes only the objects with too many fields insensitive
+    // (e.g., big arrays of structures). The collapsed allocations
+    // are marked (PSNodeAlloc::isCollapsed()).
+    size_t objectFieldsBudget{0};
+
+    // Collapse also the memory objects that are accessed via GEPs on loops
+    // (the GEPs then get the unknown offset, see preprocessGeps)
+    bool collapseLoopObjects{false};
+
     PointerAnalysisOptions& setInvalidateNodes(bool b) { invalidateNodes = b; return *this;}
     PointerAnalysisOptions& setPreprocessGeps(bool b)  { preprocessGeps = b; return *this;}
+    PointerAnalysisOptions& setDiffPropagation(bool b) { diffPropagation = b; return *this;}
+    PointerAnalysisOptions& setSolver(Solver s) { solver = s; return *this;}
+    PointerAnalysisOptions& setWorklistPolicy(WorklistPolicy p) { worklistPolicy = p; return *this;}
+    PointerAnalysisOptions& setCollapseCycles(bool b) { collapseCycles = b; return *this;}
+    PointerAnalysisOptions& setThreads(unsigned n) { threads = n; return *this;}
+    PointerAnalysisOptions& setQueryBudget(size_t n) { queryBudget = n; return *this;}
+    PointerAnalysisOptions& setObjectFieldsBudget(size_t n) { objectFieldsBudget = n; return *this;}
+    PointerAnalysisOptions& setCollapseLoopObjects(bool b) { collapseLoopObjects = b; return *this;}
 };
 
 } // namespace analysis
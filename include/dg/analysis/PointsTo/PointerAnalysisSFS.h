@@ -0,0 +1,430 @@
+#ifndef _DG_ANALYSIS_POINTS_TO_SPARSE_FLOW_SENSITIVE_H_
+#define _DG_ANALYSIS_POINTS_TO_SPARSE_FLOW_SENSITIVE_H_
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "MemoryObject.h"
+#include "PointerSubgraph.h"
+#include "PointerAnalysisFI.h"
+#include "PointerAnalysisFS.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+///
+// Staged sparse flow-sensitive pointer analysis (Hardekopf and Lin, 2011).
+//
+// First, the flow-insensitive analysis computes an over-approximation
+// of the points-to sets. From these, we build the memory SSA form:
+// every store and memcpy defines (chi) the objects its address may point to,
+// every load and memcpy uses (mu) the definition of the objects that
+// reaches it, and the definitions from different paths are joined
+// in phi nodes. Then the flow-sensitive analysis propagates the contents
+// of memory only along these def-use edges instead of copying memory maps
+// along the control flow. The results are the same as the results
+// of PointerAnalysisFS, with the exception that the calls via function
+// pointers are resolved by the flow-insensitive analysis.
+//
+class PointerAnalysisSFS : public PointerAnalysisFS
+{
+    // a definition of the memory object 'target' in the memory SSA
+    struct MemDef {
+        // the node that writes to the memory,
+        // or the join node where the phi is placed
+        PSNode *node;
+        PSNode *target;
+        bool isPhi;
+
+        // for a phi, the definitions from the predecessors of the node,
+        // otherwise the definition that reaches the node (if any)
+        std::vector<MemDef *> operands;
+        // the definitions that have this definition as an operand
+        std::vector<MemDef *> users;
+        // the nodes that read the memory defined by this definition
+        std::set<PSNode *> readers;
+
+        // the contents of the memory after this definition
+        MemoryObject mo;
+        // the value of mo.lastChange when we propagated mo the last time
+        size_t stamp{0};
+
+        MemDef(PSNode *n, PSNode *t, bool phi)
+        : node(n), target(t), isPhi(phi), mo(t) {}
+    };
+
+    std::vector<std::unique_ptr<MemDef>> defs;
+    // (node, target) -> the definition of target in the node (chi)
+    std::unordered_map<uint64_t, MemDef *> writers;
+    // node -> all the definitions in the node
+    std::unordered_map<unsigned, std::vector<MemDef *>> nodeWriters;
+    // (node, target) -> the definition of target that reaches the node
+    // (nullptr if there is none)
+    std::unordered_map<uint64_t, MemDef *> reaching;
+
+    // phi nodes whose operands were not found yet
+    std::vector<MemDef *> pending;
+    // definitions whose memory has changed
+    std::vector<MemDef *> dirty;
+
+    // the first stage of the analysis, it builds the called functions
+    // using the callbacks of the main analysis
+    class FIStage : public PointerAnalysisFI {
+        PointerAnalysisSFS *parent;
+
+    public:
+        FIStage(PointerAnalysisSFS *p, const PointerAnalysisOptions& opts)
+        : PointerAnalysisFI(p->getPS(), opts), parent(p) {}
+
+        bool functionPointerCall(PSNode *where, PSNode *what) override {
+            return parent->functionPointerCall(where, what);
+        }
+
+        bool errorEmptyPointsTo(PSNode *from, PSNode *to) override {
+            return parent->errorEmptyPointsTo(from, to);
+        }
+
+        bool error(PSNode *at, const char *msg) override {
+            return parent->error(at, msg);
+        }
+    };
+
+    static uint64_t key(PSNode *n, PSNode *target) {
+        return (static_cast<uint64_t>(n->getID()) << 32) | target->getID();
+    }
+
+    static bool isMemoryTarget(const Pointer& ptr) {
+        return ptr.isValid() && !ptr.isInvalidated() &&
+                ptr.target->getType() != PSNodeType::FUNCTION;
+    }
+
+    MemDef *getWriter(PSNode *n, PSNode *target) const {
+        auto it = writers.find(key(n, target));
+        return it == writers.end() ? nullptr : it->second;
+    }
+
+    MemDef *createDef(PSNode *n, PSNode *target, bool phi) {
+        MemDef *def = new MemDef(n, target, phi);
+        defs.emplace_back(def);
+        if (phi)
+            pending.push_back(def);
+        else {
+            writers.emplace(key(n, target), def);
+            nodeWriters[n->getID()].push_back(def);
+        }
+
+        return def;
+    }
+
+    void addOperand(MemDef *def, MemDef *op) {
+        def->operands.push_back(op);
+        op->users.push_back(def);
+
+        if (def->isPhi &&
+            mergeObjects(def->target, &def->mo, &op->mo, nullptr))
+            dirty.push_back(def);
+    }
+
+    // the definition of target that reaches the entry of the node n
+    MemDef *reachingDef(PSNode *target, PSNode *n) {
+        std::vector<PSNode *> visited;
+        std::unordered_set<PSNode *> visitedSet;
+        MemDef *def = nullptr;
+
+        // walk back until we find a definition or a join point
+        while (true) {
+            auto it = reaching.find(key(n, target));
+            if (it != reaching.end()) {
+                def = it->second;
+                break;
+            }
+
+            // a cycle without a join point (unreachable from the root)
+            if (!visitedSet.insert(n).second)
+                break;
+            visited.push_back(n);
+
+            if (n->predecessorsNum() == 0)
+                break;
+
+            if (n->predecessorsNum() > 1) {
+                // the operands are found later, so that we do not
+                // recurse over the loops in the graph
+                def = createDef(n, target, true /* phi */);
+                break;
+            }
+
+            PSNode *pred = n->getSinglePredecessor();
+            if ((def = getWriter(pred, target)))
+                break;
+            n = pred;
+        }
+
+        for (PSNode *v : visited)
+            reaching.emplace(key(v, target), def);
+
+        return def;
+    }
+
+    // find the operands of new phi nodes (this may create new phi nodes)
+    void resolvePending() {
+        while (!pending.empty()) {
+            MemDef *phi = pending.back();
+            pending.pop_back();
+
+            for (PSNode *pred : phi->node->getPredecessors()) {
+                MemDef *op = getWriter(pred, phi->target);
+                if (!op)
+                    op = reachingDef(phi->target, pred);
+                if (op && op != phi)
+                    addOperand(phi, op);
+            }
+        }
+    }
+
+    // propagate the changed memory along the def-use edges
+    void propagate() {
+        resolvePending();
+
+        while (!dirty.empty()) {
+            MemDef *def = dirty.back();
+            dirty.pop_back();
+
+            for (PSNode *reader : def->readers)
+                enqueue(reader);
+
+            for (MemDef *user : def->users) {
+                if (!user->isPhi) {
+                    // the definition merges the memory
+                    // when its node is processed
+                    enqueue(user->node);
+                } else if (mergeObjects(user->target, &user->mo,
+                                        &def->mo, nullptr)) {
+                    dirty.push_back(user);
+                }
+            }
+        }
+    }
+
+    MemDef *addWriter(PSNode *n, PSNode *target) {
+        MemDef *def = getWriter(n, target);
+        if (def)
+            return def;
+
+        def = createDef(n, target, false /* phi */);
+        if (MemDef *in = reachingDef(target, n))
+            addOperand(def, in);
+        return def;
+    }
+
+    // build the memory SSA from the results of the flow-insensitive analysis
+    void buildMemorySSA(const std::vector<PSNode *>& nodes) {
+        std::vector<std::pair<PSNode *, PSNode *>> chis;
+        for (PSNode *n : nodes) {
+            if (n->getType() == PSNodeType::STORE) {
+                for (const Pointer& ptr : n->getOperand(1)->pointsTo) {
+                    if (isMemoryTarget(ptr))
+                        chis.emplace_back(n, ptr.target);
+                }
+            } else if (n->getType() == PSNodeType::MEMCPY) {
+                // the memcpy reads the source in its own memory state
+                // (as in PointerAnalysisFS), so it defines it too
+                for (unsigned i = 0; i < 2; ++i) {
+                    for (const Pointer& ptr : n->getOperand(i)->pointsTo) {
+                        if (isMemoryTarget(ptr))
+                            chis.emplace_back(n, ptr.target);
+                    }
+                }
+            }
+        }
+
+        // create all the definitions first, so that we know
+        // where to stop when looking for the reaching definitions
+        for (auto& chi : chis) {
+            if (!getWriter(chi.first, chi.second))
+                createDef(chi.first, chi.second, false /* phi */);
+        }
+
+        for (auto& chi : chis) {
+            MemDef *def = getWriter(chi.first, chi.second);
+            if (def->operands.empty()) {
+                if (MemDef *in = reachingDef(chi.second, chi.first))
+                    addOperand(def, in);
+            }
+        }
+
+        for (PSNode *n : nodes) {
+            if (n->getType() != PSNodeType::LOAD)
+                continue;
+
+            for (const Pointer& ptr : n->getOperand(0)->pointsTo) {
+                if (!isMemoryTarget(ptr))
+                    continue;
+                if (MemDef *def = reachingDef(ptr.target, n))
+                    def->readers.insert(n);
+            }
+        }
+
+        resolvePending();
+        dirty.clear();
+    }
+
+    // run the flow-insensitive analysis and use its results
+    // to build the memory SSA
+    void runFIStage() {
+        PointerSubgraph *PS = getPS();
+
+        // the flow-insensitive analysis may set these flags
+        // in other situations than the flow-sensitive analysis
+        // (e.g., it collapses the objects that have too many fields
+        // in the whole program, not at some point of the program)
+        std::vector<PSNodeAlloc *> notZeroed;
+        std::vector<PSNodeAlloc *> notCollapsed;
+        for (const auto& nd : PS->getNodes()) {
+            PSNodeAlloc *alloc = nd ? PSNodeAlloc::get(nd.get()) : nullptr;
+            if (alloc && !alloc->isZeroInitialized())
+                notZeroed.push_back(alloc);
+            if (alloc && !alloc->isCollapsed())
+                notCollapsed.push_back(alloc);
+        }
+
+        PointerAnalysisOptions opts = getOptions();
+        opts.setPreprocessGeps(false).setCollapseCycles(false);
+        {
+            FIStage fi(this, opts);
+            fi.run();
+
+            // the memory objects of FI analysis are gone now
+            for (const auto& nd : PS->getNodes()) {
+                if (nd)
+                    nd->setData<MemoryObject>(nullptr);
+            }
+            UNKNOWN_MEMORY->setData<MemoryObject>(nullptr);
+        }
+
+        for (PSNodeAlloc *alloc : notZeroed)
+            alloc->setZeroInitialized(false);
+        for (PSNodeAlloc *alloc : notCollapsed)
+            alloc->setIsCollapsed(false);
+
+        // the graph may have changed by the calls via function pointers
+        initPointerAnalysis();
+
+        std::vector<PSNode *> nodes = PS->getNodes(PS->getRoot());
+        buildMemorySSA(nodes);
+
+        // Compute the points-to sets again, flow-sensitively.
+        // We keep the pointers of calls via function pointers,
+        // as the called functions are already in the graph.
+        for (PSNode *n : nodes) {
+            switch (n->getType()) {
+                case PSNodeType::CALL_RETURN:
+                    if (n->getPairedNode()->getType() == PSNodeType::CALL_FUNCPTR) {
+                        // keep the unknown pointer from the called declarations
+                        bool unknown = n->pointsTo.count(PointerUnknown) > 0;
+                        n->pointsTo = PointsToSetT();
+                        if (unknown)
+                            n->pointsTo.add(PointerUnknown);
+                        break;
+                    }
+                    // fall-through
+                case PSNodeType::LOAD:
+                case PSNodeType::GEP:
+                case PSNodeType::CAST:
+                case PSNodeType::PHI:
+                case PSNodeType::RETURN:
+                    n->pointsTo = PointsToSetT();
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+public:
+    PointerAnalysisSFS(PointerSubgraph *ps,
+                       PointerAnalysisOptions opts)
+    : PointerAnalysisFS(ps, opts.setSolver(PointerAnalysisOptions::Solver::worklist)) {}
+
+    PointerAnalysisSFS(PointerSubgraph *ps) : PointerAnalysisSFS(ps, {}) {}
+
+    void preprocess() override {
+        runFIStage();
+        PointerAnalysisFS::preprocess();
+    }
+
+    bool isSparse() const override { return true; }
+
+    bool sharesMemoryState(PSNode *) const override { return false; }
+
+    bool beforeProcessed(PSNode *) override { return false; }
+
+    bool afterProcessed(PSNode *n) override
+    {
+        auto it = nodeWriters.find(n->getID());
+        if (it == nodeWriters.end())
+            return false;
+
+        // every store that stores to a memory allocated
+        // not in a loop is a strong update (see PointerAnalysisFS)
+        PointsToSetT *overwritten = nullptr;
+        if (n->getType() == PSNodeType::STORE) {
+            if (!pointsToAllocationInLoop(n->getOperand(1)))
+                overwritten = &n->getOperand(1)->pointsTo;
+        }
+
+        for (MemDef *def : it->second) {
+            bool changed = def->mo.lastChange != def->stamp;
+            for (MemDef *in : def->operands)
+                changed |= mergeObjects(def->target, &def->mo,
+                                        &in->mo, overwritten);
+            def->stamp = def->mo.lastChange;
+
+            if (changed)
+                dirty.push_back(def);
+        }
+
+        propagate();
+
+        // we queued the affected nodes ourselves
+        return false;
+    }
+
+    void getMemoryObjects(PSNode *where, const Pointer& pointer,
+                          std::vector<MemoryObject *>& objects) override
+    {
+        MemDef *def = nullptr;
+        if (where->getType() == PSNodeType::STORE ||
+            where->getType() == PSNodeType::MEMCPY) {
+            def = getWriter(where, pointer.target);
+            if (!def) {
+                assert(0 && "The flow-insensitive stage missed a pointer");
+                def = addWriter(where, pointer.target);
+            }
+        } else {
+            def = reachingDef(pointer.target, where);
+        }
+
+        // the new phi nodes may have found some memory
+        propagate();
+
+        if (!def)
+            return;
+
+        if (where->getType() != PSNodeType::STORE)
+            def->readers.insert(where);
+        objects.push_back(&def->mo);
+    }
+};
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif // _DG_ANALYSIS_POINTS_TO_SPARSE_FLOW_SENSITIVE_H_
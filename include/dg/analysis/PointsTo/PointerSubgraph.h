@@ -1,14 +1,19 @@
 #ifndef _DG_POINTER_SUBGRAPH_H_
 #define _DG_POINTER_SUBGRAPH_H_
 
+#include "dg/ADT/Arena.h"
 #include "dg/ADT/Queue.h"
 #include "dg/analysis/SubgraphNode.h"
 #include "dg/analysis/PointsTo/PSNode.h"
 
 #include <cassert>
-#include <cstdarg>
+#include <initializer_list>
 #include <vector>
 #include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 
 namespace dg {
 namespace analysis {
@@ -16,20 +21,170 @@ namespace pta {
 
 class PointerSubgraph
 {
+    // The number of the existing graphs. The process-wide state
+    // of the points-to sets is released when the last graph
+    // is destroyed (so this must be destroyed after the nodes).
+    // Not synchronized, like the state of the points-to sets.
+    struct GraphsCounter {
+        static size_t& count() {
+            static size_t num = 0;
+            return num;
+        }
+
+        GraphsCounter() { ++count(); }
+        GraphsCounter(GraphsCounter&&) { ++count(); }
+        ~GraphsCounter() {
+            if (--count() == 0)
+                releasePointsToSets();
+        }
+    } graphsCounter;
+
     unsigned int dfsnum;
 
     // root of the pointer state subgraph
     PSNode *root;
 
-    using NodesT = std::vector<std::unique_ptr<PSNode>>;
+public:
+    // the nodes are allocated in the arena, so deleting a node
+    // only destroys it, the memory is freed together with the graph
+    struct NodeDeleter {
+        void operator()(PSNode *nd) const { nd->~PSNode(); }
+    };
+
+    using NodePtr = std::unique_ptr<PSNode, NodeDeleter>;
+    using NodesT = std::vector<NodePtr>;
+
+private:
+    // the memory for the nodes (must be destroyed after the nodes)
+    ADT::Arena arena;
     NodesT nodes;
 
+    // the nodes that got new operands while the analysis was running
+    // (see operandsChanged())
+    std::vector<PSNode *> changedNodes;
+
     // Take care of assigning ids to new nodes
     unsigned int last_node_id = 0;
     unsigned int getNewNodeId() {
         return ++last_node_id;
     }
 
+    template <typename T, typename... Args>
+    T *newNode(Args&&... args) {
+        void *mem = arena.allocate(sizeof(T), alignof(T));
+        return new (mem) T(std::forward<Args>(args)...);
+    }
+
+    template <PSNodeType Type>
+    using NodeTag = std::integral_constant<PSNodeType, Type>;
+
+    // the number of the operands of nodes that take only operands
+    // as the arguments (-1 if the node can have any number of them,
+    // -2 if the node takes other arguments)
+    static constexpr int operandsNum(PSNodeType t) {
+        return (t == PSNodeType::NOOP || t == PSNodeType::FUNCTION) ? 0 :
+               (t == PSNodeType::LOAD || t == PSNodeType::CAST ||
+                t == PSNodeType::CALL_FUNCPTR || t == PSNodeType::FREE ||
+                t == PSNodeType::INVALIDATE_OBJECT ||
+                t == PSNodeType::INVALIDATE_LOCALS) ? 1 :
+               (t == PSNodeType::STORE) ? 2 :
+               (t == PSNodeType::PHI || t == PSNodeType::RETURN ||
+                t == PSNodeType::CALL_RETURN) ? -1 : -2;
+    }
+
+    template <PSNodeType Type, typename... Ops,
+              typename = typename std::enable_if<operandsNum(Type) != -2>::type>
+    PSNode *createNode(NodeTag<Type>, Ops&&... ops) {
+        static_assert(operandsNum(Type) == -1 ||
+                      operandsNum(Type) == static_cast<int>(sizeof...(Ops)),
+                      "Wrong number of operands for this type of node");
+        return newNode<PSNode>(getNewNodeId(), Type,
+                               std::initializer_list<PSNode *>{ops...});
+    }
+
+    PSNode *createNode(NodeTag<PSNodeType::ALLOC>) {
+        return newNode<PSNodeAlloc>(getNewNodeId(), PSNodeType::ALLOC);
+    }
+
+    PSNode *createNode(NodeTag<PSNodeType::DYN_ALLOC>) {
+        return newNode<PSNodeAlloc>(getNewNodeId(), PSNodeType::DYN_ALLOC);
+    }
+
+    PSNode *createNode(NodeTag<PSNodeType::GEP>, PSNode *src, Offset off) {
+        return newNode<PSNodeGep>(getNewNodeId(), src, off);
+    }
+
+    PSNode *createNode(NodeTag<PSNodeType::MEMCPY>,
+                       PSNode *src, PSNode *dest, Offset len) {
+        return newNode<PSNodeMemcpy>(getNewNodeId(), src, dest, len);
+    }
+
+    PSNode *createNode(NodeTag<PSNodeType::CONSTANT>,
+                       PSNode *target, Offset off) {
+        return newNode<PSNode>(getNewNodeId(), PSNodeType::CONSTANT,
+                               target, off);
+    }
+
+    PSNode *createNode(NodeTag<PSNodeType::ENTRY>) {
+        return newNode<PSNodeEntry>(getNewNodeId());
+    }
+
+    PSNode *createNode(NodeTag<PSNodeType::CALL>) {
+        return newNode<PSNodeCall>(getNewNodeId());
+    }
+
+    // a copy of the node without operands and edges (see copyNodes())
+    PSNode *copyNode(PSNode *nd) {
+        PSNode *n;
+        switch (nd->getType()) {
+            case PSNodeType::ALLOC:
+            case PSNodeType::DYN_ALLOC: {
+                PSNodeAlloc *orig = PSNodeAlloc::get(nd);
+                PSNodeAlloc *a = newNode<PSNodeAlloc>(getNewNodeId(), nd->getType());
+                a->setZeroInitialized(orig->isZeroInitialized());
+                if (orig->isHeap())
+                    a->setIsHeap();
+                if (orig->isGlobal())
+                    a->setIsGlobal();
+                n = a;
+                break;
+            }
+            case PSNodeType::GEP:
+                n = newNode<PSNodeGep>(getNewNodeId(), nd->getOperand(0),
+                                       PSNodeGep::get(nd)->getOffset());
+                // the operands are added by copyNodes()
+                n->removeAllOperands();
+                break;
+            case PSNodeType::MEMCPY:
+                n = newNode<PSNodeMemcpy>(getNewNodeId(), nd->getOperand(0),
+                                          nd->getOperand(1),
+                                          PSNodeMemcpy::get(nd)->getLength());
+                n->removeAllOperands();
+                break;
+            case PSNodeType::ENTRY:
+                n = newNode<PSNodeEntry>(getNewNodeId(),
+                                         PSNodeEntry::get(nd)->getFunctionName());
+                break;
+            case PSNodeType::CALL: {
+                PSNodeCall *c = newNode<PSNodeCall>(getNewNodeId());
+                for (PointerSubgraph *callee : PSNodeCall::get(nd)->getCallees())
+                    c->addCalee(callee);
+                n = c;
+                break;
+            }
+            default:
+                n = newNode<PSNode>(getNewNodeId(), nd->getType());
+                // the constants have the points-to set from the beginning
+                if (nd->getType() == PSNodeType::CONSTANT)
+                    n->pointsTo = nd->pointsTo;
+                break;
+        }
+
+        n->setSize(nd->getSize());
+        n->setUserData(nd->getUserData<void>());
+        return n;
+    }
+
 public:
     PointerSubgraph() : dfsnum(0), root(nullptr) {
         // nodes[0] represents invalid node (the node with id 0)
@@ -39,8 +194,11 @@ public:
     const NodesT& getNodes() const { return nodes; }
     size_t size() const { return nodes.size(); }
 
+    // The defaulted move assignment would free the old arena (it is
+    // declared before the nodes) and then destroy the old nodes
+    // that lived in it, so the graph can be only move-constructed.
     PointerSubgraph(PointerSubgraph&&) = default;
-    PointerSubgraph& operator=(PointerSubgraph&&) = default;
+    PointerSubgraph& operator=(PointerSubgraph&&) = delete;
     PointerSubgraph(const PointerSubgraph&) = delete;
     PointerSubgraph operator=(const PointerSubgraph&) = delete;
 
@@ -77,49 +235,88 @@ public:
         nodes[nd->getID()].reset();
     }
 
-    PSNode *create(PSNodeType t, ...) {
-        va_list args;
-        PSNode *node = nullptr;
-
-        va_start(args, t);
-        switch (t) {
-            case PSNodeType::ALLOC:
-            case PSNodeType::DYN_ALLOC:
-                node = new PSNodeAlloc(getNewNodeId(), t);
-                break;
-            case PSNodeType::GEP:
-                node = new PSNodeGep(getNewNodeId(),
-                                     va_arg(args, PSNode *),
-                                     va_arg(args, Offset::type));
-                break;
-            case PSNodeType::MEMCPY:
-                node = new PSNodeMemcpy(getNewNodeId(),
-                                        va_arg(args, PSNode *),
-                                        va_arg(args, PSNode *),
-                                        va_arg(args, Offset::type));
-                break;
-            case PSNodeType::CONSTANT:
-                node = new PSNode(getNewNodeId(), PSNodeType::CONSTANT,
-                                  va_arg(args, PSNode *),
-                                  va_arg(args, Offset::type));
-                break;
-            case PSNodeType::ENTRY:
-                node = new PSNodeEntry(getNewNodeId());
-                break;
-            case PSNodeType::CALL:
-                node = new PSNodeCall(getNewNodeId());
-                break;
-            default:
-                node = new PSNode(getNewNodeId(), t, args);
-                break;
-        }
-        va_end(args);
-
+    ///
+    // Create a new node of the type 'Type'. The arguments depend
+    // on the type of the node:
+    //
+    // ALLOC, DYN_ALLOC, FUNCTION, NOOP, ENTRY, CALL:
+    //      no arguments
+    // LOAD, CAST, CALL_FUNCPTR, FREE, INVALIDATE_OBJECT, INVALIDATE_LOCALS:
+    //      the operand
+    // STORE:    the stored value and the pointer to the memory
+    // GEP:      the pointer and the offset
+    // MEMCPY:   the source, the destination and the length
+    // CONSTANT: the target and the offset of the pointer
+    // PHI, RETURN, CALL_RETURN:
+    //      any number of operands
+    //
+    // (see also the description of the types in PSNode.h)
+    template <PSNodeType Type, typename... Args>
+    PSNode *create(Args&&... args) {
+        PSNode *node = createNode(NodeTag<Type>(), std::forward<Args>(args)...);
         assert(node && "Didn't created node");
         nodes.emplace_back(node);
         return node;
     }
 
+    ///
+    // Create copies of the nodes (used for cloning parts of the graph).
+    // The copies have the same type and data as the nodes (the copies
+    // of allocations are new memory objects, the constants keep their
+    // pointers). The edges, operands, parents and paired nodes that
+    // connect the copied nodes connect the copies, the operands
+    // (parents, paired nodes) outside of 'nds' are kept and the edges
+    // that lead out of 'nds' are not copied. Returns the copies
+    // in the order of 'nds'.
+    std::vector<PSNode *> copyNodes(const std::vector<PSNode *>& nds) {
+        std::unordered_map<const PSNode *, PSNode *> copies;
+        std::vector<PSNode *> ret;
+        ret.reserve(nds.size());
+
+        for (PSNode *nd : nds) {
+            PSNode *n = copyNode(nd);
+            nodes.emplace_back(n);
+            copies.emplace(nd, n);
+            ret.push_back(n);
+        }
+
+        auto get = [&copies](PSNode *nd) {
+            auto it = copies.find(nd);
+            return it == copies.end() ? nd : it->second;
+        };
+
+        for (size_t i = 0; i < nds.size(); ++i) {
+            PSNode *nd = nds[i];
+            PSNode *n = ret[i];
+            for (PSNode *op : nd->getOperands())
+                n->addOperand(get(op));
+            for (PSNode *succ : nd->getSuccessors()) {
+                auto it = copies.find(succ);
+                if (it != copies.end())
+                    n->addSuccessor(it->second);
+            }
+
+            if (nd->getParent())
+                n->setParent(get(nd->getParent()));
+            if (nd->getPairedNode())
+                n->setPairedNode(get(nd->getPairedNode()));
+        }
+
+        return ret;
+    }
+
+    // Tell the analysis that the node got new operands while the analysis
+    // was running (the analysis gets the new nodes and edges by itself
+    // after a call via a function pointer was inserted into the graph,
+    // but it does not know about the new operands of the old nodes)
+    void operandsChanged(PSNode *nd) { changedNodes.push_back(nd); }
+    const std::vector<PSNode *>& getChangedNodes() const { return changedNodes; }
+    std::vector<PSNode *> takeChangedNodes() {
+        std::vector<PSNode *> ret;
+        ret.swap(changedNodes);
+        return ret;
+    }
+
     // get nodes in BFS order and store them into
     // the container
     std::vector<PSNode *> getNodes(PSNode *start_node,
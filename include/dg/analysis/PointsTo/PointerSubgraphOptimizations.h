@@ -1,6 +1,12 @@
 #ifndef _DG_POINTER_SUBGRAPH_OPTIMIZATIONS_H_
 #define _DG_POINTER_SUBGRAPH_OPTIMIZATIONS_H_
 
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "dg/ADT/Queue.h"
 #include "PointsToMapping.h"
 
 namespace dg {
@@ -81,7 +87,9 @@ class PSUnknownsReducer {
                 // (and its address is not stored anywhere) and there are only loads
                 // from this memory (that must result to unknown)
                 if (usersImplyUnknown(nd.get())) {
-                    for (PSNode *user : nd->getUsers()) {
+                    // removing the users changes the users of nd
+                    auto users = nd->getUsers();
+                    for (PSNode *user : users) {
                         if (user->getType() == PSNodeType::LOAD) {
                             // replace the uses of the load value by unknown
                             // (this is what would happen in the analysis)
@@ -89,6 +97,7 @@ class PSUnknownsReducer {
                             mapping.add(user, UNKNOWN_MEMORY);
                         }
                         // store can be removed directly
+                        user->removeAllOperands();
                         user->isolate();
                         PS->remove(user);
                         ++removed;
@@ -98,16 +107,9 @@ class PSUnknownsReducer {
                     // pointer to itself and may be queried for this pointer
                 }
             } else if (nd->getType() == PSNodeType::PHI && nd->getOperandsNum() == 0) {
-                for (PSNode *user : nd->getUsers()) {
-                    // replace the uses of this value with unknown
-                    user->replaceAllUsesWith(UNKNOWN_MEMORY);
-                    mapping.add(user, UNKNOWN_MEMORY);
-
-                    // store can be removed directly
-                    user->isolate();
-                    PS->remove(user);
-                    ++removed;
-                }
+                // replace the uses of this value with unknown
+                nd->replaceAllUsesWith(UNKNOWN_MEMORY);
+                mapping.add(nd.get(), UNKNOWN_MEMORY);
 
                 nd->isolate();
                 PS->remove(nd.get());
@@ -147,6 +149,7 @@ public:
 
     unsigned run() {
         mergeCasts();
+        resolveChains();
         return merged_nodes_num;
     }
 
@@ -167,18 +170,28 @@ private:
                 if (GEP->getOffset().isZero()) // GEP with 0 offest is cast
                     merge(node, GEP->getSource());
             } else if (node->getType() == PSNodeType::PHI &&
-                        node->getOperandsNum() > 0 && allOperandsAreSame(node)) {
+                        node->getOperandsNum() > 0 && allOperandsAreSame(node) &&
+                        node->getOperand(0) != node) {
                 merge(node, node->getOperand(0));
             }
         }
     }
 
+    // a node may have been merged to a node that was merged later
+    void resolveChains() {
+        for (auto& it : mapping) {
+            while (PSNode *nd = mapping.get(it.second))
+                it.second = nd;
+        }
+    }
+
     // merge node1 and node2 (node2 will be
     // the representant and node1 will be removed,
     // mapping will be set to  node1 -> node2)
     void merge(PSNode *node1, PSNode *node2) {
         // remove node1
         node1->replaceAllUsesWith(node2);
+        node1->removeAllOperands();
         node1->isolate();
         PS->remove(node1);
 
@@ -195,6 +208,198 @@ private:
     unsigned merged_nodes_num;
 };
 
+///
+// Offline variable substitution by hash-based value numbering (HVN).
+// The nodes that compute the same operation over the same values
+// (e.g. two GEPs with the same offset from the same pointer) have
+// the same points-to sets, so we keep only one of them.
+// The numbering works only with the operands of the nodes,
+// so the loads are merged only if the analysis is flow-insensitive
+// (otherwise the memory may differ at the loads).
+// The nodes on cycles get a unique number (the cycles are left
+// to the analysis).
+class PSValueNumbering {
+public:
+    using MappingT = PointsToMapping<PSNode *>;
+
+    PSValueNumbering(PointerSubgraph *S, bool mergeLoads = false)
+    : PS(S), merge_loads(mergeLoads) {}
+
+    MappingT& getMapping() { return mapping; }
+    const MappingT& getMapping() const { return mapping; }
+
+    unsigned getNumOfMergedNodes() const {
+        return merged_nodes_num;
+    }
+
+    unsigned run() {
+        computeNumbers();
+        mergeNodes();
+        return merged_nodes_num;
+    }
+
+private:
+    PointerSubgraph *PS;
+    bool merge_loads;
+    // map nodes to its equivalent representant
+    MappingT mapping;
+    unsigned merged_nodes_num{0};
+
+    unsigned last_number{0};
+    std::unordered_map<const PSNode *, unsigned> numbers;
+    // the nodes of the graph in the order in which they got the numbers
+    // (the operands before the nodes that use them)
+    std::vector<PSNode *> numbered;
+    // (type, offset or target, numbers of operands) -> number
+    std::map<std::vector<uint64_t>, unsigned> expressions;
+
+    unsigned getNumber(std::vector<uint64_t>&& expr) {
+        auto it = expressions.find(expr);
+        if (it != expressions.end())
+            return it->second;
+
+        unsigned num = ++last_number;
+        expressions.emplace_hint(it, std::move(expr), num);
+        return num;
+    }
+
+    // compute the number of the node whose
+    // operands are already numbered
+    unsigned computeNumber(PSNode *nd) {
+        auto type = static_cast<uint64_t>(nd->getType());
+        switch (nd->getType()) {
+            case PSNodeType::CAST:
+                return numbers[nd->getOperand(0)];
+            case PSNodeType::GEP: {
+                PSNodeGep *gep = PSNodeGep::get(nd);
+                if (gep->getOffset().isZero())
+                    return numbers[gep->getSource()];
+                return getNumber({type, *gep->getOffset(),
+                                  numbers[gep->getSource()]});
+            }
+            case PSNodeType::CONSTANT: {
+                assert(nd->pointsTo.size() == 1);
+                const Pointer& ptr = *nd->pointsTo.begin();
+                return getNumber({type, *ptr.offset, numbers[ptr.target]});
+            }
+            case PSNodeType::PHI: {
+                std::set<uint64_t> ops;
+                for (PSNode *op : nd->getOperands())
+                    ops.insert(numbers[op]);
+                // the phi may get new operands later
+                // if it has no operands now
+                if (ops.empty())
+                    break;
+                if (ops.size() == 1)
+                    return *ops.begin();
+
+                std::vector<uint64_t> expr{type};
+                expr.insert(expr.end(), ops.begin(), ops.end());
+                return getNumber(std::move(expr));
+            }
+            case PSNodeType::LOAD:
+                if (merge_loads)
+                    return getNumber({type, numbers[nd->getOperand(0)]});
+                break;
+            default:
+                break;
+        }
+
+        return ++last_number;
+    }
+
+    void computeNumbers() {
+        // the special nodes are not in the graph
+        for (PSNode *nd : {NULLPTR, UNKNOWN_MEMORY, INVALIDATED})
+            numbers[nd] = ++last_number;
+
+        // number the nodes in the topological order of the def-use
+        // chains (the operands first)
+        // (the ready nodes are taken in FIFO order, so the equal nodes
+        // get their numbers mostly in the order of the graph)
+        std::unordered_map<const PSNode *, size_t> pending;
+        ADT::QueueFIFO<PSNode *> ready;
+        for (const auto& nd : PS->getNodes()) {
+            if (!nd)
+                continue;
+
+            size_t num = 0;
+            for (PSNode *op : nd->getOperands()) {
+                if (numbers.count(op) == 0)
+                    ++num;
+            }
+
+            pending[nd.get()] = num;
+            if (num == 0)
+                ready.push(nd.get());
+        }
+
+        auto assign = [&](PSNode *nd, unsigned num) {
+            numbers[nd] = num;
+            numbered.push_back(nd);
+            for (PSNode *user : nd->getUsers()) {
+                for (PSNode *op : user->getOperands()) {
+                    if (op == nd && --pending[user] == 0)
+                        ready.push(user);
+                }
+            }
+        };
+
+        for (const auto& nd : PS->getNodes()) {
+            while (!ready.empty()) {
+                PSNode *cur = ready.pop();
+                assign(cur, computeNumber(cur));
+            }
+
+            // the node is on a cycle, give it a unique number
+            if (nd && numbers.count(nd.get()) == 0)
+                assign(nd.get(), ++last_number);
+        }
+
+        while (!ready.empty()) {
+            PSNode *cur = ready.pop();
+            assign(cur, computeNumber(cur));
+        }
+    }
+
+    static bool isAllocation(const PSNode *nd) {
+        return nd->getType() == PSNodeType::ALLOC ||
+               nd->getType() == PSNodeType::DYN_ALLOC ||
+               nd->getType() == PSNodeType::FUNCTION;
+    }
+
+    void mergeNodes() {
+        // The node that got the number first represents the others.
+        // That is the node that defines the value (e.g., the allocation
+        // for the casts and the PHIs with a single value), the others
+        // are computed from it. Taking the first node from the graph
+        // instead could replace the definition by its own copy
+        // and leave the copies without any allocation.
+        std::unordered_map<unsigned, PSNode *> representatives;
+        for (PSNode *node : numbered) {
+            PSNode *&rep = representatives[numbers[node]];
+            if (!rep)
+                rep = node;
+
+            if (rep == node)
+                continue;
+
+            // do not create a node that uses itself (on cycles)
+            // and never remove a memory object
+            if (rep->hasOperand(node) || isAllocation(node))
+                continue;
+
+            node->replaceAllUsesWith(rep);
+            node->removeAllOperands();
+            node->isolate();
+            PS->remove(node);
+
+            mapping.add(node, rep);
+            ++merged_nodes_num;
+        }
+    }
+};
+
 class PointerSubgraphOptimizer {
     using MappingT = PointsToMapping<PSNode *>;
 
@@ -202,6 +407,13 @@ class PointerSubgraphOptimizer {
     MappingT mapping;
 
     unsigned removed = 0;
+
+    void addMapping(MappingT&& rhs) {
+        // the nodes that we mapped to may have been removed now
+        mapping.compose(MappingT(rhs));
+        mapping.merge(std::move(rhs));
+    }
+
 public:
     PointerSubgraphOptimizer(PointerSubgraph *PS) : PS(PS) {}
 
@@ -213,7 +425,7 @@ public:
     void removeUnknowns() {
         PSUnknownsReducer reducer(PS);
         if (auto r = reducer.run()) {
-            mapping.merge(std::move(reducer.getMapping()));
+            addMapping(std::move(reducer.getMapping()));
             removed += r;
         }
     }
@@ -221,14 +433,24 @@ public:
     void removeEquivalentNodes() {
         PSEquivalentNodesMerger merger(PS);
         if (auto r = merger.run()) {
-                mapping.merge(std::move(merger.getMapping()));
-                removed += r;
+            addMapping(std::move(merger.getMapping()));
+            removed += r;
+        }
+    }
+
+    // @mergeLoads  see PSValueNumbering
+    void removeEquivalentValues(bool mergeLoads = false) {
+        PSValueNumbering numbering(PS, mergeLoads);
+        if (auto r = numbering.run()) {
+            addMapping(std::move(numbering.getMapping()));
+            removed += r;
         }
     }
 
     unsigned run() {
         removeNoops();
         removeEquivalentNodes();
+        removeEquivalentValues();
         removeUnknowns();
         // need to call this once more because
         // the optimizations may have created
@@ -2,6 +2,8 @@
 #define _DG_POINTER_SUBGRAPH_VALIDATOR_H_
 
 #include <string>
+#include <vector>
+
 #include "dg/analysis/PointsTo/PointerSubgraph.h"
 
 namespace dg {
@@ -17,10 +19,14 @@ namespace debug {
 class PointerSubgraphValidator {
     const PointerSubgraph *PS;
 
+    bool isInGraph(const PSNode *nd) const;
+
     /* These methods return true if the graph is invalid */
     bool checkEdges();
     bool checkNodes();
     bool checkOperands();
+    bool checkEdges(const PSNode *nd);
+    bool checkOperands(const PSNode *nd);
 
 protected:
     std::string errors{};
@@ -38,6 +44,10 @@ public:
     virtual ~PointerSubgraphValidator() = default;
 
     bool validate();
+    // Check only the part of the graph that was added after the graph
+    // had been validated (the nodes with the ID 'firstNew' and higher)
+    // and the operands of the nodes 'changed'
+    bool validate(size_t firstNew, const std::vector<PSNode *>& changed);
 
     const std::string& getErrors() const { return errors; }
     const std::string& getWarnings() const { return warnings; }
@@ -0,0 +1,95 @@
+#ifndef _DG_ANALYSIS_POINTS_TO_CACHE_H_
+#define _DG_ANALYSIS_POINTS_TO_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dg/analysis/PointsTo/PointerSubgraph.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+///
+// The points-to sets of a solved PointerSubgraph stored in a file.
+//
+// The file contains the points-to sets of all nodes of the graph
+// (one array of pointers and an index into it), the collapsed flags
+// of the allocations and the calls via function pointers that
+// the analysis inserted into the graph, in the order in which they
+// were inserted. To reuse the results, the graph must be built again
+// in the same way and checked (matchesBeforeCalls()), then the calls
+// must be inserted again (getCalls()) and the points-to sets
+// can be restored (restore()).
+// The graph is identified by a key given by the user (a hash of the program
+// and of the options of the analysis). The file is mapped into memory,
+// so only the pages that we really touch are read.
+//
+class PointsToCache
+{
+public:
+    // (the ID of the callsite, the ID of the called function)
+    using CallT = std::pair<unsigned, unsigned>;
+
+private:
+    // the layout of the file (see PointsToCache.cpp)
+    struct Header;
+    struct StoredPointer;
+
+    const char *data{nullptr};
+    size_t dataSize{0};
+
+    // the parts of the mapped file
+    const Header *header{nullptr};
+    const uint64_t *index{nullptr};
+    const StoredPointer *pointers{nullptr};
+    const uint32_t *calls{nullptr};
+    const uint8_t *types{nullptr};
+    const uint8_t *flags{nullptr};
+
+    void close();
+
+public:
+    PointsToCache() = default;
+    PointsToCache(const PointsToCache&) = delete;
+    PointsToCache& operator=(const PointsToCache&) = delete;
+    ~PointsToCache() { close(); }
+
+    // store the points-to sets of the nodes from the graph into the file,
+    // 'calls' are the calls via pointers inserted by the analysis
+    static bool save(const std::string& path, uint64_t key,
+                     const PointerSubgraph& PS,
+                     const std::vector<CallT>& calls);
+
+    // map the file into memory, return false if it does not exist,
+    // it is broken or it was created for a different key
+    bool open(const std::string& path, uint64_t key);
+    bool isOpen() const { return data != nullptr; }
+
+    size_t getNodesNum() const;
+    std::vector<CallT> getCalls() const;
+
+    // check that the graph is the stored graph before the calls
+    // via pointers were inserted (the graph that was built again),
+    // so that the calls can be inserted
+    bool matchesBeforeCalls(const PointerSubgraph& PS) const;
+
+    // add the stored pointers to the points-to sets of the nodes
+    // and set the stored flags of the allocations.
+    // Return false (and do not change anything) if the graph does not
+    // have the same nodes as the stored graph
+    bool restore(PointerSubgraph& PS) const;
+
+    // hash the data into the key (FNV-1a), for computing the keys
+    static uint64_t hash(const void *bytes, size_t len,
+                         uint64_t seed = 14695981039346656037ULL);
+};
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif // _DG_ANALYSIS_POINTS_TO_CACHE_H_
@@ -3,9 +3,15 @@
 
 #include "dg/analysis/PointsTo/Pointer.h"
 #include "dg/ADT/Bitvector.h"
+#include "dg/ADT/BDD.h"
 
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <iterator>
 #include <cassert>
 
 namespace dg {
@@ -216,10 +222,670 @@ public:
 };
 
 
+///
+// Mapping between pointers and unique numbers. The numbers are
+// used as indices into the bitvector of HybridPointsToSet
+// once the set outgrows its inline storage. There is one mapping
+// per process (see get()) and it is not synchronized: the IDs
+// may be created only by one thread at a time and nobody else
+// may use the mapping meanwhile. The IDs are not released one
+// by one, the whole mapping is cleared when the last PointerSubgraph
+// is destroyed (see releasePointsToSets()).
+class PointerIdMapping {
+    struct PointerHash {
+        size_t operator()(const Pointer& ptr) const {
+            return std::hash<PSNode *>()(ptr.target) ^
+                   (std::hash<Offset::type>()(*ptr.offset) << 1);
+        }
+    };
+
+    std::vector<Pointer> idToPointer;
+    std::unordered_map<Pointer, size_t, PointerHash> pointerToId;
+
+public:
+    // get the ID of the pointer, assign a new one if it has none yet
+    size_t getOrCreateId(const Pointer& ptr) {
+        auto it = pointerToId.emplace(ptr, idToPointer.size());
+        if (it.second)
+            idToPointer.push_back(ptr);
+
+        return it.first->second;
+    }
+
+    // get the ID of the pointer or -1 if the pointer has no ID
+    size_t getId(const Pointer& ptr) const {
+        auto it = pointerToId.find(ptr);
+        if (it == pointerToId.end())
+            return ~static_cast<size_t>(0);
+        return it->second;
+    }
+
+    const Pointer& getPointer(size_t id) const {
+        assert(id < idToPointer.size() && "Invalid pointer ID");
+        return idToPointer[id];
+    }
+
+    size_t size() const { return idToPointer.size(); }
+
+    void clear() {
+        std::vector<Pointer>().swap(idToPointer);
+        std::unordered_map<Pointer, size_t, PointerHash>().swap(pointerToId);
+    }
+
+    static PointerIdMapping& get() {
+        static PointerIdMapping mapping;
+        return mapping;
+    }
+};
+
+///
+// Points-to set that keeps up to N pointers inline (no allocation
+// at all) and lifts itself to a bitvector indexed by pointer IDs
+// (see PointerIdMapping) once it grows bigger. Most of the points-to
+// sets in a program have only one or two elements, so in the common
+// case this set does not touch the heap.
+template <unsigned N = 2>
+class HybridPointsToSetImpl {
+    static_assert(N > 0, "Need at least one inline element");
+
+    using BigSetT = ADT::SparseBitvector;
+
+    // inline storage: the first 'smallNum' elements
+    // of the arrays are valid
+    PSNode *smallTargets[N]{};
+    Offset::type smallOffsets[N]{};
+    unsigned smallNum{0};
+
+    // the set of pointer IDs, used if the set is lifted
+    std::unique_ptr<BigSetT> big;
+
+    static PointerIdMapping& ids() { return PointerIdMapping::get(); }
+
+    bool isSmall() const { return !big; }
+
+    bool _hasSmall(PSNode *target, Offset::type off) const {
+        for (unsigned i = 0; i < smallNum; ++i) {
+            if (smallTargets[i] == target && smallOffsets[i] == off)
+                return true;
+        }
+
+        return false;
+    }
+
+    bool _has(const Pointer& ptr) const {
+        if (isSmall())
+            return _hasSmall(ptr.target, *ptr.offset);
+
+        size_t id = ids().getId(ptr);
+        if (id == ~static_cast<size_t>(0))
+            return false;
+        return big->get(id);
+    }
+
+    void _lift() {
+        assert(isSmall());
+        big.reset(new BigSetT());
+        for (unsigned i = 0; i < smallNum; ++i) {
+            big->set(ids().getOrCreateId(Pointer(smallTargets[i],
+                                                 smallOffsets[i])));
+        }
+        smallNum = 0;
+    }
+
+    // insert the pointer without any handling of unknown offsets,
+    // return true if the pointer was not in the set
+    bool _insert(const Pointer& ptr) {
+        if (isSmall()) {
+            if (_hasSmall(ptr.target, *ptr.offset))
+                return false;
+
+            if (smallNum < N) {
+                smallTargets[smallNum] = ptr.target;
+                smallOffsets[smallNum] = *ptr.offset;
+                ++smallNum;
+                return true;
+            }
+
+            _lift();
+        }
+
+        return !big->set(ids().getOrCreateId(ptr));
+    }
+
+    // remove all pointers to 'target' with known offset
+    void _removeKnownOffsets(PSNode *target) {
+        if (isSmall()) {
+            unsigned j = 0;
+            for (unsigned i = 0; i < smallNum; ++i) {
+                if (smallTargets[i] != target) {
+                    smallTargets[j] = smallTargets[i];
+                    smallOffsets[j] = smallOffsets[i];
+                    ++j;
+                }
+            }
+            smallNum = j;
+            return;
+        }
+
+        // bitvector does not support removing elements,
+        // so build a new one
+        std::unique_ptr<BigSetT> tmp(new BigSetT());
+        for (size_t id : *big) {
+            if (ids().getPointer(id).target != target)
+                tmp->set(id);
+        }
+        big.swap(tmp);
+    }
+
+    bool addWithUnknownOffset(PSNode *target) {
+        if (_has({target, Offset::UNKNOWN}))
+            return false;
+
+        _removeKnownOffsets(target);
+        return _insert({target, Offset::UNKNOWN});
+    }
+
+public:
+    HybridPointsToSetImpl() = default;
+    HybridPointsToSetImpl(HybridPointsToSetImpl&&) = default;
+    HybridPointsToSetImpl& operator=(HybridPointsToSetImpl&&) = default;
+
+    HybridPointsToSetImpl(const HybridPointsToSetImpl& rhs)
+    : smallNum(rhs.smallNum),
+      big(rhs.big ? new BigSetT(*rhs.big) : nullptr) {
+        for (unsigned i = 0; i < smallNum; ++i) {
+            smallTargets[i] = rhs.smallTargets[i];
+            smallOffsets[i] = rhs.smallOffsets[i];
+        }
+    }
+
+    HybridPointsToSetImpl& operator=(const HybridPointsToSetImpl& rhs) {
+        HybridPointsToSetImpl tmp(rhs);
+        swap(tmp);
+        return *this;
+    }
+
+    bool add(PSNode *target, Offset off) {
+        if (off.isUnknown())
+            return addWithUnknownOffset(target);
+
+        // if we have the same pointer but with unknown offset,
+        // do nothing
+        if (_has({target, Offset::UNKNOWN}))
+            return false;
+
+        return _insert({target, off});
+    }
+
+    bool add(const Pointer& ptr) {
+        return add(ptr.target, ptr.offset);
+    }
+
+    // make union of the two sets and store it
+    // into 'this' set (i.e. merge rhs to this set)
+    bool merge(const HybridPointsToSetImpl& rhs) {
+        if (!isSmall() && !rhs.isSmall())
+            return big->merge(*rhs.big);
+
+        bool changed = false;
+        for (const Pointer& ptr : rhs)
+            changed |= _insert(ptr);
+
+        return changed;
+    }
+
+    bool empty() const { return isSmall() ? smallNum == 0 : big->empty(); }
+    size_t count(const Pointer& ptr) const { return _has(ptr); }
+    bool has(const Pointer& ptr) const { return _has(ptr); }
+    size_t size() const { return isSmall() ? smallNum : big->size(); }
+
+    void swap(HybridPointsToSetImpl& rhs) {
+        // swap the whole arrays, they are trivially copyable
+        for (unsigned i = 0; i < N; ++i) {
+            std::swap(smallTargets[i], rhs.smallTargets[i]);
+            std::swap(smallOffsets[i], rhs.smallOffsets[i]);
+        }
+        std::swap(smallNum, rhs.smallNum);
+        big.swap(rhs.big);
+    }
+
+    class const_iterator {
+        const HybridPointsToSetImpl *set{nullptr};
+        // position in the inline storage
+        unsigned pos{0};
+        // position in the bitvector (if the set is lifted)
+        typename BigSetT::const_iterator bigIt;
+
+        const_iterator(const HybridPointsToSetImpl *s, bool end = false)
+        : set(s) {
+            if (set->isSmall())
+                pos = end ? set->smallNum : 0;
+            else
+                bigIt = end ? set->big->end() : set->big->begin();
+        }
+
+    public:
+        const_iterator() = default;
+
+        const_iterator& operator++() {
+            if (set->isSmall())
+                ++pos;
+            else
+                ++bigIt;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        Pointer operator*() const {
+            if (set->isSmall()) {
+                assert(pos < set->smallNum);
+                return Pointer(set->smallTargets[pos], set->smallOffsets[pos]);
+            }
+
+            return ids().getPointer(*bigIt);
+        }
+
+        bool operator==(const const_iterator& rhs) const {
+            assert(set == rhs.set && "Comparing iterators of different sets");
+            if (set->isSmall())
+                return pos == rhs.pos;
+            return bigIt == rhs.bigIt;
+        }
+
+        bool operator!=(const const_iterator& rhs) const {
+            return !operator==(rhs);
+        }
+
+        friend class HybridPointsToSetImpl;
+    };
+
+    const_iterator begin() const { return const_iterator(this); }
+    const_iterator end() const { return const_iterator(this, true /* end */); }
+
+    friend class const_iterator;
+};
+
+using HybridPointsToSet = HybridPointsToSetImpl<2>;
+
+///
+// Table of interned (hash-consed) points-to sets. Every distinct
+// set of pointers is stored here only once, as an immutable sorted
+// vector, and is referred to by its ID. The results of unions and
+// additions are memoized. Like PointerIdMapping, there is one table
+// per process that is not synchronized (the sets may be modified
+// only by one thread at a time and nobody else may use the table
+// meanwhile). The interned sets are released when the last
+// PointerSubgraph is destroyed (see releasePointsToSets()).
+class PointsToSetsTable {
+public:
+    using SetT = std::vector<Pointer>;
+    using IdT = unsigned;
+
+    // ID of the empty set
+    static const IdT EMPTY = 0;
+
+private:
+    struct SetHash {
+        size_t operator()(const SetT& S) const {
+            size_t h = S.size();
+            for (const Pointer& ptr : S) {
+                h ^= std::hash<PSNode *>()(ptr.target) + 0x9e3779b9
+                     + (h << 6) + (h >> 2);
+                h ^= std::hash<Offset::type>()(*ptr.offset) + 0x9e3779b9
+                     + (h << 6) + (h >> 2);
+            }
+            return h;
+        }
+    };
+
+    struct AddKeyHash {
+        size_t operator()(const std::pair<IdT, Pointer>& key) const {
+            return std::hash<PSNode *>()(key.second.target) ^
+                   (std::hash<Offset::type>()(*key.second.offset) << 1) ^
+                   (std::hash<IdT>()(key.first) << 2);
+        }
+    };
+
+    // the sets are the keys of the map, so that we can look up
+    // their IDs. unordered_map never moves its elements, so we
+    // can keep pointers to the keys in 'sets'
+    std::unordered_map<SetT, IdT, SetHash> setToId;
+    std::vector<const SetT *> sets;
+
+    // memoized results of operations
+    std::unordered_map<uint64_t, IdT> unionCache;
+    std::unordered_map<std::pair<IdT, Pointer>, IdT, AddKeyHash> addCache;
+
+    PointsToSetsTable() { intern(SetT()); }
+
+public:
+    PointsToSetsTable(const PointsToSetsTable&) = delete;
+    PointsToSetsTable& operator=(const PointsToSetsTable&) = delete;
 
-using PointsToSetT = PointsToSet;
+    IdT intern(SetT&& S) {
+        auto it = setToId.emplace(std::move(S), sets.size());
+        if (it.second)
+            sets.push_back(&it.first->first);
+
+        return it.first->second;
+    }
+
+    const SetT& getSet(IdT id) const {
+        assert(id < sets.size() && "Invalid ID of points-to set");
+        return *sets[id];
+    }
+
+    bool has(IdT id, const Pointer& ptr) const {
+        const SetT& S = getSet(id);
+        return std::binary_search(S.begin(), S.end(), ptr);
+    }
+
+    // return the ID of the set 'id' with 'ptr' added (no handling
+    // of unknown offsets is done here)
+    IdT add(IdT id, const Pointer& ptr) {
+        if (has(id, ptr))
+            return id;
+
+        auto key = std::make_pair(id, ptr);
+        auto it = addCache.find(key);
+        if (it != addCache.end())
+            return it->second;
+
+        const SetT& S = getSet(id);
+        SetT newS;
+        newS.reserve(S.size() + 1);
+        auto pos = std::lower_bound(S.begin(), S.end(), ptr);
+        newS.insert(newS.end(), S.begin(), pos);
+        newS.push_back(ptr);
+        newS.insert(newS.end(), pos, S.end());
+
+        IdT newId = intern(std::move(newS));
+        addCache.emplace(key, newId);
+        return newId;
+    }
+
+    // return the ID of the set 'id' without pointers to 'target'
+    IdT removeTarget(IdT id, PSNode *target) {
+        SetT newS;
+        for (const Pointer& ptr : getSet(id)) {
+            if (ptr.target != target)
+                newS.push_back(ptr);
+        }
+
+        return intern(std::move(newS));
+    }
+
+    IdT unite(IdT a, IdT b) {
+        if (a == b || b == EMPTY)
+            return a;
+        if (a == EMPTY)
+            return b;
+
+        // union is commutative
+        if (a > b)
+            std::swap(a, b);
+
+        uint64_t key = (static_cast<uint64_t>(a) << 32) | b;
+        auto it = unionCache.find(key);
+        if (it != unionCache.end())
+            return it->second;
+
+        const SetT& A = getSet(a);
+        const SetT& B = getSet(b);
+        SetT newS;
+        newS.reserve(A.size() + B.size());
+        std::set_union(A.begin(), A.end(), B.begin(), B.end(),
+                       std::back_inserter(newS));
+
+        IdT newId = intern(std::move(newS));
+        unionCache.emplace(key, newId);
+        return newId;
+    }
+
+    size_t size() const { return sets.size(); }
+
+    // release all the sets except the empty set
+    void clear() {
+        std::unordered_map<SetT, IdT, SetHash>().swap(setToId);
+        std::vector<const SetT *>().swap(sets);
+        std::unordered_map<uint64_t, IdT>().swap(unionCache);
+        std::unordered_map<std::pair<IdT, Pointer>, IdT, AddKeyHash>().swap(addCache);
+        intern(SetT());
+    }
+
+    static PointsToSetsTable& get() {
+        static PointsToSetsTable table;
+        return table;
+    }
+};
+
+///
+// Points-to set that is just a handle to an interned set from
+// PointsToSetsTable. Nodes with the same points-to sets share
+// the memory and comparing two sets is comparing two numbers.
+// Modifying the set replaces the handle with the handle
+// of the resulting set.
+class SharedPointsToSet {
+    using IdT = PointsToSetsTable::IdT;
+    IdT id{PointsToSetsTable::EMPTY};
+
+    static PointsToSetsTable& table() { return PointsToSetsTable::get(); }
+
+    bool setId(IdT newId) {
+        bool changed = newId != id;
+        id = newId;
+        return changed;
+    }
+
+    bool addWithUnknownOffset(PSNode *target) {
+        if (has({target, Offset::UNKNOWN}))
+            return false;
+
+        IdT newId = table().removeTarget(id, target);
+        return setId(table().add(newId, {target, Offset::UNKNOWN}));
+    }
+
+public:
+    using const_iterator = typename PointsToSetsTable::SetT::const_iterator;
+
+    bool add(PSNode *target, Offset off) {
+        if (off.isUnknown())
+            return addWithUnknownOffset(target);
+
+        // if we have the same pointer but with unknown offset,
+        // do nothing
+        if (has({target, Offset::UNKNOWN}))
+            return false;
+
+        return setId(table().add(id, {target, off}));
+    }
+
+    bool add(const Pointer& ptr) {
+        return add(ptr.target, ptr.offset);
+    }
+
+    // make union of the two sets and store it
+    // into 'this' set (i.e. merge rhs to this set)
+    bool merge(const SharedPointsToSet& rhs) {
+        return setId(table().unite(id, rhs.id));
+    }
+
+    size_t count(const Pointer& ptr) const { return table().has(id, ptr); }
+    bool has(const Pointer& ptr) const { return table().has(id, ptr); }
+    size_t size() const { return table().getSet(id).size(); }
+    bool empty() const { return id == PointsToSetsTable::EMPTY; }
+
+    // two shared sets are equal iff they have the same handle
+    bool operator==(const SharedPointsToSet& rhs) const { return id == rhs.id; }
+    bool operator!=(const SharedPointsToSet& rhs) const { return id != rhs.id; }
+    IdT getId() const { return id; }
+
+    void swap(SharedPointsToSet& rhs) { std::swap(id, rhs.id); }
+
+    const_iterator begin() const { return table().getSet(id).begin(); }
+    const_iterator end() const { return table().getSet(id).end(); }
+};
+
+///
+// Points-to set represented as a binary decision diagram over the bits
+// of pointer IDs (see PointerIdMapping). All the sets share one BDD
+// manager, so the sets that have common parts share the nodes
+// (the sets are hash-consed like in SharedPointsToSet, but the sharing
+// is not only all-or-nothing) and comparing two sets is comparing
+// two numbers. The manager is process-wide and not synchronized
+// and the sets are released when the last PointerSubgraph
+// is destroyed, as in PointsToSetsTable.
+class BDDPointsToSet {
+    using BDDManager = ADT::BDDManager;
+    using NodeT = BDDManager::NodeT;
+
+    // the number of bits of pointer IDs
+    static const unsigned BITS = 32;
+
+    NodeT root{BDDManager::ZERO};
+
+    static BDDManager& bdd() {
+        static BDDManager manager;
+        return manager;
+    }
+
+    // the pointer IDs are encoded using the first BITS levels
+    static const std::vector<BDDManager::LevelT>& levels() {
+        static std::vector<BDDManager::LevelT> lvls;
+        if (lvls.empty()) {
+            for (unsigned i = 0; i < BITS; ++i)
+                lvls.push_back(i);
+        }
+        return lvls;
+    }
+
+    static PointerIdMapping& ids() { return PointerIdMapping::get(); }
+
+    static NodeT minterm(const Pointer& ptr) {
+        size_t id = ids().getOrCreateId(ptr);
+        assert(id < (static_cast<size_t>(1) << BITS) && "Too many pointers");
+        return bdd().minterm(id, levels());
+    }
+
+    bool setRoot(NodeT newRoot) {
+        bool changed = newRoot != root;
+        root = newRoot;
+        return changed;
+    }
+
+    bool addWithUnknownOffset(PSNode *target) {
+        if (has({target, Offset::UNKNOWN}))
+            return false;
+
+        NodeT others = root;
+        for (const Pointer& ptr : *this) {
+            if (ptr.target == target)
+                others = bdd().bddDiff(others, minterm(ptr));
+        }
+
+        return setRoot(bdd().bddOr(others, minterm({target, Offset::UNKNOWN})));
+    }
+
+public:
+    class const_iterator {
+        BDDManager::const_iterator it;
+
+        const_iterator(BDDManager::const_iterator i) : it(i) {}
+
+    public:
+        const_iterator() = default;
+
+        const_iterator& operator++() {
+            ++it;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        Pointer operator*() const { return ids().getPointer(*it); }
+
+        bool operator==(const const_iterator& rhs) const { return it == rhs.it; }
+        bool operator!=(const const_iterator& rhs) const { return it != rhs.it; }
+
+        friend class BDDPointsToSet;
+    };
+
+    bool add(PSNode *target, Offset off) {
+        if (off.isUnknown())
+            return addWithUnknownOffset(target);
+
+        // if we have the same pointer but with unknown offset,
+        // do nothing
+        if (has({target, Offset::UNKNOWN}))
+            return false;
+
+        return setRoot(bdd().bddOr(root, minterm({target, off})));
+    }
+
+    bool add(const Pointer& ptr) {
+        return add(ptr.target, ptr.offset);
+    }
+
+    // make union of the two sets and store it
+    // into 'this' set (i.e. merge rhs to this set)
+    bool merge(const BDDPointsToSet& rhs) {
+        return setRoot(bdd().bddOr(root, rhs.root));
+    }
+
+    bool has(const Pointer& ptr) const {
+        size_t id = ids().getId(ptr);
+        if (id == ~static_cast<size_t>(0))
+            return false;
+        return bdd().contains(root, id, levels());
+    }
+
+    size_t count(const Pointer& ptr) const { return has(ptr); }
+    size_t size() const { return bdd().count(root, levels()); }
+    bool empty() const { return root == BDDManager::ZERO; }
+
+    bool operator==(const BDDPointsToSet& rhs) const { return root == rhs.root; }
+    bool operator!=(const BDDPointsToSet& rhs) const { return root != rhs.root; }
+
+    // the number of nodes of all the sets
+    static size_t nodesNum() { return bdd().size(); }
+    // the approximate memory (in bytes) taken by all the sets
+    static size_t memoryUsage() { return bdd().memoryUsage(); }
+
+    // release all the sets (all the non-empty sets are invalid then)
+    static void clear() { bdd().clear(); }
+
+    void swap(BDDPointsToSet& rhs) { std::swap(root, rhs.root); }
+
+    const_iterator begin() const { return bdd().begin(root, &levels()); }
+    const_iterator end() const { return bdd().end(); }
+};
+
+// Use interned points-to sets or BDDs if requested,
+// otherwise the hybrid points-to sets
+#ifdef DG_SHARED_POINTS_TO_SETS
+using PointsToSetT = SharedPointsToSet;
+#elif defined(DG_BDD_POINTS_TO_SETS)
+using PointsToSetT = BDDPointsToSet;
+#else
+using PointsToSetT = HybridPointsToSet;
+#endif
 using PointsToMapT = std::map<Offset, PointsToSetT>;
 
+// Release the process-wide state of the points-to sets (the pointer IDs,
+// the interned sets and the BDDs). There must be no points-to sets
+// left but the sets of NULLPTR, UNKNOWN_MEMORY and INVALIDATED
+// (these are kept). Called when the last PointerSubgraph is destroyed.
+void releasePointsToSets();
+
 } // namespace pta
 } // namespace analysis
 } // namespace dg
@@ -1,10 +1,16 @@
 #ifndef _DG_DEF_MAP_H_
 #define _DG_DEF_MAP_H_
 
-#include <set>
-#include <map>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
 
+#include "dg/ADT/Bitvector.h"
 #include "dg/analysis/Offset.h"
 
 namespace dg {
@@ -92,22 +98,65 @@ struct DefSite
 
 extern RDNode *UNKNOWN_MEMORY;
 
-// wrapper around std::set<> with few
-// improvements that will be handy in our set-up
+///
+// Every RDNode gets an ID when it is created (see RDNode), so that
+// the sets of definitions can be bitsets of IDs. This maps the IDs
+// back to the nodes. The IDs of destroyed nodes are reused,
+// so the numbers stay small and dense. The nodes may be created
+// and destroyed from more threads (the sparse graph builder creates
+// PHI nodes in parallel), but they must not be looked up meanwhile.
+class RDNodesRegistry {
+    std::vector<RDNode *> nodes;
+    std::vector<unsigned> freeIds;
+    std::mutex lock;
+
+public:
+    static RDNodesRegistry& get();
+
+    unsigned add(RDNode *n) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!freeIds.empty()) {
+            unsigned id = freeIds.back();
+            freeIds.pop_back();
+            nodes[id] = n;
+            return id;
+        }
+
+        nodes.push_back(n);
+        return nodes.size() - 1;
+    }
+
+    void remove(unsigned id) {
+        std::lock_guard<std::mutex> guard(lock);
+        assert(id < nodes.size() && "Invalid ID");
+        nodes[id] = nullptr;
+        freeIds.push_back(id);
+    }
+
+    RDNode *getNode(unsigned id) const {
+        assert(id < nodes.size() && nodes[id] && "Invalid ID");
+        return nodes[id];
+    }
+};
+
+// set of RDNodes kept as a sparse bitset of their IDs
+// with few improvements that will be handy in our set-up
 class RDNodesSet {
-    using ContainerTy = std::set<RDNode *>;
+    using ContainerTy = ADT::SparseBitvectorImpl<uint64_t, uint64_t, 1>;
 
     ContainerTy nodes;
     bool is_unknown;
 
+    static unsigned id(const RDNode *n);
+
 public:
     RDNodesSet() : is_unknown(false) {}
 
     // the set contains unknown mem. location
     void makeUnknown()
     {
-        nodes.clear();
-        nodes.insert(UNKNOWN_MEMORY);
+        nodes.reset();
+        nodes.set(id(UNKNOWN_MEMORY));
         is_unknown = true;
     }
 
@@ -120,12 +169,26 @@ public:
             makeUnknown();
             return true;
         } else
-            return nodes.insert(n).second;
+            return !nodes.set(id(n));
+    }
+
+    // add all the nodes from the other set
+    bool merge(const RDNodesSet& oth)
+    {
+        if (is_unknown)
+            return false;
+
+        if (oth.is_unknown) {
+            makeUnknown();
+            return true;
+        }
+
+        return nodes.merge(oth.nodes);
     }
 
     size_t count(RDNode *n) const
     {
-        return nodes.count(n);
+        return nodes.get(id(n)) ? 1 : 0;
     }
 
     size_t size() const
@@ -133,9 +196,14 @@ public:
         return nodes.size();
     }
 
+    bool empty() const
+    {
+        return nodes.empty();
+    }
+
     void clear()
     {
-        nodes.clear();
+        nodes.reset();
         is_unknown = false;
     }
 
@@ -144,28 +212,61 @@ public:
         return is_unknown;
     }
 
-    ContainerTy::iterator begin() { return nodes.begin(); }
-    ContainerTy::iterator end() { return nodes.end(); }
-    ContainerTy::const_iterator begin() const { return nodes.begin(); }
-    ContainerTy::const_iterator end() const { return nodes.end(); }
+    class const_iterator {
+        ContainerTy::const_iterator it;
 
-    ContainerTy& getNodes() {
-        return nodes;
+        const_iterator(const ContainerTy::const_iterator& i) : it(i) {}
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = RDNode *;
+        using difference_type = std::ptrdiff_t;
+        using pointer = RDNode * const *;
+        using reference = RDNode *;
+
+        const_iterator& operator++() { ++it; return *this; }
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            ++it;
+            return tmp;
+        }
+
+        RDNode *operator*() const {
+            return RDNodesRegistry::get().getNode(*it);
+        }
+
+        bool operator==(const const_iterator& rhs) const { return it == rhs.it; }
+        bool operator!=(const const_iterator& rhs) const { return it != rhs.it; }
+
+        friend class RDNodesSet;
     };
 
+    // the nodes are iterated in the order of their IDs
+    const_iterator begin() const { return const_iterator(nodes.begin()); }
+    const_iterator end() const { return const_iterator(nodes.end()); }
 };
 
 using DefSiteSetT = std::set<DefSite>;
 
+///
+// Map from def-sites to the nodes that define them. The def-sites
+// are kept sorted in a flat vector, so the def-sites of one target
+// form a contiguous range and merging two maps is a linear walk
+// over both of them. Adding a new def-site invalidates the iterators
+// and references to the sets of nodes.
 class RDMap
 {
 public:
-    using MapT = std::map<DefSite, RDNodesSet>;
+    using value_type = std::pair<DefSite, RDNodesSet>;
+    using MapT = std::vector<value_type>;
     using iterator = MapT::iterator;
     using const_iterator = MapT::const_iterator;
 
     RDMap() {}
-    RDMap(const RDMap& o);
+    RDMap(const RDMap& o) = default;
+    RDMap(RDMap&& o) = default;
+    RDMap& operator=(const RDMap& o) = default;
+    RDMap& operator=(RDMap&& o) = default;
 
     bool merge(const RDMap *o,
                DefSiteSetT *without = nullptr,
@@ -175,6 +276,7 @@ public:
     bool add(const DefSite&, RDNode *n);
     bool update(const DefSite&, RDNode *n);
     bool empty() const { return defs.empty(); }
+    size_t size() const { return defs.size(); }
 
     // @return iterators for the range of pointers that has the same object
     // as the given def site
@@ -184,7 +286,7 @@ public:
     std::pair<RDMap::iterator, RDMap::iterator>
     getObjectRange(RDNode *);
 
-    bool defines(const DefSite& ds) { return defs.count(ds) != 0; }
+    bool defines(const DefSite& ds) const { return find(ds) != defs.end(); }
     bool definesWithAnyOffset(const DefSite& ds);
 
     iterator begin() { return defs.begin(); }
@@ -192,11 +294,9 @@ public:
     const_iterator begin() const { return defs.begin(); }
     const_iterator end() const { return defs.end(); }
 
-    RDNodesSet& get(const DefSite& ds){ return defs[ds]; }
-    //const RDNodesSetT& get(const DefSite& ds) const { return defs[ds]; }
-    RDNodesSet& operator[](const DefSite& ds) { return defs[ds]; }
+    RDNodesSet& get(const DefSite& ds);
+    RDNodesSet& operator[](const DefSite& ds) { return get(ds); }
 
-    //RDNodesSet& get(RDNode *, const Offset&);
     // gather reaching definitions of memory [n + off, n + off + len]
     // and store them to the @ret
     size_t get(RDNode *n, const Offset& off,
@@ -206,7 +306,12 @@ public:
     const MapT& getDefs() const { return defs; }
 
 private:
-     MapT defs;
+    MapT defs;
+
+    const_iterator find(const DefSite& ds) const;
+    bool mergeToUnknown(const RDMap *o, DefSiteSetT *without,
+                        bool strong_update_unknown,
+                        Offset::type max_set_size);
 };
 
 } // rd
@@ -1,11 +1,14 @@
 #ifndef _DG_REACHING_DEFINITIONS_ANALYSIS_H_
 #define _DG_REACHING_DEFINITIONS_ANALYSIS_H_
 
+#include <memory>
 #include <vector>
 #include <set>
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 
+#include "dg/analysis/Analysis.h"
 #include "dg/analysis/Offset.h"
 #include "dg/analysis/SubgraphNode.h"
 #include "dg/BBlock.h"
@@ -58,16 +61,60 @@ enum class RDNodeType {
 
 extern RDNode *UNKNOWN_MEMORY;
 
+///
+// A block of the dense analysis -- a straight-line sequence of nodes
+// (we do not use BBlock, the graph does not need to have them). Every
+// node but the first one has just one predecessor, the previous node
+// of the block, and every node but the last one has just one successor.
+// The analysis computes the definitions that reach the end of the block
+// (they are kept in the last node) from the definitions generated
+// in the block and the def-sites that the block overwrites.
+// The definitions of the other nodes are computed when they are first
+// asked for (see RDNode::getReachingDefinitions()).
+struct RDNodesChain {
+    std::vector<RDNode *> nodes;
+    // the def-sites that some node of the block overwrites
+    DefSiteSetT overwrites;
+    // are the definitions of all the nodes computed?
+    bool materialized{false};
+
+    // the options of the analysis
+    bool strongUpdateUnknown{false};
+    Offset::type maxSetSize{Offset::UNKNOWN};
+
+    void materialize();
+};
+
 class RDNode : public SubgraphNode<RDNode> {
     RDNodeType type;
 
     BBlock<RDNode> *bblock = nullptr;
     // marks for DFS/BFS
     unsigned int dfsid;
+    // the order of the block that starts with this node
+    // in the reverse postorder (the priority in the solver)
+    unsigned int blockOrder{0};
+    // the block whose definitions are computed on demand
+    // (not set if the definitions of this node are computed)
+    std::shared_ptr<RDNodesChain> chain;
+
+    void materialize() {
+        if (chain && !chain->materialized)
+            chain->materialize();
+    }
+
 public:
 
+    // the ID is used in the sets of definitions (RDNodesSet)
     RDNode(RDNodeType t = RDNodeType::NONE)
-    : SubgraphNode<RDNode>(0), type(t), dfsid(0) {}
+    : SubgraphNode<RDNode>(RDNodesRegistry::get().add(this)),
+      type(t), dfsid(0) {}
+
+    ~RDNode() { RDNodesRegistry::get().remove(getID()); }
+
+    // the copy would have the ID of this node
+    RDNode(const RDNode&) = delete;
+    RDNode& operator=(const RDNode&) = delete;
 
     // this is the gro of this node, so make it public
     DefSiteSetT defs;
@@ -183,11 +230,22 @@ public:
         return overwrites.find(ds) != overwrites.end();
     }
 
-    const RDMap& getReachingDefinitions() const { return def_map; }
-    RDMap& getReachingDefinitions() { return def_map; }
+    // computing the definitions on demand does not change
+    // the result of the analysis, thus the const_cast
+    const RDMap& getReachingDefinitions() const {
+        const_cast<RDNode *>(this)->materialize();
+        return def_map;
+    }
+
+    RDMap& getReachingDefinitions() {
+        materialize();
+        return def_map;
+    }
+
     size_t getReachingDefinitions(RDNode *n, const Offset& off,
                                   const Offset& len, std::set<RDNode *>& ret)
     {
+        materialize();
         return def_map.get(n, off, len, ret);
     }
 
@@ -235,9 +293,35 @@ public:
     }
 
     friend class ReachingDefinitionsAnalysis;
+    friend struct RDNodesChain;
     friend class dg::analysis::rd::srg::AssignmentFinder;
 };
 
+struct ReachingDefinitionsStatistics : public AnalysisStatistics {
+    ReachingDefinitionsStatistics()
+        : AnalysisStatistics(), blocksNum(0), changedBlocks(0),
+          mergesNum(0), iterationsNum(0), groupsNum(0) {}
+
+    // the number of blocks (see RDNodesChain)
+    uint64_t blocksNum;
+    // how many times processing a block changed its definitions
+    uint64_t changedBlocks;
+    // how many maps of predecessors were merged
+    uint64_t mergesNum;
+    // the number of passes over the blocks in the reverse postorder
+    // (every return to an earlier block starts a new pass)
+    uint64_t iterationsNum;
+    // the number of groups of variables whose parts of the sparse graph
+    // were built in parallel (0 if the graph was built sequentially)
+    uint64_t groupsNum;
+
+    uint64_t getBlocksNum() const { return blocksNum; }
+    uint64_t getChangedBlocks() const { return changedBlocks; }
+    uint64_t getMergesNum() const { return mergesNum; }
+    uint64_t getIterationsNum() const { return iterationsNum; }
+    uint64_t getGroupsNum() const { return groupsNum; }
+};
+
 class ReachingDefinitionsAnalysis
 {
 protected:
@@ -245,6 +329,7 @@ protected:
     unsigned int dfsnum;
 
     const ReachingDefinitionsAnalysisOptions options;
+    ReachingDefinitionsStatistics statistics;
 
 public:
     ReachingDefinitionsAnalysis(RDNode *r,
@@ -330,9 +415,20 @@ public:
     }
 
 
+    // get the nodes reachable from the root in the reverse postorder
+    std::vector<RDNode *> getNodesRPO();
+
+    // split the nodes (in the reverse postorder) into blocks
+    std::vector<std::shared_ptr<RDNodesChain>>
+    getBlocks(const std::vector<RDNode *>& nodes);
+
     RDNode *getRoot() const { return root; }
     void setRoot(RDNode *r) { root = r; }
 
+    const ReachingDefinitionsStatistics& getStatistics() const {
+        return statistics;
+    }
+
     bool processNode(RDNode *n);
     virtual void run();
 };
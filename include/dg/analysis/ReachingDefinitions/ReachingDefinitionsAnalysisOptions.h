@@ -26,6 +26,12 @@ struct ReachingDefinitionsAnalysisOptions : AnalysisOptions {
     // or just objects?
     bool fieldInsensitive{false};
 
+    // The number of threads that build the graph of the sparse analysis.
+    // The variables are split among the threads, every thread
+    // builds the part of the graph for its variables and the parts
+    // are merged at the end. Programs that read unknown memory
+    // are always built by one thread.
+    unsigned threads{1};
 
     ReachingDefinitionsAnalysisOptions& setStrongUpdateUnknown(bool b) {
         strongUpdateUnknown = b; return *this;
@@ -46,6 +52,10 @@ struct ReachingDefinitionsAnalysisOptions : AnalysisOptions {
     ReachingDefinitionsAnalysisOptions& setFieldInsensitive(bool b) {
         fieldInsensitive = b; return *this;
     }
+
+    ReachingDefinitionsAnalysisOptions& setThreads(unsigned n) {
+        threads = n; return *this;
+    }
 };
 
 } // namespace analysis
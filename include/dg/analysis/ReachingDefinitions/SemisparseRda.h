@@ -1,9 +1,8 @@
 #ifndef _DG_SEMISPARSERDA_H_
 #define _DG_SEMISPARSERDA_H_
 
+#include <memory>
 #include <vector>
-#include <queue>
-#include <unordered_set>
 
 #include "dg/analysis/ReachingDefinitions/ReachingDefinitions.h"
 
@@ -13,26 +12,7 @@ namespace rd {
 
 class SemisparseRda : public ReachingDefinitionsAnalysis
 {
-    bool merge_maps(RDNode *source, RDNode *dest, DefSite& var) {
-        bool changed = false;
-
-        if (source->getType() != RDNodeType::PHI)
-            changed |= dest->def_map.add(var, source);
-
-        for (auto& pair : source->def_map) {
-            const DefSite& ds = pair.first;
-            auto& nodes = pair.second;
-
-            if (ds.target == var.target || ds.target == UNKNOWN_MEMORY|| var.target == UNKNOWN_MEMORY) {
-                for (RDNode *node : nodes) {
-                    if (node->getType() != RDNodeType::PHI)
-                        changed |= dest->def_map.add(ds, node);
-                }
-            }
-        }
-        return changed;
-    }
-
+    // the PHI nodes created by the builder of the sparse graph
     std::vector<std::unique_ptr<RDNode>> phi_nodes;
 
 public:
@@ -1,6 +1,11 @@
 #ifndef _DG_SCC_H_
 #define  _DG_SCC_H_
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <unordered_set>
 #include <vector>
 #include <set>
 
@@ -25,7 +30,7 @@ public:
     // contains the nodes that for a SCC
     SCC_t& compute(NodeT *start)
     {
-        assert(start->dfs_id == 0);
+        assert(dfs_id.empty() || getDfsId(start) == 0);
 
         _compute(start);
         assert(stack.empty());
@@ -52,33 +57,48 @@ private:
     // container for the strongly connected components.
     SCC_t scc;
 
+    // the state of the nodes during the computation, indexed by
+    // the IDs of the nodes (so that we do not need to keep
+    // it in every node)
+    std::vector<unsigned> dfs_id;
+    std::vector<unsigned> lowpt;
+    std::vector<bool> on_stack;
+
+    unsigned getDfsId(NodeT *n) const {
+        return n->getID() < dfs_id.size() ? dfs_id[n->getID()] : 0;
+    }
+
     void _compute(NodeT *n)
     {
-        // here we using the fact that we are a friend class
-        // of SubgraphNode. If we would need to make this
-        // algorithm more generinc, we add setters/getters.
-        n->dfs_id = n->lowpt = ++index;
+        unsigned id = n->getID();
+        if (id >= dfs_id.size()) {
+            dfs_id.resize(id + 1);
+            lowpt.resize(id + 1);
+            on_stack.resize(id + 1);
+        }
+
+        dfs_id[id] = lowpt[id] = ++index;
         stack.push(n);
-        n->on_stack = true;
+        on_stack[id] = true;
 
         for (NodeT *succ : n->getSuccessors()) {
-            if (succ->dfs_id == 0) {
-                assert(!succ->on_stack);
+            unsigned sid = succ->getID();
+            if (getDfsId(succ) == 0) {
                 _compute(succ);
-                n->lowpt = std::min(n->lowpt, succ->lowpt);
-            } else if (succ->on_stack) {
-                n->lowpt = std::min(n->lowpt, succ->dfs_id);
+                lowpt[id] = std::min(lowpt[id], lowpt[sid]);
+            } else if (on_stack[sid]) {
+                lowpt[id] = std::min(lowpt[id], dfs_id[sid]);
             }
         }
 
-        if (n->lowpt == n->dfs_id) {
+        if (lowpt[id] == dfs_id[id]) {
             SCC_component_t component;
             size_t component_num = scc.size();
 
             NodeT *w;
-            while (stack.top()->dfs_id >= n->dfs_id) {
+            while (dfs_id[stack.top()->getID()] >= dfs_id[id]) {
                 w = stack.pop();
-                w->on_stack = false;
+                on_stack[w->getID()] = false;
                 component.push_back(w);
                 // the numbers scc_id give
                 // a reverse topological order
@@ -169,6 +189,353 @@ public:
     }
 };
 
+///
+// Strongly connected components of a graph that grows during its use
+// (e.g. the calls via function pointers are inserted into the graph).
+// The components are computed by Tarjan's algorithm at first. Then update()
+// adds the new nodes and edges: the components are kept in a topological
+// order (getOrder()) and an edge that goes against the order is fixed
+// by the algorithm of Pearce and Kelly -- it reorders (or merges into
+// one component) only the components whose order lies between the ends
+// of the edge and that are connected to them. A new node is placed
+// right after its predecessor, the numbers of the order have gaps for that
+// (and are renumbered when a gap is used up).
+// The removed edges are not taken into account, so the components
+// may be bigger than the real ones after removing edges.
+template <typename NodeT>
+class IncrementalSCC {
+public:
+    using SCC_t = typename SCC<NodeT>::SCC_t;
+
+private:
+    static const uint64_t ORDER_GAP = 1ULL << 32;
+    static const uint64_t NO_ORDER = ~static_cast<uint64_t>(0);
+
+    SCC_t scc;
+    // the topological order of every component (NO_ORDER if the
+    // component was merged into another one) and the components
+    // sorted by the order
+    std::vector<uint64_t> position;
+    std::map<uint64_t, unsigned> order;
+    // is the node (indexed by ID) in some component?
+    std::vector<bool> inComponent;
+    // the components that got more nodes in the last update
+    std::vector<unsigned> merged;
+
+    // the marks of the searches of insertEdge()
+    std::vector<unsigned> markF;
+    std::vector<unsigned> markB;
+    unsigned mark{0};
+
+    void setPosition(unsigned comp, uint64_t pos) {
+        position[comp] = pos;
+        order.emplace(pos, comp);
+    }
+
+    void relabel() {
+        std::map<uint64_t, unsigned> tmp;
+        uint64_t pos = 0;
+        for (const auto& it : order) {
+            pos += ORDER_GAP;
+            position[it.second] = pos;
+            tmp.emplace_hint(tmp.end(), pos, it.second);
+        }
+        order.swap(tmp);
+    }
+
+    // a free number of the order right after the component
+    uint64_t positionAfter(unsigned comp) {
+        while (true) {
+            uint64_t a = position[comp];
+            auto it = order.upper_bound(a);
+            if (it == order.end())
+                return a + ORDER_GAP;
+
+            uint64_t b = it->first;
+            // stay close to 'a', there may come more nodes after this one
+            if (b - a >= 64)
+                return a + (b - a) / 32;
+            if (b - a >= 2)
+                return a + 1;
+
+            relabel();
+        }
+    }
+
+    void markComponent(NodeT *n, unsigned comp) {
+        unsigned id = n->getID();
+        if (id >= inComponent.size())
+            inComponent.resize(id + 1, false);
+        inComponent[id] = true;
+        n->scc_id = comp;
+    }
+
+    template <typename Cont>
+    void sortByOrder(Cont& comps) const {
+        std::sort(comps.begin(), comps.end(),
+                  [this](unsigned a, unsigned b) {
+                      return position[a] < position[b];
+                  });
+    }
+
+    // merge the components into the biggest one of them
+    unsigned mergeComponents(const std::vector<unsigned>& comps) {
+        unsigned rep = comps[0];
+        for (unsigned c : comps) {
+            if (scc[c].size() > scc[rep].size())
+                rep = c;
+        }
+
+        for (unsigned c : comps) {
+            if (c == rep)
+                continue;
+
+            for (NodeT *n : scc[c]) {
+                n->scc_id = rep;
+                scc[rep].push_back(n);
+            }
+
+            scc[c].clear();
+            position[c] = NO_ORDER;
+        }
+
+        merged.push_back(rep);
+        return rep;
+    }
+
+    // fix the order (and the components) after adding an edge
+    // from a node of the component 'x' to a node of the component 'y'
+    void insertEdge(unsigned x, unsigned y) {
+        if (x == y || position[x] < position[y])
+            return;
+
+        uint64_t lb = position[y];
+        uint64_t ub = position[x];
+
+        markF.resize(scc.size(), 0);
+        markB.resize(scc.size(), 0);
+        ++mark;
+
+        // the components reachable from 'y' that are not
+        // after 'x' in the order (they must go after 'x' now)
+        std::vector<unsigned> fwd, stack{y};
+        bool cycle = false;
+        markF[y] = mark;
+        while (!stack.empty()) {
+            unsigned cur = stack.back();
+            stack.pop_back();
+            fwd.push_back(cur);
+
+            for (NodeT *n : scc[cur]) {
+                for (NodeT *succ : n->getSuccessors()) {
+                    if (!hasComponent(succ))
+                        continue;
+
+                    unsigned c = succ->scc_id;
+                    if (c == x) {
+                        cycle = true;
+                        continue;
+                    }
+
+                    if (markF[c] != mark && position[c] < ub) {
+                        markF[c] = mark;
+                        stack.push_back(c);
+                    }
+                }
+            }
+        }
+
+        // the components that reach 'x' and are not before 'y'
+        std::vector<unsigned> bwd;
+        stack.push_back(x);
+        markB[x] = mark;
+        while (!stack.empty()) {
+            unsigned cur = stack.back();
+            stack.pop_back();
+            bwd.push_back(cur);
+
+            for (NodeT *n : scc[cur]) {
+                for (NodeT *pred : n->getPredecessors()) {
+                    if (!hasComponent(pred))
+                        continue;
+
+                    unsigned c = pred->scc_id;
+                    if (markB[c] != mark && position[c] >= lb) {
+                        markB[c] = mark;
+                        stack.push_back(c);
+                    }
+                }
+            }
+        }
+
+        // the numbers of the order that we have for the components
+        std::vector<uint64_t> pool;
+        pool.reserve(fwd.size() + bwd.size());
+        for (unsigned c : bwd)
+            pool.push_back(position[c]);
+        for (unsigned c : fwd) {
+            if (markB[c] != mark)
+                pool.push_back(position[c]);
+        }
+        std::sort(pool.begin(), pool.end());
+        for (uint64_t pos : pool)
+            order.erase(pos);
+
+        if (!cycle) {
+            // the components that reach 'x' go before
+            // the components reachable from 'y'
+            sortByOrder(bwd);
+            sortByOrder(fwd);
+            size_t i = 0;
+            for (unsigned c : bwd)
+                setPosition(c, pool[i++]);
+            for (unsigned c : fwd)
+                setPosition(c, pool[i++]);
+            return;
+        }
+
+        // the components on a cycle with the new edge
+        // are the components in both sets
+        std::vector<unsigned> onCycle{x}, before, after;
+        for (unsigned c : bwd) {
+            if (c != x && markF[c] == mark)
+                onCycle.push_back(c);
+            else if (c != x)
+                before.push_back(c);
+        }
+        for (unsigned c : fwd) {
+            if (markB[c] != mark)
+                after.push_back(c);
+        }
+
+        sortByOrder(before);
+        sortByOrder(after);
+        unsigned rep = mergeComponents(onCycle);
+
+        size_t i = 0;
+        for (unsigned c : before)
+            setPosition(c, pool[i++]);
+        setPosition(rep, pool[i]);
+        i = pool.size() - after.size();
+        for (unsigned c : after)
+            setPosition(c, pool[i++]);
+    }
+
+    // add a node (that has a predecessor in some component)
+    // and its edges to the nodes that are in components
+    void insertNode(NodeT *n) {
+        unsigned pred = 0;
+        bool hasPred = false;
+        for (NodeT *p : n->getPredecessors()) {
+            if (hasComponent(p) &&
+                (!hasPred || position[p->scc_id] > position[pred])) {
+                pred = p->scc_id;
+                hasPred = true;
+            }
+        }
+        assert(hasPred && "The node is not reachable");
+
+        unsigned comp = scc.size();
+        scc.push_back({n});
+        position.push_back(NO_ORDER);
+        setPosition(comp, positionAfter(pred));
+        markComponent(n, comp);
+
+        for (NodeT *succ : n->getSuccessors()) {
+            if (hasComponent(succ))
+                insertEdge(n->scc_id, succ->scc_id);
+        }
+    }
+
+public:
+    // compute the components of the nodes reachable from the root
+    void compute(NodeT *root) {
+        SCC<NodeT> tarjan;
+        scc = std::move(tarjan.compute(root));
+
+        order.clear();
+        position.assign(scc.size(), NO_ORDER);
+        inComponent.clear();
+        markF.clear();
+        markB.clear();
+        merged.clear();
+
+        // Tarjan's algorithm gives the components in reverse topological order
+        for (unsigned i = 0; i < scc.size(); ++i) {
+            setPosition(i, (scc.size() - i) * ORDER_GAP);
+            for (NodeT *n : scc[i])
+                markComponent(n, i);
+        }
+    }
+
+    // Add the nodes that became reachable after the graph has changed
+    // to the components. Every new edge must have a new node ('nodes')
+    // as one of its ends. Returns the nodes added to the components
+    // (the new nodes reachable from the old ones and the old nodes
+    // that were not reachable before).
+    std::vector<NodeT *> update(const std::vector<NodeT *>& nodes) {
+        merged.clear();
+
+        // add the nodes in BFS order, so that every node
+        // has a predecessor in some component when it is added
+        std::vector<NodeT *> added;
+        ADT::QueueFIFO<NodeT *> fifo;
+        std::unordered_set<const NodeT *> queued;
+        auto push = [&](NodeT *n) {
+            if (!hasComponent(n) && queued.insert(n).second)
+                fifo.push(n);
+        };
+
+        for (NodeT *n : nodes) {
+            for (NodeT *pred : n->getPredecessors()) {
+                if (hasComponent(pred)) {
+                    push(n);
+                    break;
+                }
+            }
+        }
+
+        while (!fifo.empty()) {
+            NodeT *cur = fifo.pop();
+            insertNode(cur);
+            added.push_back(cur);
+            for (NodeT *succ : cur->getSuccessors())
+                push(succ);
+        }
+
+        // the merged components may have been merged again
+        std::sort(merged.begin(), merged.end());
+        merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+        merged.erase(std::remove_if(merged.begin(), merged.end(),
+                                    [this](unsigned c) { return scc[c].empty(); }),
+                     merged.end());
+
+        return added;
+    }
+
+    bool hasComponent(const NodeT *n) const {
+        return n->getID() < inComponent.size() && inComponent[n->getID()];
+    }
+
+    // the position of the component of the node in the topological order
+    // (the components that go first have lower numbers)
+    uint64_t getOrder(const NodeT *n) const {
+        assert(hasComponent(n));
+        return position[n->scc_id];
+    }
+
+    // the components (some of them may be empty after merging)
+    const SCC_t& getSCCs() const { return scc; }
+
+    // the components that got new nodes by merging in the last update()
+    const std::vector<unsigned>& getMerged() const { return merged; }
+};
+
+template <typename NodeT>
+const uint64_t IncrementalSCC<NodeT>::ORDER_GAP;
+template <typename NodeT>
+const uint64_t IncrementalSCC<NodeT>::NO_ORDER;
+
 } // analysis
 } // dg
 #endif //  _DG_SCC_H_
@@ -4,6 +4,8 @@
 // This file defines a basis for nodes from
 // PointerSubgraph and reaching definitions subgraph.
 
+#include <algorithm>
+#include <cassert>
 #include <vector>
 
 namespace dg {
@@ -48,14 +50,8 @@ protected:
     size_t size{0};
 
 public:
-    // FIXME: get rid of these things
-    unsigned int dfs_id{0};
-    unsigned int lowpt{0};
-
     // id of scc component
     unsigned int scc_id{0};
-    // true if the node is on stack
-    bool on_stack{false};
 
     SubgraphNode(unsigned id)
     : id(id) {}
@@ -119,6 +115,14 @@ public:
         return operands.size();
     }
 
+    // remove all operands of this node (and this node
+    // from the users of the operands)
+    void removeAllOperands() {
+        for (NodeT *op : operands)
+            op->removeUser(static_cast<NodeT *>(this));
+        operands.clear();
+    }
+
     bool hasOperand(NodeT *n) const {
         for (NodeT *x : operands) {
             if (x == n) {
@@ -163,6 +167,20 @@ public:
         addSuccessor(succ);
     }
 
+    // remove the edge to the successor 'succ'
+    void removeSuccessor(NodeT *succ) {
+        assert(succ && "Passed nullptr as the successor");
+        auto it = std::find(successors.begin(), successors.end(), succ);
+        assert(it != successors.end() && "Not a successor");
+        successors.erase(it);
+
+        auto pit = std::find(succ->predecessors.begin(),
+                             succ->predecessors.end(),
+                             static_cast<NodeT *>(this));
+        assert(pit != succ->predecessors.end() && "Inconsistent edges");
+        succ->predecessors.erase(pit);
+    }
+
     // get the successor when we know there's only one of them
     NodeT *getSingleSuccessor() const {
         assert(successors.size() == 1);
@@ -358,6 +376,15 @@ private:
 
         users.push_back(nd);
     }
+
+    void removeUser(NodeT *nd) {
+        for (auto it = users.begin(); it != users.end(); ++it) {
+            if (*it == nd) {
+                users.erase(it);
+                return;
+            }
+        }
+    }
 };
 
 } // analysis
@@ -32,6 +32,8 @@
 #include "dg/analysis/PointsTo/PointerAnalysisFI.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFS.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFSInv.h"
+#include "dg/analysis/PointsTo/PointerAnalysisSFS.h"
+#include "dg/analysis/PointsTo/PointerAnalysisDemand.h"
 #include "dg/analysis/PointsTo/Pointer.h"
 #include "dg/analysis/Offset.h"
 
@@ -74,6 +76,10 @@ class LLVMDependenceGraphBuilder {
             _PTA->run<analysis::pta::PointerAnalysisFI>();
         else if (_options.PTAOptions.isFSInv())
             _PTA->run<analysis::pta::PointerAnalysisFSInv>();
+        else if (_options.PTAOptions.isSFS())
+            _PTA->run<analysis::pta::PointerAnalysisSFS>();
+        else if (_options.PTAOptions.isDemand())
+            _PTA->run<analysis::pta::PointerAnalysisDemand>();
         else {
             assert(0 && "Wrong pointer analysis");
             abort();
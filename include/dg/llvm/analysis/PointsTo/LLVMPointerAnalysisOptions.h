@@ -1,6 +1,8 @@
 #ifndef _DG_LLVM_POINTER_ANALYSIS_OPTIONS_H_
 #define _DG_LLVM_POINTER_ANALYSIS_OPTIONS_H_
 
+#include <string>
+
 #include "dg/llvm/analysis/LLVMAnalysisOptions.h"
 #include "dg/analysis/PointsTo/PointerAnalysisOptions.h"
 
@@ -9,11 +11,48 @@ namespace analysis {
 
 struct LLVMPointerAnalysisOptions : public LLVMAnalysisOptions, PointerAnalysisOptions
 {
-    enum class AnalysisType { fi, fs, inv } analysisType{AnalysisType::fi};
+    enum class AnalysisType { fi, fs, inv, sfs, demand } analysisType{AnalysisType::fi};
+
+    // Remove the nodes that are equivalent to other nodes
+    // from the built subgraph before running the analysis
+    // (see PointerSubgraphOptimizer)
+    bool optimizeSubgraph{false};
+
+    // The directory where the solved points-to sets are stored.
+    // The next runs on the same module with the same options reuse them
+    // instead of running the analysis (empty means no caching,
+    // see PointsToCache)
+    std::string cacheDirectory{};
+
+    // Cloning of functions for their call sites (a limited context
+    // sensitivity): the subgraph of a function is cloned for every call
+    // site of the function if the function calls other functions nested
+    // at most 'cloneDepth - 1' levels deep (0 means no cloning,
+    // 1 clones only the functions that call no other functions).
+    // The clones of the callers contain the clones of the callees,
+    // so the called functions get the contexts of up to 'cloneDepth'
+    // call sites. Note that this is not a k-call-site sensitivity:
+    // a function that calls deeper nested functions is not cloned at all.
+    // Only the functions that are called directly and that call
+    // only the functions that are not shared with other functions
+    // can be cloned. Not used with the demand-driven analysis.
+    // The values of the cloned functions get the union of the points-to
+    // sets from all the contexts (there is only one llvm::Value for them).
+    // Only the copies of heap allocations stay apart in the results:
+    // the reaching definitions give each of them its own memory object.
+    unsigned cloneDepth{0};
+    // clone the functions that return memory allocated on the heap
+    // (allocation wrappers) regardless of 'cloneDepth'
+    bool cloneAllocWrappers{false};
+    // the maximal number of nodes created by cloning
+    // (0 means the number of nodes of the graph before cloning)
+    size_t cloningBudget{0};
 
     bool isFS() const { return analysisType == AnalysisType::fs; }
     bool isFSInv() const { return analysisType == AnalysisType::inv; }
     bool isFI() const { return analysisType == AnalysisType::fi; }
+    bool isSFS() const { return analysisType == AnalysisType::sfs; }
+    bool isDemand() const { return analysisType == AnalysisType::demand; }
 };
 
 } // namespace analysis
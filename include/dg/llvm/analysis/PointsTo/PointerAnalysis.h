@@ -20,10 +20,18 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
 #include "dg/analysis/PointsTo/PointerSubgraph.h"
 #include "dg/analysis/PointsTo/PointerAnalysis.h"
 #include "dg/analysis/PointsTo/PointerSubgraphOptimizations.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFI.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFSInv.h"
+#include "dg/analysis/PointsTo/PointerAnalysisSFS.h"
+#include "dg/analysis/PointsTo/PointerAnalysisDemand.h"
+#include "dg/analysis/PointsTo/PointsToCache.h"
 
 #include "dg/llvm/analysis/PointsTo/LLVMPointerAnalysisOptions.h"
 #include "dg/llvm/analysis/PointsTo/PointerSubgraph.h"
@@ -47,6 +55,10 @@ public:
     LLVMPointerAnalysisImpl(PointerSubgraph *PS, LLVMPointerSubgraphBuilder *b)
     : PTType(PS), builder(b) {}
 
+    LLVMPointerAnalysisImpl(PointerSubgraph *PS, LLVMPointerSubgraphBuilder *b,
+                            const LLVMPointerAnalysisOptions& opts)
+    : PTType(PS, opts), builder(b) {}
+
     // build new subgraphs on calls via pointer
     bool functionPointerCall(PSNode *callsite, PSNode *called) override
     {
@@ -66,11 +78,14 @@ public:
         if (!LLVMPointerSubgraphBuilder::callIsCompatible(callsite, called))
             return false;
 
+#ifndef NDEBUG
+        size_t firstNew = builder->getPS()->size();
+#endif // NDEBUG
         builder->insertFunctionCall(callsite, called);
 
 #ifndef NDEBUG
-        // check the graph after rebuilding
-        if (!builder->validateSubgraph()) {
+        // check the part of the graph that we have just built
+        if (!builder->validateSubgraph(firstNew)) {
             llvm::errs() << "Pointer Subgraph is broken!\n";
             llvm::errs() << "This happend after building this function called via pointer: "
                          <<  F->getName() << "\n";
@@ -84,8 +99,16 @@ public:
 
 class LLVMPointerAnalysis
 {
+    const llvm::Module *_module;
     PointerSubgraph *PS = nullptr;
     std::unique_ptr<LLVMPointerSubgraphBuilder> _builder;
+    LLVMPointerAnalysisOptions _options;
+    // the demand-driven analysis computes the points-to sets
+    // when they are asked for, so it must live as long as we do
+    std::unique_ptr<LLVMPointerAnalysisImpl<analysis::pta::PointerAnalysisDemand>> _demandPTA;
+
+    // the key of the cache (computed when it is needed the first time)
+    uint64_t _cacheKey{0};
 
     LLVMPointerAnalysisOptions createOptions(const char *entry_func,
                                              uint64_t field_sensitivity)
@@ -104,11 +127,18 @@ public:
         : LLVMPointerAnalysis(m, createOptions(entry_func, field_sensitivity)) {}
 
     LLVMPointerAnalysis(const llvm::Module *m, const LLVMPointerAnalysisOptions opts)
-        : _builder(new LLVMPointerSubgraphBuilder(m, opts)) {}
+        : _module(m), _builder(new LLVMPointerSubgraphBuilder(m, opts)),
+          _options(opts) {}
 
     PSNode *getPointsTo(const llvm::Value *val)
     {
-        return _builder->getPointsTo(val);
+        PSNode *node = _builder->getPointsTo(val);
+        // if the demand-driven analysis could not compute the points-to
+        // set within the budget, the pointer may point anywhere
+        if (node && _demandPTA && !_demandPTA->query(node))
+            return analysis::pta::UNKNOWN_MEMORY;
+
+        return node;
     }
 
     const std::unordered_map<const llvm::Value *, PSNodesSeq>&
@@ -117,7 +147,7 @@ public:
         return _builder->getNodesMap();
     }
 
-    const std::vector<std::unique_ptr<PSNode>>& getNodes()
+    const PointerSubgraph::NodesT& getNodes()
     {
         return PS->getNodes();
     }
@@ -126,6 +156,13 @@ public:
         return _builder->getFunctionNodes(F);
     }
 
+    const LLVMPointerSubgraphBuilder::CloningStatistics&
+    getCloningStatistics() const {
+        return _builder->getCloningStatistics();
+    }
+
+    bool isClone(const PSNode *n) const { return _builder->isClone(n); }
+
     PointerSubgraph *getPS() { return PS; }
     const PointerSubgraph *getPS() const { return PS; }
 
@@ -139,10 +176,30 @@ public:
             llvm::errs() << "Pointer Subgraph was not built, aborting\n";
             abort();
         }
+    }
+
+    // @mergeLoads  is the analysis flow-insensitive? (see PSValueNumbering)
+    void optimizeSubgraph(bool mergeLoads)
+    {
+        // The builder adds operands to the nodes of the graph
+        // (e.g. to the arguments of functions) when the analysis
+        // resolves a call via a function pointer, so it must keep
+        // all the nodes it created
+        for (const auto& nd : PS->getNodes()) {
+            if (nd && nd->getType() == analysis::pta::PSNodeType::CALL_FUNCPTR) {
+                llvm::errs() << "Not optimizing PS, it has calls via function pointers\n";
+                return;
+            }
+        }
 
-/*
         analysis::pta::PointerSubgraphOptimizer optimizer(PS);
-        optimizer.run();
+        // NOOP nodes are kept, they are returns of the subgraphs in the builder
+        optimizer.removeEquivalentNodes();
+        optimizer.removeEquivalentValues(mergeLoads);
+        optimizer.removeUnknowns();
+        // the optimizations may have created
+        // the same operands in a phi nodes
+        optimizer.removeEquivalentNodes();
 
         if (optimizer.getNumOfRemovedNodes() > 0)
             _builder->composeMapping(std::move(optimizer.getMapping()));
@@ -150,40 +207,131 @@ public:
         llvm::errs() << "PS optimization removed " << optimizer.getNumOfRemovedNodes() << " nodes\n";
 
 #ifndef NDEBUG
-        analysis::pta::debug::LLVMPointerSubgraphValidator validator(_builder->getPS());
-        if (validator.validate()) {
+        if (!_builder->validateSubgraph()) {
             llvm::errs() << "Pointer Subgraph is broken!\n";
-            llvm::errs() << "This happend after optimizing the graph.";
-            assert(!validator.getErrors().empty());
-            llvm::errs() << validator.getErrors();
+            llvm::errs() << "This happend after optimizing the graph.\n";
             abort();
         }
 #endif // NDEBUG
-*/
+    }
+
+private:
+    std::string getCachePath()
+    {
+        if (_cacheKey == 0)
+            _cacheKey = _builder->getCacheKey();
 
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.pta",
+                 static_cast<unsigned long long>(_cacheKey));
+        return _options.cacheDirectory + "/" + name;
     }
 
+    // Take the points-to sets from the cache if it contains
+    // the results for the built graph. The calls via function pointers
+    // that the analysis inserted are inserted again first,
+    // so that the graph is the same as the graph that was solved.
+    // If the cache does not match the graph after the calls were
+    // inserted, the graph is built again ('invalidateNodes'
+    // and 'mergeLoads' are the flags the graph was built with),
+    // the analysis would insert the calls once more otherwise.
+    bool loadCache(bool mergeLoads, bool invalidateNodes = false)
+    {
+        if (_options.cacheDirectory.empty())
+            return false;
+
+        std::string path = getCachePath();
+        analysis::pta::PointsToCache cache;
+        if (!cache.open(path, _cacheKey))
+            return false;
+
+        if (!cache.matchesBeforeCalls(*PS)) {
+            llvm::errs() << "Points-to cache does not match the graph\n";
+            return false;
+        }
+
+        const auto calls = cache.getCalls();
+        for (const auto& call : calls) {
+            const auto& nodes = PS->getNodes();
+            _builder->insertFunctionCall(nodes[call.first].get(),
+                                         nodes[call.second].get());
+        }
+
+        if (!cache.restore(*PS)) {
+            llvm::errs() << "Points-to cache does not match the graph\n";
+            if (!calls.empty()) {
+                _builder.reset(new LLVMPointerSubgraphBuilder(_module, _options));
+                _builder->setInvalidateNodesFlag(invalidateNodes);
+                buildSubgraph();
+                if (_options.optimizeSubgraph)
+                    optimizeSubgraph(mergeLoads);
+            }
+
+            return false;
+        }
+
+        return true;
+    }
+
+    void saveCache()
+    {
+        if (_options.cacheDirectory.empty())
+            return;
+
+        std::string path = getCachePath();
+        if (!analysis::pta::PointsToCache::save(path, _cacheKey, *PS,
+                                               _builder->getInsertedCalls()))
+            llvm::errs() << "Failed storing the points-to cache into "
+                         << path << "\n";
+    }
+
+public:
     template <typename PTType>
     void run()
     {
         buildSubgraph();
+        if (_options.optimizeSubgraph)
+            optimizeSubgraph(std::is_base_of<analysis::pta::PointerAnalysisFI, PTType>::value);
+
+        if (loadCache(std::is_base_of<analysis::pta::PointerAnalysisFI, PTType>::value))
+            return;
 
-        LLVMPointerAnalysisImpl<PTType> PTA(PS, _builder.get());
+        LLVMPointerAnalysisImpl<PTType> PTA(PS, _builder.get(), _options);
         PTA.run();
+        _builder->mergeClones();
+        saveCache();
     }
 
     // this method creates PointerAnalysis object and returns it.
     // It is alternative to run() method, but it does not delete all
     // the analysis data as the run() (like memory objects and so on).
-    // run() preserves only PointerSubgraph and the builder
+    // run() preserves only PointerSubgraph and the builder.
+    // The points-to sets of the cloned functions are not merged
+    // into the original nodes then (see LLVMPointerSubgraphBuilder::mergeClones)
     template <typename PTType>
     analysis::pta::PointerAnalysis *createPTA()
     {
         buildSubgraph();
-        return new LLVMPointerAnalysisImpl<PTType>(PS, _builder.get());
+        if (_options.optimizeSubgraph)
+            optimizeSubgraph(std::is_base_of<analysis::pta::PointerAnalysisFI, PTType>::value);
+
+        return new LLVMPointerAnalysisImpl<PTType>(PS, _builder.get(), _options);
     }
 };
 
+template <>
+inline void LLVMPointerAnalysis::run<analysis::pta::PointerAnalysisDemand>()
+{
+    buildSubgraph();
+    if (_options.optimizeSubgraph)
+        optimizeSubgraph(true);
+
+    // nothing is computed here, the points-to sets
+    // are computed in getPointsTo()
+    _demandPTA.reset(new LLVMPointerAnalysisImpl<analysis::pta::PointerAnalysisDemand>(
+                        PS, _builder.get(), _options));
+}
+
 template <>
 inline void LLVMPointerAnalysis::run<analysis::pta::PointerAnalysisFSInv>()
 {
@@ -191,9 +339,16 @@ inline void LLVMPointerAnalysis::run<analysis::pta::PointerAnalysisFSInv>()
     assert(_builder && "Incorrectly constructed PTA, missing builder");
     _builder->setInvalidateNodesFlag(true);
     buildSubgraph();
+    if (_options.optimizeSubgraph)
+        optimizeSubgraph(false);
+
+    if (loadCache(false, true /* invalidate nodes */))
+        return;
 
-    LLVMPointerAnalysisImpl<analysis::pta::PointerAnalysisFSInv> PTA(PS, _builder.get());
+    LLVMPointerAnalysisImpl<analysis::pta::PointerAnalysisFSInv> PTA(PS, _builder.get(), _options);
     PTA.run();
+    _builder->mergeClones();
+    saveCache();
 }
 
 template <>
@@ -203,8 +358,11 @@ inline analysis::pta::PointerAnalysis *LLVMPointerAnalysis::createPTA<analysis::
     assert(_builder && "Incorrectly constructed PTA, missing builder");
     _builder->setInvalidateNodesFlag(true);
     buildSubgraph();
+    if (_options.optimizeSubgraph)
+        optimizeSubgraph(false);
 
-    return new LLVMPointerAnalysisImpl<analysis::pta::PointerAnalysisFSInv>(PS, _builder.get());
+    return new LLVMPointerAnalysisImpl<analysis::pta::PointerAnalysisFSInv>(PS, _builder.get(),
+                                                                            _options);
 }
 
 } // namespace dg
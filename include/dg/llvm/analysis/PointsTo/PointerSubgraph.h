@@ -2,6 +2,7 @@
 #define _LLVM_DG_POINTER_SUBGRAPH_H_
 
 #include <unordered_map>
+#include <unordered_set>
 
 // ignore unused parameters in LLVM libraries
 #if (__clang__)
@@ -112,6 +113,40 @@ class LLVMPointerSubgraphBuilder
     // connected together according to successors
     std::map<const llvm::BasicBlock *, PSNodesSeq> built_blocks;
 
+    // the calls via pointers inserted into the graph
+    // (the IDs of the callsite and of the called function), in order
+    std::vector<std::pair<unsigned, unsigned>> inserted_calls;
+
+public:
+    struct CloningStatistics {
+        // the number of the cloned functions and of the clones
+        size_t functions{0};
+        size_t clones{0};
+        // the size of the graph before and after cloning
+        size_t nodesBefore{0};
+        size_t nodesAfter{0};
+    };
+
+private:
+    CloningStatistics cloningStats;
+    // the nodes of the cloned functions (that represent some values)
+    // and their copies
+    std::vector<std::pair<PSNode *, PSNode *>> clonedNodes;
+    // the copies from clonedNodes (that were not merged with the originals)
+    std::unordered_set<const PSNode *> clones;
+    // the roots of the subgraphs (of functions or clones) that are called
+    // from one place only -> the root of the subgraph that calls them
+    std::unordered_map<const PSNode *, PSNode *> callerOf;
+
+    // clone the subgraphs of functions for their call sites
+    // (see LLVMPointerAnalysisOptions::cloneDepth)
+    void cloneFunctions();
+    bool getCloneableNodes(const Subgraph& subg,
+                           std::vector<PSNode *>& region,
+                           unsigned& depth, bool& allocates);
+    PSNode *cloneForCall(const llvm::Function *F, const Subgraph& subg,
+                         const std::vector<PSNode *>& region, PSNode *call);
+
 public:
     const PointerSubgraph *getPS() const { return &PS; }
 
@@ -123,6 +158,10 @@ public:
     PointerSubgraph *buildLLVMPointerSubgraph();
 
     bool validateSubgraph() const;
+    // validate only the nodes with the ID 'firstNew' and higher
+    // and the nodes that got new operands (after a call via a pointer
+    // was inserted into the graph)
+    bool validateSubgraph(size_t firstNew) const;
 
     PSNodesSeq
     createFuncptrCall(const llvm::CallInst *CInst,
@@ -135,6 +174,39 @@ public:
     // the return from the call nodes.
     void insertFunctionCall(PSNode *callsite, PSNode *called);
 
+    const std::vector<std::pair<unsigned, unsigned>>&
+    getInsertedCalls() const { return inserted_calls; }
+
+    const CloningStatistics& getCloningStatistics() const { return cloningStats; }
+
+    // Is the node a copy of a node from a cloned function? The copies
+    // of allocations are different memory objects than the originals,
+    // even though they have the same llvm::Value.
+    bool isClone(const PSNode *n) const { return clones.count(n) > 0; }
+
+    // The values from the cloned functions are represented by more nodes
+    // (the mapping gives the nodes of the original subgraph).
+    // Add the points-to sets of the copies to the original nodes,
+    // so that they contain the pointers from all the contexts
+    // (after the analysis finished).
+    void mergeClones() {
+        for (auto& it : clonedNodes) {
+            // the optimizations may have merged the copy with the original
+            // or replaced the nodes with the unknown memory
+            if (it.first == it.second || it.first == UNKNOWN_MEMORY)
+                continue;
+
+            if (it.second == UNKNOWN_MEMORY)
+                it.first->addPointsTo(UNKNOWN_MEMORY, Offset::UNKNOWN);
+            else
+                it.first->addPointsTo(it.second->pointsTo);
+        }
+    }
+
+    // a hash of the module and of the options that change the graph
+    // or the results of the analysis (the key of the PointsToCache)
+    uint64_t getCacheKey() const;
+
     // let the user get the nodes map, so that we can
     // map the points-to informatio back to LLVM nodes
     const std::unordered_map<const llvm::Value *, PSNodesSeq>&
@@ -161,6 +233,27 @@ public:
     }
 
     void composeMapping(PointsToMapping<PSNode *>&& rhs) {
+        // do not keep the removed nodes in the nodes map
+        for (auto& it : nodes_map) {
+            if (PSNode *n = rhs.get(it.second.first))
+                it.second.first = n;
+            if (PSNode *n = rhs.get(it.second.second))
+                it.second.second = n;
+        }
+
+        for (auto& it : clonedNodes) {
+            if (PSNode *n = rhs.get(it.first))
+                it.first = n;
+            if (PSNode *n = rhs.get(it.second))
+                it.second = n;
+        }
+
+        clones.clear();
+        for (auto& it : clonedNodes) {
+            if (it.first != it.second)
+                clones.insert(it.second);
+        }
+
         mapping.compose(std::move(rhs));
     }
 
@@ -83,6 +83,15 @@ public:
 
     RDNode *getRoot();
     RDNode *getNode(const llvm::Value *val);
+    // the node that represents the memory of the pointer target
+    // (the copies of heap allocations from cloned functions
+    // have their own nodes, see LLVMPointerAnalysisOptions::cloneAllocWrappers)
+    RDNode *getTargetNode(const analysis::pta::PSNode *target);
+
+    const ReachingDefinitionsStatistics& getStatistics() const {
+        assert(RDA);
+        return RDA->getStatistics();
+    }
 
     // let the user get the nodes map, so that we can
     // map the points-to informatio back to LLVM nodes
@@ -1,3 +1,11 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
 #include "dg/analysis/PointsTo/Pointer.h"
 #include "dg/analysis/PointsTo/PointsToSet.h"
 #include "dg/analysis/PointsTo/PointerSubgraph.h"
@@ -20,6 +28,28 @@ PSNode *INVALIDATED = &INVALIDATED_LOC;
 const Pointer PointerUnknown(UNKNOWN_MEMORY, Offset::UNKNOWN);
 const Pointer PointerNull(NULLPTR, 0);
 
+void releasePointsToSets()
+{
+    // the special nodes are not in any graph, so they keep their pointers
+    PSNode *special[] = {NULLPTR, UNKNOWN_MEMORY, INVALIDATED};
+    std::vector<std::vector<Pointer>> pointers;
+    for (PSNode *n : special) {
+        pointers.emplace_back();
+        for (const Pointer& ptr : n->pointsTo)
+            pointers.back().push_back(ptr);
+        n->pointsTo = PointsToSetT();
+    }
+
+    PointerIdMapping::get().clear();
+    PointsToSetsTable::get().clear();
+    BDDPointsToSet::clear();
+
+    for (size_t i = 0; i < pointers.size(); ++i) {
+        for (const Pointer& ptr : pointers[i])
+            special[i]->pointsTo.add(ptr);
+    }
+}
+
 // Return true if it makes sense to dereference this pointer.
 // PTA is over-approximation, so this is a filter.
 static inline bool canBeDereferenced(const Pointer& ptr)
@@ -42,91 +72,157 @@ bool PointerAnalysis::processLoad(PSNode *node)
     if (operand->pointsTo.empty())
         return error(operand, "Load's operand has no points-to set");
 
-    for (const Pointer& ptr : operand->pointsTo) {
-        if (ptr.isUnknown()) {
-            // load from unknown pointer yields unknown pointer
-            changed |= node->addPointsTo(UNKNOWN_MEMORY);
-            continue;
-        }
+    if (!options.diffPropagation || !isFlowInsensitive()) {
+        // the memory may have changed in any way,
+        // so we must load from all the pointers
+        if (options.diffPropagation)
+            consumePointers(node, 0);
+
+        for (const Pointer& ptr : operand->pointsTo)
+            changed |= processLoad(node, ptr);
+        return changed;
+    }
+
+    bool all = forEachNewPointer(node, 0, [&](const Pointer& ptr) {
+        changed |= processLoad(node, ptr);
+    });
 
+    // the new pointers were loaded from the whole memory,
+    // from the old pointers we must load only from the objects
+    // that changed since the last time
+    size_t since = node->diff->memoryStamp;
+    node->diff->memoryStamp = memoryStamp;
+    if (all || since == memoryStamp)
+        return changed;
+
+    std::vector<MemoryObject *> objects;
+    for (const Pointer& ptr : operand->pointsTo) {
         if (!canBeDereferenced(ptr))
             continue;
 
-        // find memory objects holding relevant points-to
-        // information
-        std::vector<MemoryObject *> objects;
+        objects.clear();
         getMemoryObjects(node, ptr, objects);
+        objects.erase(std::remove_if(objects.begin(), objects.end(),
+                                     [since](const MemoryObject *o) {
+                                         return o->lastChange <= since;
+                                     }),
+                      objects.end());
+
+        if (!objects.empty())
+            changed |= loadFromObjects(node, ptr, objects);
+    }
+
+    return changed;
+}
+
+bool PointerAnalysis::processLoad(PSNode *node, const Pointer& ptr)
+{
+    if (ptr.isUnknown()) {
+        // load from unknown pointer yields unknown pointer
+        return node->addPointsTo(UNKNOWN_MEMORY);
+    }
+
+    if (!canBeDereferenced(ptr))
+        return false;
+
+    // find memory objects holding relevant points-to
+    // information
+    std::vector<MemoryObject *> objects;
+    getMemoryObjects(node, ptr, objects);
+    addReader(node, objects);
 
+    // no objects found for this target? That is
+    // load from unknown memory
+    if (objects.empty()) {
         PSNodeAlloc *target = PSNodeAlloc::get(ptr.target);
         assert(target && "Target is not memory allocation");
 
-        // no objects found for this target? That is
-        // load from unknown memory
-        if (objects.empty()) {
+        if (target->isZeroInitialized())
+            // if the memory is zero initialized, then everything
+            // is fine, we add nullptr
+            return node->addPointsTo(NULLPTR);
+        else
+            return errorEmptyPointsTo(node, target);
+    }
+
+    return loadFromObjects(node, ptr, objects);
+}
+
+// Call 'add' on every pointer that can be loaded via 'ptr' from the memory
+// object 'o' and 'empty' if the load reads memory that has no pointers
+// ('onlyObject' is true if 'o' is the only object that 'ptr' can refer to).
+template <typename AddF, typename EmptyF>
+static void loadFromObject(const Pointer& ptr, const MemoryObject *o,
+                           bool onlyObject, AddF add, EmptyF empty)
+{
+    PSNodeAlloc *target = PSNodeAlloc::get(ptr.target);
+    assert(target && "Target is not memory allocation");
+
+    // is the offset to the memory unknown?
+    // In that case everything can be referenced,
+    // so we need to copy the whole points-to
+    if (ptr.offset.isUnknown()) {
+        // we should load from memory that has
+        // no pointers in it - it may be an error
+        if (o->pointsTo.empty()) {
             if (target->isZeroInitialized())
-                // if the memory is zero initialized, then everything
-                // is fine, we add nullptr
-                changed |= node->addPointsTo(NULLPTR);
-            else
-                changed |= errorEmptyPointsTo(node, target);
+                add(PointerNull);
+            else if (onlyObject)
+                empty(target);
+        }
 
-            continue;
+        // we have some pointers - copy them all,
+        // since the offset is unknown
+        for (const auto& it : o->pointsTo) {
+            for (const Pointer& p : it.second)
+                add(p);
         }
 
-        for (MemoryObject *o : objects) {
-            // is the offset to the memory unknown?
-            // In that case everything can be referenced,
-            // so we need to copy the whole points-to
-            if (ptr.offset.isUnknown()) {
-                // we should load from memory that has
-                // no pointers in it - it may be an error
-                // FIXME: don't duplicate the code
-                if (o->pointsTo.empty()) {
-                    if (target->isZeroInitialized())
-                        changed |= node->addPointsTo(NULLPTR);
-                    else if (objects.size() == 1)
-                        changed |= errorEmptyPointsTo(node, target);
-                }
+        // this is all that we can do here...
+        return;
+    }
 
-                // we have some pointers - copy them all,
-                // since the offset is unknown
-                for (auto& it : o->pointsTo) {
-                    for (const Pointer &p : it.second) {
-                        changed |= node->addPointsTo(p);
-                    }
-                }
+    auto it = o->find(ptr.offset);
+    auto unknown = o->find(Offset::UNKNOWN);
 
-                // this is all that we can do here...
-                continue;
-            }
+    // load from empty points-to set
+    // - that is load from unknown memory
+    if (it == o->end()) {
+        // if the memory is zero initialized, then everything
+        // is fine, we add nullptr
+        if (target->isZeroInitialized())
+            add(PointerNull);
+        // if we don't have a definition even with unknown offset
+        // it is an error
+        else if (unknown == o->end())
+            empty(target);
+    } else {
+        // we have pointers on that memory, so we can
+        // do the work
+        for (const Pointer& memptr : it->second)
+            add(memptr);
+    }
 
-            // load from empty points-to set
-            // - that is load from unknown memory
-            if (!o->pointsTo.count(ptr.offset)) {
-                // if the memory is zero initialized, then everything
-                // is fine, we add nullptr
-                if (target->isZeroInitialized())
-                    changed |= node->addPointsTo(NULLPTR);
-                // if we don't have a definition even with unknown offset
-                // it is an error
-                // FIXME: don't triplicate the code!
-                else if (!o->pointsTo.count(Offset::UNKNOWN))
-                    changed |= errorEmptyPointsTo(node, target);
-            } else {
-                // we have pointers on that memory, so we can
-                // do the work
-                for (const Pointer& memptr : o->pointsTo[ptr.offset])
-                    changed |= node->addPointsTo(memptr);
-            }
+    // plus always add the pointers at unknown offset,
+    // since these can be what we need too
+    if (unknown != o->end()) {
+        for (const Pointer& memptr : unknown->second)
+            add(memptr);
+    }
+}
 
-            // plus always add the pointers at unknown offset,
-            // since these can be what we need too
-            if (o->pointsTo.count(Offset::UNKNOWN)) {
-                for (const Pointer& memptr : o->pointsTo[Offset::UNKNOWN]) {
-                    changed |= node->addPointsTo(memptr);
-                }
-            }
-        }
+bool PointerAnalysis::loadFromObjects(PSNode *node, const Pointer& ptr,
+                                      const std::vector<MemoryObject *>& objects)
+{
+    bool changed = false;
+    for (MemoryObject *o : objects) {
+        loadFromObject(ptr, o, objects.size() == 1,
+                       [&](const Pointer& p) {
+                           changed |= node->addPointsTo(p);
+                       },
+                       [&](PSNode *target) {
+                           changed |= errorEmptyPointsTo(node, target);
+                       });
     }
 
     return changed;
@@ -140,9 +236,48 @@ bool PointerAnalysis::processMemcpy(PSNode *node)
     PSNode *destNode = memcpy->getDestination();
 
     std::vector<MemoryObject *> srcObjects;
-    std::vector<MemoryObject *> destObjects;
 
-    // gather srcNode pointer objects
+    if (!options.diffPropagation || !isFlowInsensitive()) {
+        if (options.diffPropagation) {
+            consumePointers(node, 0);
+            consumePointers(node, 1);
+        }
+
+        // gather srcNode pointer objects
+        for (const Pointer& ptr : srcNode->pointsTo) {
+            assert(ptr.target && "Got nullptr as target");
+
+            if (!canBeDereferenced(ptr))
+                continue;
+
+            srcObjects.clear();
+            getMemoryObjects(node, ptr, srcObjects);
+            addReader(node, srcObjects);
+
+            if (srcObjects.empty()){
+                abort();
+                return changed;
+            }
+
+            changed |= memcpyTo(node, ptr, srcObjects, destNode->pointsTo);
+        }
+
+        return changed;
+    }
+
+    // The destination memory keeps everything that we copied into it,
+    // so we must copy only from the new source pointers or from the source
+    // objects that changed since the last time. From the rest of the
+    // source pointers it is enough to copy to the new destination pointers.
+    std::vector<Pointer> newSrc;
+    std::vector<Pointer> newDest;
+    forEachNewPointer(node, 0, [&](const Pointer& ptr) { newSrc.push_back(ptr); });
+    forEachNewPointer(node, 1, [&](const Pointer& ptr) { newDest.push_back(ptr); });
+    std::sort(newSrc.begin(), newSrc.end());
+
+    size_t since = node->diff->memoryStamp;
+    node->diff->memoryStamp = memoryStamp;
+
     for (const Pointer& ptr : srcNode->pointsTo) {
         assert(ptr.target && "Got nullptr as target");
 
@@ -151,31 +286,53 @@ bool PointerAnalysis::processMemcpy(PSNode *node)
 
         srcObjects.clear();
         getMemoryObjects(node, ptr, srcObjects);
+        addReader(node, srcObjects);
 
         if (srcObjects.empty()){
             abort();
             return changed;
         }
 
-        // gather destNode objects
-        for (const Pointer& dptr : destNode->pointsTo) {
-            assert(dptr.target && "Got nullptr as target");
+        bool fresh = std::binary_search(newSrc.begin(), newSrc.end(), ptr);
+        for (const MemoryObject *o : srcObjects)
+            fresh |= o->lastChange > since;
 
-            if (!canBeDereferenced(dptr))
-                continue;
+        if (fresh)
+            changed |= memcpyTo(node, ptr, srcObjects, destNode->pointsTo);
+        else if (!newDest.empty())
+            changed |= memcpyTo(node, ptr, srcObjects, newDest);
+    }
 
-            destObjects.clear();
-            getMemoryObjects(node, dptr, destObjects);
+    return changed;
+}
 
-            if (destObjects.empty()) {
-                abort();
-                return changed;
-            }
+template <typename ContT>
+bool PointerAnalysis::memcpyTo(PSNode *node, const Pointer& sptr,
+                               std::vector<MemoryObject *>& srcObjects,
+                               const ContT& dests)
+{
+    bool changed = false;
+    PSNodeMemcpy *memcpy = PSNodeMemcpy::get(node);
+    std::vector<MemoryObject *> destObjects;
 
-            changed |= processMemcpy(srcObjects, destObjects,
-                                     ptr, dptr,
-                                     memcpy->getLength());
+    // gather destNode objects
+    for (const Pointer& dptr : dests) {
+        assert(dptr.target && "Got nullptr as target");
+
+        if (!canBeDereferenced(dptr))
+            continue;
+
+        destObjects.clear();
+        getMemoryObjects(node, dptr, destObjects);
+
+        if (destObjects.empty()) {
+            abort();
+            return changed;
         }
+
+        changed |= processMemcpy(srcObjects, destObjects,
+                                 sptr, dptr,
+                                 memcpy->getLength());
     }
 
     return changed;
@@ -207,7 +364,12 @@ bool PointerAnalysis::processMemcpy(std::vector<MemoryObject *>& srcObjects,
         if ((sourceAlloc->getSize() != Offset::UNKNOWN) &&
             (sourceAlloc->getSize() == destAlloc->getSize()) &&
             len == sourceAlloc->getSize() && sptr.offset == 0) {
-            destAlloc->setZeroInitialized();
+            if (!destAlloc->isZeroInitialized()) {
+                destAlloc->setZeroInitialized();
+                // loading from the objects now yields null
+                for (MemoryObject *destO : destObjects)
+                    touch(destO);
+            }
         } else {
             // we could analyze in a lot of cases where
             // shoulde be stored the nullptr, but the question
@@ -218,83 +380,289 @@ bool PointerAnalysis::processMemcpy(std::vector<MemoryObject *>& srcObjects,
     }
 
     for (MemoryObject *destO : destObjects) {
+        bool ochanged = false;
         if (contains_null_somewhere)
-            changed |= destO->addPointsTo(Offset::UNKNOWN, NULLPTR);
+            ochanged |= destO->addPointsTo(Offset::UNKNOWN, NULLPTR);
 
         // copy every pointer from srcObjects that is in
         // the range to destination's objects
         for (MemoryObject *so : srcObjects) {
-            for (auto& src : so->pointsTo) { // src.first is offset,
-                                             // src.second is a PointToSet
-
-                // if the offset is inbound of the copied memory
-                // or we copy from unknown offset, or this pointer
-                // is on unknown offset, copy this pointer
-                if (src.first.isUnknown() ||
-                    srcOffset.isUnknown() ||
-                    (srcOffset <= src.first &&
-                     (len.isUnknown() ||
-                      *src.first - *srcOffset < *len))) {
-
-                    // copy the pointer, but shift it by the offsets
-                    // we are working with
-                    if (!src.first.isUnknown() && !srcOffset.isUnknown() &&
-                        !destOffset.isUnknown()) {
-                        // check that new offset does not overflow Offset::UNKNOWN
-                        if (Offset::UNKNOWN - *destOffset <= *src.first - *srcOffset) {
-                            changed |= destO->addPointsTo(Offset::UNKNOWN, src.second);
-                            continue;
-                        }
-
-                        Offset newOff = *src.first - *srcOffset + *destOffset;
-                        if (newOff >= destO->node->getSize() ||
-                            newOff >= options.fieldSensitivity) {
-                            changed |= destO->addPointsTo(Offset::UNKNOWN, src.second);
-                        } else {
-                            changed |= destO->addPointsTo(newOff, src.second);
-                        }
-                    } else {
-                        changed |= destO->addPointsTo(Offset::UNKNOWN, src.second);
-                    }
+            // adding pointers to destO would invalidate
+            // the iterators if we copy inside the same object
+            MemoryObject::PointsToMapT tmp;
+            const MemoryObject::PointsToMapT *src = &so->pointsTo;
+            if (so == destO) {
+                tmp = so->pointsTo;
+                src = &tmp;
+            }
+
+            // if we copy from unknown offset,
+            // every pointer from the source can be anywhere
+            if (srcOffset.isUnknown()) {
+                for (const auto& it : *src)
+                    ochanged |= destO->addPointsTo(Offset::UNKNOWN, it.second);
+                continue;
+            }
+
+            // the pointers on the offsets in [srcOffset, srcOffset + len)
+            // are copied and shifted by the offsets we are working with
+            for (auto it = src->lower_bound(srcOffset), E = src->knownEnd();
+                 it != E && (len.isUnknown() || *it->first - *srcOffset < *len);
+                 ++it) {
+                // we do not know where the pointer goes or the new offset
+                // would overflow Offset::UNKNOWN
+                if (destOffset.isUnknown() ||
+                    Offset::UNKNOWN - *destOffset <= *it->first - *srcOffset) {
+                    ochanged |= destO->addPointsTo(Offset::UNKNOWN, it->second);
+                    continue;
+                }
+
+                Offset newOff = *it->first - *srcOffset + *destOffset;
+                if (newOff >= destO->node->getSize() ||
+                    newOff >= options.fieldSensitivity) {
+                    ochanged |= destO->addPointsTo(Offset::UNKNOWN, it->second);
+                } else {
+                    ochanged |= destO->addPointsTo(newOff, it->second);
                 }
             }
+
+            // the pointers on unknown offset may be anywhere in the range
+            auto unknown = src->find(Offset::UNKNOWN);
+            if (unknown != src->end())
+                ochanged |= destO->addPointsTo(Offset::UNKNOWN, unknown->second);
+        }
+
+        if (ochanged) {
+            touch(destO);
+            changed = true;
         }
     }
 
     return changed;
 }
 
+Pointer PointerAnalysis::gepPointer(const Pointer& ptr, Offset gepOffset,
+                                    Offset fieldSensitivity)
+{
+    // the pointers into collapsed memory have always unknown offset
+    PSNodeAlloc *alloc = PSNodeAlloc::get(ptr.target);
+    if (alloc && alloc->isCollapsed())
+        return Pointer(ptr.target, Offset::UNKNOWN);
+
+    Offset::type new_offset;
+    if (ptr.offset.isUnknown() || gepOffset.isUnknown())
+        // set it like this to avoid overflow when adding
+        new_offset = Offset::UNKNOWN;
+    else
+        new_offset = *ptr.offset + *gepOffset;
+
+    // in the case PSNodeType::the memory has size 0, then every pointer
+    // will have unknown offset with the exception that it points
+    // to the begining of the memory - therefore make 0 exception
+    if ((new_offset == 0 || new_offset < ptr.target->getSize())
+        && new_offset < *fieldSensitivity)
+        return Pointer(ptr.target, new_offset);
+
+    return Pointer(ptr.target, Offset::UNKNOWN);
+}
+
 bool PointerAnalysis::processGep(PSNode *node) {
     bool changed = false;
 
     PSNodeGep *gep = PSNodeGep::get(node);
     assert(gep && "Non-GEP given");
 
-    for (const Pointer& ptr : gep->getSource()->pointsTo) {
-        Offset::type new_offset;
-        if (ptr.offset.isUnknown() || gep->getOffset().isUnknown())
-            // set it like this to avoid overflow when adding
-            new_offset = Offset::UNKNOWN;
-        else
-            new_offset = *ptr.offset + *gep->getOffset();
-
-        // in the case PSNodeType::the memory has size 0, then every pointer
-        // will have unknown offset with the exception that it points
-        // to the begining of the memory - therefore make 0 exception
-        if ((new_offset == 0 || new_offset < ptr.target->getSize())
-            && new_offset < *options.fieldSensitivity)
-            changed |= node->addPointsTo(ptr.target, new_offset);
-        else
-            changed |= node->addPointsTo(ptr.target, Offset::UNKNOWN);
+    bool collapse = options.collapseLoopObjects && isInLoop(node);
+    forEachNewPointer(node, 0, [&](const Pointer& ptr) {
+        if (collapse)
+            collapseTarget(ptr.target);
+        changed |= node->addPointsTo(gepPointer(ptr, gep->getOffset(),
+                                                options.fieldSensitivity));
+    });
+
+    return changed;
+}
+
+bool PointerAnalysis::processStore(PSNode *node)
+{
+    bool changed = false;
+    PSNode *values = node->getOperand(0);
+    PSNode *addresses = node->getOperand(1);
+
+    if (!options.diffPropagation || !isFlowInsensitive()) {
+        if (options.diffPropagation) {
+            consumePointers(node, 0);
+            consumePointers(node, 1);
+        }
+
+        for (const Pointer& ptr : addresses->pointsTo)
+            changed |= storeTo(node, ptr, values->pointsTo);
+        return changed;
+    }
+
+    // the memory keeps everything that we stored into it, so we must store
+    // all the values to the new addresses and the new values to the old ones
+    std::vector<Pointer> newValues;
+    forEachNewPointer(node, 0, [&](const Pointer& ptr) { newValues.push_back(ptr); });
+    bool allAddresses = forEachNewPointer(node, 1, [&](const Pointer& ptr) {
+        changed |= storeTo(node, ptr, values->pointsTo);
+    });
+
+    if (!allAddresses && !newValues.empty()) {
+        for (const Pointer& ptr : addresses->pointsTo)
+            changed |= storeTo(node, ptr, newValues);
     }
 
     return changed;
 }
 
-bool PointerAnalysis::processNode(PSNode *node)
+template <typename ContT>
+bool PointerAnalysis::storeTo(PSNode *node, const Pointer& ptr,
+                              const ContT& values)
 {
+    assert(ptr.target && "Got nullptr as target");
+
+    if (!canBeDereferenced(ptr))
+        return false;
+
     bool changed = false;
     std::vector<MemoryObject *> objects;
+    getMemoryObjects(node, ptr, objects);
+    for (MemoryObject *o : objects) {
+        bool ochanged = false;
+        for (const Pointer& to : values) {
+            ochanged |= o->addPointsTo(ptr.offset, to);
+        }
+
+        if (ochanged) {
+            touch(o);
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+bool PointerAnalysis::processPhi(PSNode *node)
+{
+    bool changed = false;
+    bool invalidate = options.invalidateNodes &&
+                      node->getType() == PSNodeType::CALL_RETURN;
+
+    // pointers to local memory of the callee are invalid after return
+    auto checkInvalidated = [&](const Pointer& ptr) {
+        if (!invalidate || !canBeDereferenced(ptr))
+            return;
+        PSNodeAlloc *target = PSNodeAlloc::get(ptr.target);
+        assert(target && "Target is not memory allocation");
+        if (!target->isHeap() && !target->isGlobal()) {
+            changed |= node->addPointsTo(INVALIDATED);
+        }
+    };
+
+    for (unsigned i = 0; i < node->getOperandsNum(); ++i) {
+        PSNode *op = node->getOperand(i);
+
+        if (!options.diffPropagation) {
+            if (invalidate) {
+                for (const Pointer& ptr : op->pointsTo)
+                    checkInvalidated(ptr);
+            }
+
+            changed |= node->addPointsTo(op->pointsTo);
+            continue;
+        }
+
+        forEachNewPointer(node, i, [&](const Pointer& ptr) {
+            checkInvalidated(ptr);
+            changed |= node->addPointsTo(ptr);
+        });
+    }
+
+    return changed;
+}
+
+bool PointerAnalysis::processFuncptrCall(PSNode *node)
+{
+    bool changed = false;
+
+    forEachNewPointer(node, 0, [&](const Pointer& ptr) {
+        // do not add pointers that do not point to functions
+        // (but do not do that when we are looking for invalidated
+        // memory as this may lead to undefined behavior)
+        if (!options.invalidateNodes
+            && ptr.target->getType() != PSNodeType::FUNCTION)
+            return;
+
+        if (node->addPointsTo(ptr)) {
+            changed = true;
+
+            if (ptr.isValid() && !ptr.isInvalidated()) {
+                size_t firstNew = PS->size();
+                functionPointerCall(node, ptr.target);
+                graphChanged(firstNew);
+            } else {
+                error(node, "Calling invalid pointer as a function!");
+            }
+        }
+    });
+
+    return changed;
+}
+
+const size_t PointerAnalysis::NOT_PROCESSED;
+
+size_t PointerAnalysis::consumePointers(PSNode *node, unsigned idx)
+{
+    PSNode *op = node->getOperand(idx);
+    if (!node->diff)
+        node->diff.reset(new PSNode::PointsToDiff());
+    if (!op->diff)
+        op->diff.reset(new PSNode::PointsToDiff());
+
+    auto& processed = node->diff->processed;
+    if (processed.size() <= idx)
+        processed.resize(node->getOperandsNum(), NOT_PROCESSED);
+
+    size_t from = processed[idx];
+    processed[idx] = op->diff->base + op->diff->added.size();
+    return from;
+}
+
+void PointerAnalysis::pruneProcessedPointers(PSNode *node)
+{
+    PSNode::PointsToDiff *diff = node->diff.get();
+    if (!diff || diff->added.empty() || diff->added.size() < diff->pruneAt)
+        return;
+
+    // check the users only when the log doubled since the last time,
+    // so that the checks are amortized by the added pointers
+    diff->pruneAt = 2 * diff->added.size();
+
+    size_t upto = diff->base + diff->added.size();
+    for (PSNode *user : node->getUsers()) {
+        if (!user->diff)
+            return;
+
+        const auto& processed = user->diff->processed;
+        for (unsigned i = 0; i < user->getOperandsNum(); ++i) {
+            if (user->getOperand(i) != node)
+                continue;
+            if (i >= processed.size() || processed[i] == NOT_PROCESSED)
+                return;
+            upto = std::min(upto, processed[i]);
+        }
+    }
+
+    diff->added.erase(diff->added.begin(),
+                      diff->added.begin() + (upto - diff->base));
+    diff->base = upto;
+    diff->pruneAt = diff->added.size();
+}
+
+bool PointerAnalysis::processNode(PSNode *node)
+{
+    bool changed = false;
 
 #ifdef DEBUG_ENABLED
     size_t prev_size = node->pointsTo.size();
@@ -305,20 +673,7 @@ bool PointerAnalysis::processNode(PSNode *node)
             changed |= processLoad(node);
             break;
         case PSNodeType::STORE:
-            for (const Pointer& ptr : node->getOperand(1)->pointsTo) {
-                assert(ptr.target && "Got nullptr as target");
-
-                if (!canBeDereferenced(ptr))
-                    continue;
-
-                objects.clear();
-                getMemoryObjects(node, ptr, objects);
-                for (MemoryObject *o : objects) {
-                    for (const Pointer& to : node->getOperand(0)->pointsTo) {
-                        changed |= o->addPointsTo(ptr.offset, to);
-                    }
-                }
-            }
+            changed |= processStore(node);
             break;
         case PSNodeType::INVALIDATE_OBJECT:
         case PSNodeType::FREE:
@@ -333,8 +688,9 @@ bool PointerAnalysis::processNode(PSNode *node)
             break;
         case PSNodeType::CAST:
             // cast only copies the pointers
-            for (const Pointer& ptr : node->getOperand(0)->pointsTo)
+            forEachNewPointer(node, 0, [&](const Pointer& ptr) {
                 changed |= node->addPointsTo(ptr);
+            });
             break;
         case PSNodeType::CONSTANT:
             // maybe warn? It has no sense to insert the constants into the graph.
@@ -344,51 +700,18 @@ bool PointerAnalysis::processNode(PSNode *node)
                    && "Constant should have exactly one pointer");
             break;
         case PSNodeType::CALL_RETURN:
-            if (options.invalidateNodes) {
-                for (PSNode *op : node->operands) {
-                    for (const Pointer& ptr : op->pointsTo) {
-                        if (!canBeDereferenced(ptr))
-                            continue;
-                        PSNodeAlloc *target = PSNodeAlloc::get(ptr.target);
-                        assert(target && "Target is not memory allocation");
-                        if (!target->isHeap() && !target->isGlobal()) {
-                            changed |= node->addPointsTo(INVALIDATED);
-                        }
-                    }
-                }
-            }
-            // fall-through
         case PSNodeType::RETURN:
             // gather pointers returned from subprocedure - the same way
             // as PHI works
         case PSNodeType::PHI:
-            for (PSNode *op : node->operands)
-                changed |= node->addPointsTo(op->pointsTo);
+            changed |= processPhi(node);
             break;
         case PSNodeType::CALL_FUNCPTR:
             // call via function pointer:
             // first gather the pointers that can be used to the
             // call and if something changes, let backend take some action
             // (for example build relevant subgraph)
-            for (const Pointer& ptr : node->getOperand(0)->pointsTo) {
-                // do not add pointers that do not point to functions
-                // (but do not do that when we are looking for invalidated
-                // memory as this may lead to undefined behavior)
-                if (!options.invalidateNodes
-                    && ptr.target->getType() != PSNodeType::FUNCTION)
-                    continue;
-
-                if (node->addPointsTo(ptr)) {
-                    changed = true;
-
-                    if (ptr.isValid() && !ptr.isInvalidated()) {
-                        functionPointerCall(node, ptr.target);
-                    } else {
-                        error(node, "Calling invalid pointer as a function!");
-                        continue;
-                    }
-                }
-            }
+            changed |= processFuncptrCall(node);
             break;
         case PSNodeType::MEMCPY:
             changed |= processMemcpy(node);
@@ -408,6 +731,11 @@ bool PointerAnalysis::processNode(PSNode *node)
             assert(0 && "Unknown type");
     }
 
+    if (options.diffPropagation) {
+        for (PSNode *op : node->operands)
+            pruneProcessedPointers(op);
+    }
+
 #ifdef DEBUG_ENABLED
     // the change of points-to set is not the only
     // change that can happen, so we don't use it as an
@@ -420,6 +748,690 @@ bool PointerAnalysis::processNode(PSNode *node)
     return changed;
 }
 
+const size_t PointerAnalysis::NO_PRIORITY;
+
+void PointerAnalysis::resizeWorklist()
+{
+    size_t num = PS->size();
+    priority.resize(num, NO_PRIORITY);
+    queued.resize(num, false);
+    memoryDirty.resize(num, false);
+}
+
+// get the order for 'num' nodes that are pushed at once
+// (they are taken from the worklist in the order they are pushed)
+int64_t PointerAnalysis::reserveWorklistOrder(size_t num)
+{
+    int64_t order;
+    if (options.worklistPolicy == PointerAnalysisOptions::WorklistPolicy::lifo) {
+        worklistOrder += num;
+        order = -worklistOrder;
+    } else {
+        order = worklistOrder;
+        worklistOrder += num;
+    }
+
+    return order;
+}
+
+void PointerAnalysis::pushToWorklist(PSNode *node, int64_t order,
+                                     bool memoryChanged)
+{
+    unsigned id = node->getID();
+    // the node is not reachable from the root
+    if (id >= priority.size() || priority[id] == NO_PRIORITY)
+        return;
+
+    if (memoryChanged)
+        memoryDirty[id] = true;
+
+    if (queued[id])
+        return;
+
+    queued[id] = true;
+    // the order of the SCCs may have changed since the priority was set
+    worklist.push({SCCs.hasComponent(node) ? SCCs.getOrder(node) : priority[id],
+                   order, node});
+}
+
+void PointerAnalysis::pushUsers(PSNode *node)
+{
+    for (PSNode *user : node->getUsers())
+        pushToWorklist(user);
+
+    // the call via function pointer may have added pointers
+    // directly to its paired node
+    if (node->getType() == PSNodeType::CALL_FUNCPTR) {
+        if (PSNode *paired = node->getPairedNode()) {
+            for (PSNode *user : paired->getUsers())
+                pushToWorklist(user);
+        }
+    }
+}
+
+void PointerAnalysis::graphChanged(size_t firstNew)
+{
+    std::vector<PSNode *> changedOperands = PS->takeChangedNodes();
+    if (firstNew == PS->size() && changedOperands.empty())
+        return;
+
+    std::vector<PSNode *> newNodes;
+    for (size_t i = firstNew; i < PS->size(); ++i) {
+        if (PSNode *n = PS->getNodes()[i].get())
+            newNodes.push_back(n);
+    }
+
+    // the new nodes that are reachable (and the old nodes that
+    // were not reachable before) must be processed
+    std::vector<PSNode *> added = SCCs.update(newNodes);
+    spliced.insert(spliced.end(), added.begin(), added.end());
+
+    // the old nodes with new predecessors may see a different
+    // memory state and the old nodes with new operands have
+    // new pointers to process
+    for (PSNode *n : newNodes) {
+        for (PSNode *succ : n->getSuccessors()) {
+            if (succ->getID() < firstNew)
+                spliced.push_back(succ);
+        }
+    }
+    spliced.insert(spliced.end(), changedOperands.begin(), changedOperands.end());
+
+    // the GEPs that got on a loop (see preprocessGEPs)
+    if (options.preprocessGeps) {
+        for (unsigned idx : SCCs.getMerged()) {
+            for (PSNode *n : SCCs.getSCCs()[idx]) {
+                PSNodeGep *gep = PSNodeGep::get(n);
+                if (gep && !gep->getOffset().isUnknown()) {
+                    gep->setOffset(Offset::UNKNOWN);
+                    resetDiff(gep);
+                    spliced.push_back(gep);
+                }
+            }
+        }
+    }
+}
+
+void PointerAnalysis::pushSpliced()
+{
+    // Queue only the part of the graph that is affected by the change.
+    // The incremental solver queues only the active nodes
+    // (the new nodes are activated on demand).
+    resizeWorklist();
+    int64_t order = reserveWorklistOrder(spliced.size());
+    for (PSNode *n : spliced) {
+        unsigned id = n->getID();
+        if (!incremental && priority[id] == NO_PRIORITY &&
+            SCCs.hasComponent(n))
+            priority[id] = SCCs.getOrder(n);
+        pushToWorklist(n, order++, true);
+    }
+
+    spliced.clear();
+}
+
+std::vector<size_t> PointerAnalysis::getSCCsOrder() const
+{
+    std::vector<size_t> order(PS->size(), NO_PRIORITY);
+    for (const auto& scc : SCCs.getSCCs()) {
+        for (PSNode *n : scc)
+            order[n->getID()] = SCCs.getOrder(n);
+    }
+
+    return order;
+}
+
+void PointerAnalysis::solveWorklist()
+{
+    assert(worklist.empty());
+    trackReaders = isFlowInsensitive();
+    worklistOrder = 0;
+    priority = getSCCsOrder();
+    queued.assign(PS->size(), false);
+    memoryDirty.assign(PS->size(), false);
+
+    // the nodes with the same priority are processed in BFS order at first
+    std::vector<PSNode *> nodes = PS->getNodes(PS->getRoot());
+    int64_t order = reserveWorklistOrder(nodes.size());
+    for (PSNode *n : nodes)
+        pushToWorklist(n, order++, true);
+
+    runWorklist();
+
+    trackReaders = false;
+    readers.clear();
+    readObjects.clear();
+}
+
+void PointerAnalysis::runWorklist()
+{
+    while (!worklist.empty()) {
+        PSNode *cur = worklist.top().node;
+        worklist.pop();
+
+        unsigned id = cur->getID();
+        queued[id] = false;
+        bool memChanged = memoryDirty[id];
+        memoryDirty[id] = false;
+
+        bool enq = false;
+        enq |= beforeProcessed(cur);
+        enq |= processNode(cur);
+        bool after = afterProcessed(cur);
+        enq |= after;
+
+        ++statistics.processedNodes;
+        if (enq) {
+            ++statistics.changedNodes;
+            pushUsers(cur);
+
+            // the state that the node has processed was changed
+            // after processing (e.g. memory merged from predecessors)
+            if (after)
+                pushToWorklist(cur, true);
+        }
+
+        if (!spliced.empty())
+            pushSpliced();
+
+        if (trackReaders) {
+            for (const MemoryObject *o : touched) {
+                auto it = readers.find(o);
+                if (it == readers.end())
+                    continue;
+                for (unsigned rid : it->second) {
+                    if (PSNode *reader = PS->getNodes()[rid].get())
+                        pushToWorklist(reader);
+                }
+            }
+            touched.clear();
+        } else if (!isSparse() &&
+                   (enq || (memChanged && sharesMemoryState(cur)))) {
+            // the memory state seen by the successors may have changed
+            for (PSNode *succ : cur->getSuccessors())
+                pushToWorklist(succ, true);
+        }
+    }
+}
+
+void PointerAnalysis::startIncremental()
+{
+    assert(isFlowInsensitive() &&
+           "Incremental solving needs flow-insensitive analysis");
+    assert(worklist.empty());
+
+    statistics = PointerAnalysisStatistics();
+    preprocess();
+    resetDiffs();
+    sanityCheck();
+
+    incremental = true;
+    trackReaders = true;
+    worklistOrder = 0;
+    priority.assign(PS->size(), NO_PRIORITY);
+    queued.assign(PS->size(), false);
+    memoryDirty.assign(PS->size(), false);
+}
+
+void PointerAnalysis::activate(PSNode *n)
+{
+    assert(incremental && "Incremental solving was not started");
+    resizeWorklist();
+
+    unsigned id = n->getID();
+    if (priority[id] != NO_PRIORITY)
+        return;
+
+    // the nodes that are not reachable from the root
+    // do not have any SCC, process them as soon as possible
+    priority[id] = SCCs.hasComponent(n) ? SCCs.getOrder(n) : 0;
+    pushToWorklist(n, true);
+}
+
+void PointerAnalysis::solveIncremental()
+{
+    assert(incremental && "Incremental solving was not started");
+    runWorklist();
+}
+
+namespace {
+
+// the rounds of the parallel solver with less nodes
+// are computed only by the calling thread
+const size_t PARALLEL_ROUND_MIN = 256;
+
+// Threads that run a function on the indices [0, num) of a round.
+// The indices are taken from a shared counter in chunks, so that
+// the threads that are done with their nodes help the others.
+// The calling thread takes part in the computation too.
+class ParallelRounds
+{
+    static const size_t CHUNK_SIZE = 64;
+
+    std::vector<std::thread> workers;
+    std::mutex lock;
+    std::condition_variable startCv;
+    std::condition_variable doneCv;
+
+    const std::function<void(size_t)> *job{nullptr};
+    size_t num{0};
+    std::atomic<size_t> next{0};
+    // the number of the round (workers wait for a new one)
+    unsigned round{0};
+    // the number of workers that have not finished the round yet
+    unsigned running{0};
+    bool quit{false};
+
+    void runChunks() {
+        while (true) {
+            size_t from = next.fetch_add(CHUNK_SIZE);
+            if (from >= num)
+                break;
+
+            size_t to = from + CHUNK_SIZE;
+            if (to > num)
+                to = num;
+            for (size_t i = from; i < to; ++i)
+                (*job)(i);
+        }
+    }
+
+    void work() {
+        unsigned seen = 0;
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            startCv.wait(guard, [&]() { return quit || round != seen; });
+            if (quit)
+                return;
+
+            seen = round;
+            guard.unlock();
+            runChunks();
+            guard.lock();
+
+            if (--running == 0)
+                doneCv.notify_one();
+        }
+    }
+
+public:
+    ParallelRounds(unsigned threads) {
+        // the calling thread is one of the threads
+        for (unsigned i = 1; i < threads; ++i)
+            workers.emplace_back(&ParallelRounds::work, this);
+    }
+
+    ~ParallelRounds() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            quit = true;
+        }
+        startCv.notify_all();
+        for (auto& w : workers)
+            w.join();
+    }
+
+    void run(size_t n, const std::function<void(size_t)>& f) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            job = &f;
+            num = n;
+            next = 0;
+            running = workers.size();
+            ++round;
+        }
+        startCv.notify_all();
+
+        runChunks();
+
+        std::unique_lock<std::mutex> guard(lock);
+        doneCv.wait(guard, [&]() { return running == 0; });
+    }
+};
+
+} // anonymous namespace
+
+// What processing the node in a round of the parallel solver adds
+// to the state of the analysis. The results are computed from the state
+// of the previous round (that is not modified during the computation)
+// and then are applied one by one.
+struct PointerAnalysis::ParallelResult {
+    // the pointers that are not in the points-to set of the node yet
+    std::vector<Pointer> pointers;
+    // the pointers that are not in the memory objects yet
+    std::vector<std::tuple<MemoryObject *, Offset, Pointer>> stores;
+    // the objects that the node reads, but is not their reader yet
+    std::vector<MemoryObject *> reads;
+    // the allocations whose memory had no pointers when loaded from
+    std::vector<PSNode *> emptyLoads;
+    // the operand of the load has an empty points-to set
+    bool emptyOperand{false};
+    // the node must be processed sequentially by processNode()
+    bool sequential{false};
+
+    void clear() {
+        pointers.clear();
+        stores.clear();
+        reads.clear();
+        emptyLoads.clear();
+        emptyOperand = false;
+        sequential = false;
+    }
+};
+
+void PointerAnalysis::addTargetObject(const Pointer& ptr)
+{
+    if (!canBeDereferenced(ptr))
+        return;
+
+    unsigned id = ptr.target->getID();
+    if (id >= targetObjects.size())
+        targetObjects.resize(std::max(static_cast<size_t>(id) + 1,
+                                      PS->size()), nullptr);
+    if (targetObjects[id])
+        return;
+
+    std::vector<MemoryObject *> objects;
+    getMemoryObjects(ptr.target, ptr, objects);
+    // flow-insensitive analysis has one object for every allocation,
+    // the nodes that use other targets are processed sequentially
+    if (objects.size() == 1)
+        targetObjects[id] = objects[0];
+}
+
+void PointerAnalysis::computeLoad(PSNode *node, ParallelResult& res) const
+{
+    PSNode *operand = node->getOperand(0);
+    if (operand->pointsTo.empty()) {
+        res.emptyOperand = true;
+        return;
+    }
+
+    auto add = [&](const Pointer& p) {
+        if (!node->pointsTo.count(p))
+            res.pointers.push_back(p);
+    };
+
+    for (const Pointer& ptr : operand->pointsTo) {
+        if (ptr.isUnknown()) {
+            // load from unknown pointer yields unknown pointer
+            add(Pointer(UNKNOWN_MEMORY));
+            continue;
+        }
+
+        if (!canBeDereferenced(ptr))
+            continue;
+
+        MemoryObject *o = getTargetObject(ptr);
+        if (!o) {
+            res.sequential = true;
+            return;
+        }
+
+        if (!isReader(node, o))
+            res.reads.push_back(o);
+
+        loadFromObject(ptr, o, true, add,
+                       [&](PSNode *target) { res.emptyLoads.push_back(target); });
+    }
+}
+
+void PointerAnalysis::computeStore(PSNode *node, ParallelResult& res) const
+{
+    PSNode *values = node->getOperand(0);
+    PSNode *addresses = node->getOperand(1);
+
+    for (const Pointer& ptr : addresses->pointsTo) {
+        assert(ptr.target && "Got nullptr as target");
+
+        if (!canBeDereferenced(ptr))
+            continue;
+
+        MemoryObject *o = getTargetObject(ptr);
+        if (!o) {
+            res.sequential = true;
+            return;
+        }
+
+        auto it = o->find(ptr.offset);
+        for (const Pointer& to : values->pointsTo) {
+            if (it == o->end() || !it->second.count(to))
+                res.stores.emplace_back(o, ptr.offset, to);
+        }
+    }
+}
+
+// NOTE: this runs concurrently, so it must not modify anything
+// but the result
+void PointerAnalysis::computeParallel(PSNode *node, ParallelResult& res) const
+{
+    res.clear();
+
+    auto add = [&](const Pointer& p) {
+        if (!node->pointsTo.count(p))
+            res.pointers.push_back(p);
+    };
+
+    switch (node->getType()) {
+        case PSNodeType::LOAD:
+            computeLoad(node, res);
+            break;
+        case PSNodeType::STORE:
+            computeStore(node, res);
+            break;
+        case PSNodeType::GEP: {
+            // collapsing the targets modifies them
+            if (options.collapseLoopObjects && isInLoop(node)) {
+                res.sequential = true;
+                break;
+            }
+
+            Offset off = PSNodeGep::get(node)->getOffset();
+            for (const Pointer& ptr : node->getOperand(0)->pointsTo)
+                add(gepPointer(ptr, off, options.fieldSensitivity));
+            break;
+        }
+        case PSNodeType::CAST:
+            for (const Pointer& ptr : node->getOperand(0)->pointsTo)
+                add(ptr);
+            break;
+        case PSNodeType::CALL_RETURN:
+        case PSNodeType::RETURN:
+        case PSNodeType::PHI: {
+            bool invalidate = options.invalidateNodes &&
+                              node->getType() == PSNodeType::CALL_RETURN;
+            for (PSNode *op : node->getOperands()) {
+                for (const Pointer& ptr : op->pointsTo) {
+                    // pointers to local memory of the callee
+                    // are invalid after return
+                    if (invalidate && canBeDereferenced(ptr)) {
+                        PSNodeAlloc *target = PSNodeAlloc::get(ptr.target);
+                        assert(target && "Target is not memory allocation");
+                        if (!target->isHeap() && !target->isGlobal())
+                            add(Pointer(INVALIDATED));
+                    }
+
+                    add(ptr);
+                }
+            }
+            break;
+        }
+        case PSNodeType::ALLOC:
+        case PSNodeType::DYN_ALLOC:
+        case PSNodeType::FUNCTION:
+        case PSNodeType::CONSTANT:
+        case PSNodeType::INVALIDATE_OBJECT:
+        case PSNodeType::FREE:
+        case PSNodeType::CALL:
+        case PSNodeType::ENTRY:
+        case PSNodeType::NOOP:
+            // nothing to do (see processNode)
+            break;
+        default:
+            // memcpy, call via function pointer, ... modify
+            // more than one points-to set or even the graph
+            res.sequential = true;
+    }
+}
+
+bool PointerAnalysis::applyParallel(PSNode *node, ParallelResult& res)
+{
+    if (res.sequential) {
+        bool changed = processNode(node);
+        if (changed) {
+            for (const Pointer& ptr : node->pointsTo)
+                addTargetObject(ptr);
+        }
+
+        return changed;
+    }
+
+    bool changed = false;
+    if (res.emptyOperand)
+        changed |= error(node->getOperand(0),
+                         "Load's operand has no points-to set");
+
+    for (const Pointer& ptr : res.pointers) {
+        if (node->addPointsTo(ptr)) {
+            addTargetObject(ptr);
+            changed = true;
+        }
+    }
+
+    for (PSNode *target : res.emptyLoads)
+        changed |= errorEmptyPointsTo(node, target);
+
+    addReader(node, res.reads);
+
+    // touch every changed object once for every sequence
+    // of the stores into it (the stores into one object
+    // are usually next to each other)
+    MemoryObject *last = nullptr;
+    bool ochanged = false;
+    for (const auto& st : res.stores) {
+        MemoryObject *o = std::get<0>(st);
+        if (o != last) {
+            if (ochanged)
+                touch(last);
+            last = o;
+            ochanged = false;
+        }
+
+        if (o->addPointsTo(std::get<1>(st), std::get<2>(st))) {
+            addTargetObject(std::get<2>(st));
+            ochanged = true;
+            changed = true;
+        }
+    }
+
+    if (ochanged)
+        touch(last);
+
+    return changed;
+}
+
+void PointerAnalysis::solveParallel()
+{
+    // the nodes of the next round
+    std::vector<PSNode *> next;
+    std::vector<bool> inNext(PS->size(), false);
+
+    // the solver processes the nodes reachable from the root
+    // (the nodes in SCCs)
+    auto push = [&](PSNode *n) {
+        unsigned id = n->getID();
+        if (id >= inNext.size())
+            inNext.resize(PS->size(), false);
+        if (SCCs.hasComponent(n) && !inNext[id]) {
+            inNext[id] = true;
+            next.push_back(n);
+        }
+    };
+
+    trackReaders = true;
+    targetObjects.assign(PS->size(), nullptr);
+
+    // the targets of the pointers must have memory objects
+    // before the threads start
+    std::vector<PSNode *> round = PS->getNodes(PS->getRoot());
+    for (PSNode *n : round) {
+        for (const Pointer& ptr : n->pointsTo)
+            addTargetObject(ptr);
+    }
+    std::vector<ParallelResult> results;
+    ParallelRounds threads(options.threads);
+
+    while (!round.empty()) {
+        ++statistics.iterationsNum;
+        statistics.processedNodes += round.size();
+
+        if (results.size() < round.size())
+            results.resize(round.size());
+
+        std::function<void(size_t)> compute = [&](size_t i) {
+            computeParallel(round[i], results[i]);
+        };
+
+        // do not wake up the threads for a couple of nodes
+        if (round.size() < PARALLEL_ROUND_MIN) {
+            for (size_t i = 0; i < round.size(); ++i)
+                compute(i);
+        } else {
+            threads.run(round.size(), compute);
+        }
+
+        for (size_t i = 0; i < round.size(); ++i) {
+            PSNode *cur = round[i];
+            if (!applyParallel(cur, results[i]))
+                continue;
+
+            ++statistics.changedNodes;
+            for (PSNode *user : cur->getUsers())
+                push(user);
+
+            if (cur->getType() == PSNodeType::CALL_FUNCPTR) {
+                // the call may have added pointers directly
+                // to its paired node and may have changed the graph
+                if (PSNode *paired = cur->getPairedNode()) {
+                    for (const Pointer& ptr : paired->pointsTo)
+                        addTargetObject(ptr);
+                    for (PSNode *user : paired->getUsers())
+                        push(user);
+                }
+
+                for (PSNode *n : spliced) {
+                    for (const Pointer& ptr : n->pointsTo)
+                        addTargetObject(ptr);
+                    push(n);
+                }
+                spliced.clear();
+            }
+        }
+
+        // the nodes that read the changed memory
+        for (const MemoryObject *o : touched) {
+            auto it = readers.find(o);
+            if (it == readers.end())
+                continue;
+            for (unsigned rid : it->second) {
+                if (PSNode *reader = PS->getNodes()[rid].get())
+                    push(reader);
+            }
+        }
+        touched.clear();
+
+        for (PSNode *n : next)
+            inNext[n->getID()] = false;
+        round.swap(next);
+        next.clear();
+    }
+
+    trackReaders = false;
+    readers.clear();
+    readObjects.clear();
+    targetObjects.clear();
+}
+
 void PointerAnalysis::sanityCheck() {
 #ifndef NDEBUG
     assert(NULLPTR->pointsTo.size() == 1
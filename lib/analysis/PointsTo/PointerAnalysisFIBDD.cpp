@@ -0,0 +1,318 @@
+#include <cassert>
+#include <unordered_map>
+#include <vector>
+
+#include "dg/ADT/BDD.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFIBDD.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+using ADT::BDDManager;
+using NodeT = BDDManager::NodeT;
+using LevelT = BDDManager::LevelT;
+
+namespace {
+
+///
+// The relations of the analysis. The nodes of the graph are encoded
+// by their IDs in the variables V (and W for the second node
+// in binary relations), the pointers are encoded by their IDs
+// from PointerIdMapping in the variables O1 (O2 and O3).
+// The bits of the variables of the same kind are interleaved,
+// so that renaming one kind to another keeps the order of variables.
+//
+//  P(V, O1)   the node V points to O1
+//  C(V, W)    the node V copies the pointers of W
+//  L(V, W)    the node V loads from the pointers of W
+//  S(V, W)    the node stores the pointers of V to the pointers of W
+//  H(O1, O2)  the memory pointed by O1 contains O2
+//  A(O1, O3)  loading via O1 reads the memory pointed by O3
+//  D(O1)      the pointer O1 can be dereferenced
+class Relations {
+    static const unsigned POINTER_BITS = 32;
+
+    BDDManager bdd;
+    std::vector<LevelT> V, W, O1, O2, O3;
+    unsigned toW, toO1From2, toO2, toO3;
+    NodeT cubeV, cubeW, cubeO1, cubeO3;
+
+    static PointerIdMapping& ids() { return PointerIdMapping::get(); }
+
+    static bool isDereferenceable(const Pointer& ptr) {
+        if (!ptr.isValid() || ptr.isInvalidated() || ptr.isUnknown())
+            return false;
+
+        // the memory objects of other targets are found
+        // by the regular solver (see getMemoryObjects)
+        return ptr.target->getType() == PSNodeType::ALLOC ||
+               ptr.target->getType() == PSNodeType::DYN_ALLOC;
+    }
+
+    // reading via 'a' reads the memory pointed by 'b' (and vice versa)
+    static bool mayAlias(const Pointer& a, const Pointer& b) {
+        return a.target == b.target &&
+               (a.offset.isUnknown() || b.offset.isUnknown() ||
+                a.offset == b.offset);
+    }
+
+    // the pointers that are already in A and D
+    std::vector<bool> known;
+    // the known dereferenceable pointers grouped by the targets
+    std::unordered_map<PSNode *, std::vector<size_t>> pointersTo;
+
+public:
+    NodeT P{BDDManager::ZERO}, C{BDDManager::ZERO}, L{BDDManager::ZERO},
+          S{BDDManager::ZERO}, H{BDDManager::ZERO}, A{BDDManager::ZERO},
+          D{BDDManager::ZERO};
+
+    Relations(size_t nodesNum) {
+        unsigned nodeBits = 1;
+        while (nodeBits < 32 && (static_cast<size_t>(1) << nodeBits) < nodesNum)
+            ++nodeBits;
+
+        LevelT l = 0;
+        for (unsigned i = 0; i < nodeBits; ++i) {
+            V.push_back(l++);
+            W.push_back(l++);
+        }
+        for (unsigned i = 0; i < POINTER_BITS; ++i) {
+            O1.push_back(l++);
+            O2.push_back(l++);
+            O3.push_back(l++);
+        }
+
+        toW = bdd.addRenaming(V, W);
+        toO2 = bdd.addRenaming(O1, O2);
+        toO1From2 = bdd.addRenaming(O2, O1);
+        toO3 = bdd.addRenaming(O1, O3);
+        cubeV = bdd.cube(V);
+        cubeW = bdd.cube(W);
+        cubeO1 = bdd.cube(O1);
+        cubeO3 = bdd.cube(O3);
+    }
+
+    // the nodes are identified by numbers (see solveRelations)
+    NodeT node(size_t num) { return bdd.minterm(num, V); }
+
+    NodeT pointer(const Pointer& ptr) {
+        size_t id = ids().getOrCreateId(ptr);
+        assert(id < (static_cast<size_t>(1) << POINTER_BITS) && "Too many pointers");
+        return bdd.minterm(id, O1);
+    }
+
+    // the pair (a, b) of nodes
+    NodeT edge(size_t a, size_t b) {
+        return bdd.bddAnd(node(a), bdd.replace(node(b), toW));
+    }
+
+    NodeT unite(NodeT a, NodeT b) { return bdd.bddOr(a, b); }
+
+    void addPointsTo(size_t num, const Pointer& ptr) {
+        P = unite(P, bdd.bddAnd(node(num), pointer(ptr)));
+    }
+
+    // one round of the copy, load and store rules
+    void propagate() {
+        NodeT PW = bdd.replace(P, toW);
+
+        NodeT copied = bdd.relProd(C, PW, cubeW);
+
+        NodeT addresses = bdd.relProd(L, PW, cubeW);
+        NodeT reads = bdd.relProd(A, bdd.replace(H, toO3), cubeO3);
+        NodeT loaded = bdd.replace(bdd.relProd(addresses, reads, cubeO1),
+                                   toO1From2);
+
+        NodeT stored = bdd.bddAnd(bdd.relProd(S, PW, cubeW), D);
+        H = unite(H, bdd.relProd(stored, bdd.replace(P, toO2), cubeV));
+
+        P = unite(P, unite(copied, loaded));
+    }
+
+    // the pointers of the node with the number 'num'
+    NodeT pointsTo(size_t num) { return bdd.relProd(P, node(num), cubeV); }
+    NodeT newPointers(NodeT now, NodeT old) { return bdd.bddDiff(now, old); }
+
+    template <typename F>
+    void forEachPointer(NodeT set, F f) {
+        for (auto it = bdd.begin(set, &O1), et = bdd.end(); it != et; ++it)
+            f(ids().getPointer(*it));
+    }
+
+    // add the new pointers from P to A and D
+    void updateAliases() {
+        forEachPointer(bdd.exists(P, cubeV), [this](const Pointer& ptr) {
+            size_t id = ids().getId(ptr);
+            if (id < known.size() && known[id])
+                return;
+            if (known.size() <= id)
+                known.resize(id + 1, false);
+            known[id] = true;
+
+            NodeT p = pointer(ptr);
+            if (ptr.isUnknown()) {
+                // loading via unknown pointer yields unknown pointer
+                NodeT unknown = bdd.bddAnd(p, bdd.replace(p, toO3));
+                A = unite(A, unknown);
+                H = unite(H, bdd.bddAnd(p, bdd.replace(p, toO2)));
+                return;
+            }
+
+            if (!isDereferenceable(ptr))
+                return;
+
+            D = unite(D, p);
+            auto& others = pointersTo[ptr.target];
+            others.push_back(id);
+            for (size_t oid : others) {
+                const Pointer& other = ids().getPointer(oid);
+                if (!mayAlias(ptr, other))
+                    continue;
+
+                NodeT o = bdd.minterm(oid, O1);
+                A = unite(A, bdd.bddAnd(p, bdd.replace(o, toO3)));
+                A = unite(A, bdd.bddAnd(o, bdd.replace(p, toO3)));
+            }
+        });
+    }
+
+    // the contents of memory: call f(field, values)
+    // for every pointer that points to a memory with pointers
+    template <typename F>
+    void forEachField(F f) {
+        NodeT fields = bdd.exists(H, bdd.cube(O2));
+        for (auto it = bdd.begin(fields, &O1), et = bdd.end(); it != et; ++it) {
+            NodeT values = bdd.relProd(H, bdd.minterm(*it, O1), cubeO1);
+            f(ids().getPointer(*it), bdd.replace(values, toO1From2));
+        }
+    }
+};
+
+} // anonymous namespace
+
+void PointerAnalysisFIBDD::solveRelations()
+{
+    // the relations can not express collapsing of memory objects,
+    // leave everything on the regular solver in that case
+    if (getOptions().objectFieldsBudget > 0 || getOptions().collapseLoopObjects)
+        return;
+
+    PointerSubgraph *PS = getPS();
+    bool invalidate = getOptions().invalidateNodes;
+
+    // process only the nodes that the regular solver processes.
+    // Their operands may be elsewhere (e.g. constants) or even not
+    // in the graph (e.g. NULLPTR), these get numbers after the IDs
+    std::vector<PSNode *> nodes = PS->getNodes(PS->getRoot());
+    std::unordered_map<const PSNode *, size_t> outside;
+    auto number = [&](const PSNode *n) -> size_t {
+        unsigned id = n->getID();
+        if (id < PS->size() && PS->getNodes()[id].get() == n)
+            return id;
+        return outside.emplace(n, PS->size() + outside.size()).first->second;
+    };
+
+    std::vector<PSNode *> operands;
+    for (PSNode *n : nodes) {
+        for (PSNode *op : n->getOperands())
+            operands.push_back(op);
+    }
+    for (PSNode *op : operands)
+        number(op);
+
+    Relations R(PS->size() + outside.size());
+
+    // the pointers that the nodes already have
+    std::vector<bool> seeded(PS->size() + outside.size(), false);
+    auto seed = [&](const PSNode *n) {
+        size_t num = number(n);
+        if (seeded[num])
+            return;
+        seeded[num] = true;
+        for (const Pointer& ptr : n->pointsTo)
+            R.addPointsTo(num, ptr);
+    };
+
+    std::vector<PSNodeGep *> geps;
+    for (PSNode *n : nodes) {
+        seed(n);
+        for (PSNode *op : n->getOperands())
+            seed(op);
+
+        switch (n->getType()) {
+            case PSNodeType::CALL_RETURN:
+                // the pointers to the locals of the callee
+                // must be invalidated by the regular solver
+                if (invalidate)
+                    break;
+                // fall-through
+            case PSNodeType::PHI:
+            case PSNodeType::CAST:
+            case PSNodeType::RETURN:
+                for (PSNode *op : n->getOperands())
+                    R.C = R.unite(R.C, R.edge(number(n), number(op)));
+                break;
+            case PSNodeType::LOAD:
+                R.L = R.unite(R.L, R.edge(number(n), number(n->getOperand(0))));
+                break;
+            case PSNodeType::STORE:
+                R.S = R.unite(R.S, R.edge(number(n->getOperand(0)),
+                                          number(n->getOperand(1))));
+                break;
+            case PSNodeType::GEP:
+                geps.push_back(PSNodeGep::get(n));
+                break;
+            default:
+                break;
+        }
+    }
+
+    // the pointers of the sources of GEPs that were already processed
+    std::vector<NodeT> gepDone(geps.size(), BDDManager::ZERO);
+    NodeT oldP, oldH;
+    do {
+        oldP = R.P;
+        oldH = R.H;
+
+        R.updateAliases();
+        R.propagate();
+
+        for (size_t i = 0; i < geps.size(); ++i) {
+            PSNodeGep *gep = geps[i];
+            NodeT now = R.pointsTo(number(gep->getSource()));
+            R.forEachPointer(R.newPointers(now, gepDone[i]),
+                             [&](const Pointer& ptr) {
+                R.addPointsTo(number(gep),
+                              gepPointer(ptr, gep->getOffset(),
+                                         getOptions().fieldSensitivity));
+            });
+            gepDone[i] = now;
+        }
+    } while (oldP != R.P || oldH != R.H);
+
+    // store the results where the regular solver expects them
+    for (PSNode *n : nodes) {
+        R.forEachPointer(R.pointsTo(number(n)), [n](const Pointer& ptr) {
+            n->addPointsTo(ptr);
+        });
+    }
+
+    std::vector<MemoryObject *> objects;
+    R.forEachField([&](const Pointer& field, NodeT values) {
+        if (field.isUnknown())
+            return;
+
+        objects.clear();
+        getMemoryObjects(nullptr, field, objects);
+        for (MemoryObject *mo : objects) {
+            R.forEachPointer(values, [&](const Pointer& ptr) {
+                mo->addPointsTo(field.offset, ptr);
+            });
+        }
+    });
+}
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
@@ -88,78 +88,88 @@ static bool hasNonpointerOperand(const PSNode *nd)
     return false;
 }
 
+bool PointerSubgraphValidator::isInGraph(const PSNode *nd) const {
+    const auto& nodes = PS->getNodes();
+    return nd->getID() < nodes.size() && nodes[nd->getID()].get() == nd;
+}
+
+bool PointerSubgraphValidator::checkOperands(const PSNode *nd) {
+    bool invalid = false;
+
+    for (const PSNode *op : nd->getOperands()) {
+        if (op != NULLPTR && op != UNKNOWN_MEMORY && op != INVALIDATED &&
+            !isInGraph(op)) {
+            invalid |= reportInvalOperands(nd, "Node has unknown (maybe dangling) operand");
+        }
+    }
+
+    switch (nd->getType()) {
+        case PSNodeType::PHI:
+            if (nd->getOperandsNum() == 0) {
+                // this may not be always an error
+                // (say this is a phi of an uninitialized pointer
+                // for which we do not have any points to)
+                warn(nd, "Empty PHI");
+            } else if (hasDuplicateOperand(nd)) {
+                // this is not an error, but warn the user
+                // as this is redundant
+                warn(nd, "PHI Node contains duplicated operand");
+            } else if (hasNonpointerOperand(nd)) {
+                invalid |= reportInvalOperands(nd, "PHI Node contains non-pointer operand");
+            }
+            break;
+        case PSNodeType::NULL_ADDR:
+        case PSNodeType::UNKNOWN_MEM:
+        case PSNodeType::NOOP:
+        case PSNodeType::FUNCTION:
+            if (nd->getOperandsNum() != 0) {
+                invalid |= reportInvalOperands(nd, "Should not have an operand");
+            }
+            break;
+        case PSNodeType::GEP:
+        case PSNodeType::LOAD:
+        case PSNodeType::CAST:
+        case PSNodeType::INVALIDATE_OBJECT:
+        case PSNodeType::CONSTANT:
+        case PSNodeType::FREE:
+            if (hasNonpointerOperand(nd)) {
+                invalid |= reportInvalOperands(nd, "Node has non-pointer operand");
+            }
+            if (nd->getOperandsNum() != 1) {
+                invalid |= reportInvalOperands(nd, "Should have exactly one operand");
+            }
+            break;
+        case PSNodeType::STORE:
+        case PSNodeType::MEMCPY:
+            if (hasNonpointerOperand(nd)) {
+                invalid |= reportInvalOperands(nd, "Node has non-pointer operand");
+            }
+            if (nd->getOperandsNum() != 2) {
+                invalid |= reportInvalOperands(nd, "Should have exactly two operands");
+            }
+            break;
+        default:
+            break;
+    }
+
+    return invalid;
+}
+
 bool PointerSubgraphValidator::checkOperands() {
     bool invalid = false;
 
-    std::set<const PSNode *> known_nodes;
     const auto& nodes = PS->getNodes();
-
     for (const auto& nd : nodes) {
         if (!nd)
             continue;
 
-        if (!known_nodes.insert(nd.get()).second)
-            invalid |= reportInvalNode(nd.get(), "Node multiple times in the graph");
+        if (!isInGraph(nd.get()))
+            invalid |= reportInvalNode(nd.get(), "Node is not stored under its ID");
     }
 
-    for (const auto& ndptr : nodes) {
-        if (!ndptr)
-            continue;
-
-        PSNode *nd = ndptr.get();
-        for (const PSNode *op : nd->getOperands()) {
-            if (op != NULLPTR && op != UNKNOWN_MEMORY && op != INVALIDATED &&
-                known_nodes.count(op) == 0) {
-                invalid |= reportInvalOperands(nd, "Node has unknown (maybe dangling) operand");
-            }
-        }
-
-        switch (nd->getType()) {
-            case PSNodeType::PHI:
-                if (nd->getOperandsNum() == 0) {
-                    // this may not be always an error
-                    // (say this is a phi of an uninitialized pointer
-                    // for which we do not have any points to)
-                    warn(nd, "Empty PHI");
-                } else if (hasDuplicateOperand(nd)) {
-                    // this is not an error, but warn the user
-                    // as this is redundant
-                    warn(nd, "PHI Node contains duplicated operand");
-                } else if (hasNonpointerOperand(nd)) {
-                    invalid |= reportInvalOperands(nd, "PHI Node contains non-pointer operand");
-                }
-                break;
-            case PSNodeType::NULL_ADDR:
-            case PSNodeType::UNKNOWN_MEM:
-            case PSNodeType::NOOP:
-            case PSNodeType::FUNCTION:
-                if (nd->getOperandsNum() != 0) {
-                    invalid |= reportInvalOperands(nd, "Should not have an operand");
-                }
-                break;
-            case PSNodeType::GEP:
-            case PSNodeType::LOAD:
-            case PSNodeType::CAST:
-            case PSNodeType::INVALIDATE_OBJECT:
-            case PSNodeType::CONSTANT:
-            case PSNodeType::FREE:
-                if (hasNonpointerOperand(nd)) {
-                    invalid |= reportInvalOperands(nd, "Node has non-pointer operand");
-                }
-                if (nd->getOperandsNum() != 1) {
-                    invalid |= reportInvalOperands(nd, "Should have exactly one operand");
-                }
-                break;
-            case PSNodeType::STORE:
-            case PSNodeType::MEMCPY:
-                if (hasNonpointerOperand(nd)) {
-                    invalid |= reportInvalOperands(nd, "Node has non-pointer operand");
-                }
-                if (nd->getOperandsNum() != 2) {
-                    invalid |= reportInvalOperands(nd, "Should have exactly two operands");
-                }
-                break;
-        }
+    for (const auto& nd : nodes) {
+        if (nd)
+            invalid |= checkOperands(nd.get());
     }
 
     return invalid;
@@ -206,24 +216,30 @@ std::set<const PSNode *> reachableNodes(const PSNode *nd) {
     return reachable;
 }
 
+bool PointerSubgraphValidator::checkEdges(const PSNode *nd) {
+    bool invalid = false;
+
+    if (nd->predecessorsNum() == 0 && nd != PS->getRoot()
+        && !canBeOutsideGraph(nd)) {
+        invalid |= reportInvalEdges(nd, "Non-root node has no predecessors");
+    }
+
+    for (const PSNode *succ : nd->getSuccessors()) {
+        if (!isInPredecessors(nd, succ))
+            invalid |= reportInvalEdges(nd, "Node not set as a predecessor of some of its successors");
+    }
+
+    return invalid;
+}
+
 bool PointerSubgraphValidator::checkEdges() {
     bool invalid = false;
 
     // check incoming/outcoming edges of all nodes
     const auto& nodes = PS->getNodes();
     for (const auto& nd : nodes) {
-        if (!nd)
-            continue;
-
-        if (nd->predecessorsNum() == 0 && nd.get() != PS->getRoot()
-            && !canBeOutsideGraph(nd.get())) {
-            invalid |= reportInvalEdges(nd.get(), "Non-root node has no predecessors");
-        }
-
-        for (const PSNode *succ : nd->getSuccessors()) {
-            if (!isInPredecessors(nd.get(), succ))
-                invalid |= reportInvalEdges(nd.get(), "Node not set as a predecessor of some of its successors");
-        }
+        if (nd)
+            invalid |= checkEdges(nd.get());
     }
 
     // check that the edges form valid CFG (all nodes are reachable)
@@ -249,6 +265,65 @@ bool PointerSubgraphValidator::validate() {
     return invalid;
 }
 
+bool PointerSubgraphValidator::validate(size_t firstNew,
+                                        const std::vector<PSNode *>& changed) {
+    bool invalid = false;
+
+    const auto& nodes = PS->getNodes();
+    std::vector<const PSNode *> newNodes;
+    for (size_t i = firstNew; i < nodes.size(); ++i) {
+        if (!nodes[i])
+            continue;
+
+        if (!isInGraph(nodes[i].get()))
+            invalid |= reportInvalNode(nodes[i].get(), "Node is not stored under its ID");
+        newNodes.push_back(nodes[i].get());
+    }
+
+    for (const PSNode *nd : newNodes) {
+        invalid |= checkOperands(nd);
+        invalid |= checkEdges(nd);
+    }
+
+    for (const PSNode *nd : changed) {
+        if (nd->getID() < firstNew)
+            invalid |= checkOperands(nd);
+    }
+
+    // the old nodes are reachable, so the new nodes are reachable
+    // if we can get to them from the old nodes
+    std::vector<bool> reachable(nodes.size() - firstNew, false);
+    std::vector<const PSNode *> to_process;
+    for (const PSNode *nd : newNodes) {
+        for (const PSNode *pred : nd->getPredecessors()) {
+            if (pred->getID() < firstNew) {
+                reachable[nd->getID() - firstNew] = true;
+                to_process.push_back(nd);
+                break;
+            }
+        }
+    }
+
+    while (!to_process.empty()) {
+        const PSNode *cur = to_process.back();
+        to_process.pop_back();
+
+        for (const PSNode *succ : cur->getSuccessors()) {
+            if (succ->getID() >= firstNew &&
+                !reachable[succ->getID() - firstNew]) {
+                reachable[succ->getID() - firstNew] = true;
+                to_process.push_back(succ);
+            }
+        }
+    }
+
+    for (const PSNode *nd : newNodes) {
+        if (!reachable[nd->getID() - firstNew] && !canBeOutsideGraph(nd))
+            invalid |= reportUnreachableNode(nd);
+    }
+
+    return invalid;
+}
 
 } // namespace debug
 } // namespace pta
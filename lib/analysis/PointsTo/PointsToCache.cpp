@@ -0,0 +1,330 @@
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "dg/analysis/PointsTo/PointsToCache.h"
+#include "dg/analysis/PointsTo/Pointer.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+///
+// The file is (in the byte order of the machine that created it):
+//
+//   Header
+//   uint64_t      index[nodesNum + 1]  the first pointer of every node
+//   StoredPointer pointers[pointersNum]
+//   uint32_t      calls[2 * callsNum]  the inserted calls
+//   uint8_t       types[nodesNum]      the types of the nodes
+//   uint8_t       flags[nodesNum]      the flags of the nodes (FLAG_*)
+//
+// The nodes are indexed by their IDs, the node 0 is the invalid node.
+// The types are there only to find out that the graph is not the same
+// as the stored one. The flags are the results of the analysis
+// that are not in the points-to sets.
+struct PointsToCache::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t key;
+    uint64_t nodesNum;
+    uint64_t pointersNum;
+    uint64_t callsNum;
+};
+
+struct PointsToCache::StoredPointer {
+    uint64_t offset;
+    uint32_t target;
+    uint32_t reserved;
+};
+
+static const char CACHE_MAGIC[8] = {'D', 'G', 'P', 'T', 'A', 'C', 'H', '\0'};
+static const uint32_t CACHE_VERSION = 2;
+
+// the IDs of the targets that are not nodes of the graph
+static const uint32_t TARGET_NULL = ~static_cast<uint32_t>(0);
+static const uint32_t TARGET_UNKNOWN = TARGET_NULL - 1;
+static const uint32_t TARGET_INVALIDATED = TARGET_NULL - 2;
+// the type of the removed nodes
+static const uint8_t NO_NODE = 0xff;
+// the allocation was collapsed (PSNodeAlloc::isCollapsed())
+static const uint8_t FLAG_COLLAPSED = 0x1;
+
+static uint32_t getTargetID(const PSNode *target) {
+    if (target == NULLPTR)
+        return TARGET_NULL;
+    if (target == UNKNOWN_MEMORY)
+        return TARGET_UNKNOWN;
+    if (target == INVALIDATED)
+        return TARGET_INVALIDATED;
+    return target->getID();
+}
+
+static PSNode *getTarget(const PointerSubgraph& PS, uint32_t id) {
+    switch (id) {
+        case TARGET_NULL: return NULLPTR;
+        case TARGET_UNKNOWN: return UNKNOWN_MEMORY;
+        case TARGET_INVALIDATED: return INVALIDATED;
+        default:
+            return id < PS.size() ? PS.getNodes()[id].get() : nullptr;
+    }
+}
+
+template <typename T>
+static void writeArray(std::ofstream& out, const std::vector<T>& arr) {
+    out.write(reinterpret_cast<const char *>(arr.data()),
+              arr.size() * sizeof(T));
+}
+
+bool PointsToCache::save(const std::string& path, uint64_t key,
+                         const PointerSubgraph& PS,
+                         const std::vector<CallT>& calls) {
+    const auto& nodes = PS.getNodes();
+
+    std::vector<uint64_t> idx;
+    std::vector<StoredPointer> ptrs;
+    std::vector<uint8_t> tps;
+    std::vector<uint8_t> flgs;
+    idx.reserve(nodes.size() + 1);
+    tps.reserve(nodes.size());
+    flgs.reserve(nodes.size());
+    for (const auto& nd : nodes) {
+        idx.push_back(ptrs.size());
+        if (!nd) {
+            tps.push_back(NO_NODE);
+            flgs.push_back(0);
+            continue;
+        }
+
+        tps.push_back(static_cast<uint8_t>(nd->getType()));
+        PSNodeAlloc *alloc = PSNodeAlloc::get(nd.get());
+        flgs.push_back(alloc && alloc->isCollapsed() ? FLAG_COLLAPSED : 0);
+        for (const Pointer& ptr : nd->pointsTo)
+            ptrs.push_back({*ptr.offset, getTargetID(ptr.target), 0});
+    }
+    idx.push_back(ptrs.size());
+
+    std::vector<uint32_t> cls;
+    cls.reserve(2 * calls.size());
+    for (const CallT& c : calls) {
+        cls.push_back(c.first);
+        cls.push_back(c.second);
+    }
+
+    Header hdr;
+    memcpy(hdr.magic, CACHE_MAGIC, sizeof(hdr.magic));
+    hdr.version = CACHE_VERSION;
+    hdr.reserved = 0;
+    hdr.key = key;
+    hdr.nodesNum = nodes.size();
+    hdr.pointersNum = ptrs.size();
+    hdr.callsNum = calls.size();
+
+    // write into a temporary file and rename it, so that
+    // the readers never see a half-written file
+    std::string tmp = path + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+
+        out.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+        writeArray(out, idx);
+        writeArray(out, ptrs);
+        writeArray(out, cls);
+        writeArray(out, tps);
+        writeArray(out, flgs);
+        if (!out) {
+            out.close();
+            std::remove(tmp.c_str());
+            return false;
+        }
+    }
+
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void PointsToCache::close() {
+    if (data)
+        munmap(const_cast<char *>(data), dataSize);
+
+    data = nullptr;
+    dataSize = 0;
+    header = nullptr;
+    index = nullptr;
+    pointers = nullptr;
+    calls = nullptr;
+    types = nullptr;
+    flags = nullptr;
+}
+
+bool PointsToCache::open(const std::string& path, uint64_t key) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void *mem = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED)
+        return false;
+
+    data = static_cast<const char *>(mem);
+    dataSize = size;
+    header = reinterpret_cast<const Header *>(data);
+
+    if (memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header->version != CACHE_VERSION || header->key != key ||
+        header->nodesNum == 0) {
+        close();
+        return false;
+    }
+
+    // check the size before computing the offsets,
+    // so that a broken file cannot make them overflow
+    uint64_t nodesNum = header->nodesNum;
+    uint64_t pointersNum = header->pointersNum;
+    uint64_t callsNum = header->callsNum;
+    if (nodesNum > size || pointersNum > size || callsNum > size ||
+        size != sizeof(Header) + (nodesNum + 1) * sizeof(uint64_t)
+                + pointersNum * sizeof(StoredPointer)
+                + 2 * callsNum * sizeof(uint32_t)
+                + 2 * nodesNum * sizeof(uint8_t)) {
+        close();
+        return false;
+    }
+
+    const char *cur = data + sizeof(Header);
+    index = reinterpret_cast<const uint64_t *>(cur);
+    cur += (nodesNum + 1) * sizeof(uint64_t);
+    pointers = reinterpret_cast<const StoredPointer *>(cur);
+    cur += pointersNum * sizeof(StoredPointer);
+    calls = reinterpret_cast<const uint32_t *>(cur);
+    cur += 2 * callsNum * sizeof(uint32_t);
+    types = reinterpret_cast<const uint8_t *>(cur);
+    cur += nodesNum * sizeof(uint8_t);
+    flags = reinterpret_cast<const uint8_t *>(cur);
+
+    if (index[nodesNum] != pointersNum) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+size_t PointsToCache::getNodesNum() const {
+    assert(isOpen());
+    return header->nodesNum;
+}
+
+std::vector<PointsToCache::CallT> PointsToCache::getCalls() const {
+    assert(isOpen());
+    std::vector<CallT> ret;
+    ret.reserve(header->callsNum);
+    for (uint64_t i = 0; i < header->callsNum; ++i)
+        ret.emplace_back(calls[2 * i], calls[2 * i + 1]);
+
+    return ret;
+}
+
+bool PointsToCache::matchesBeforeCalls(const PointerSubgraph& PS) const {
+    assert(isOpen());
+    const auto& nodes = PS.getNodes();
+    // the calls only add nodes
+    if (nodes.size() > header->nodesNum)
+        return false;
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const PSNode *nd = nodes[i].get();
+        uint8_t type = nd ? static_cast<uint8_t>(nd->getType()) : NO_NODE;
+        if (type != types[i])
+            return false;
+    }
+
+    // the calls connect the nodes that are in the graph already
+    for (uint64_t i = 0; i < header->callsNum; ++i) {
+        uint32_t callsite = calls[2 * i];
+        uint32_t called = calls[2 * i + 1];
+        if (callsite >= nodes.size() || called >= nodes.size() ||
+            types[callsite] != static_cast<uint8_t>(PSNodeType::CALL_FUNCPTR) ||
+            types[called] != static_cast<uint8_t>(PSNodeType::FUNCTION))
+            return false;
+    }
+
+    return true;
+}
+
+bool PointsToCache::restore(PointerSubgraph& PS) const {
+    assert(isOpen());
+    const auto& nodes = PS.getNodes();
+    if (nodes.size() != header->nodesNum)
+        return false;
+
+    // check the whole graph first, so that we do not change
+    // anything if the graph is not the same
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const PSNode *nd = nodes[i].get();
+        uint8_t type = nd ? static_cast<uint8_t>(nd->getType()) : NO_NODE;
+        if (type != types[i] || index[i] > index[i + 1])
+            return false;
+
+        for (uint64_t p = index[i]; p < index[i + 1]; ++p) {
+            if (!getTarget(PS, pointers[p].target))
+                return false;
+        }
+    }
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        PSNode *nd = nodes[i].get();
+        if (!nd)
+            continue;
+
+        for (uint64_t p = index[i]; p < index[i + 1]; ++p)
+            nd->addPointsTo(getTarget(PS, pointers[p].target),
+                            pointers[p].offset);
+
+        if (flags[i] & FLAG_COLLAPSED) {
+            if (PSNodeAlloc *alloc = PSNodeAlloc::get(nd))
+                alloc->setIsCollapsed();
+        }
+    }
+
+    return true;
+}
+
+uint64_t PointsToCache::hash(const void *bytes, size_t len, uint64_t seed) {
+    const unsigned char *p = static_cast<const unsigned char *>(bytes);
+    uint64_t h = seed;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+
+    return h;
+}
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
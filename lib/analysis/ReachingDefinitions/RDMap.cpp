@@ -9,11 +9,17 @@ namespace dg {
 namespace analysis {
 namespace rd {
 
-class RDNode;
+RDNodesRegistry& RDNodesRegistry::get()
+{
+    // UNKNOWN_MEMORY registers itself during static initialization,
+    // the registry is created on the first use
+    static RDNodesRegistry registry;
+    return registry;
+}
 
-RDMap::RDMap(const RDMap& o)
+unsigned RDNodesSet::id(const RDNode *n)
 {
-    merge(&o);
+    return n->getID();
 }
 
 static bool comp_ds(const DefSite& a, const DefSite& b)
@@ -21,6 +27,77 @@ static bool comp_ds(const DefSite& a, const DefSite& b)
     return a.target < b.target;
 }
 
+// Should the definition 'ds' from the merged map be skipped, because
+// the node overwrites it (strong update)? We do strong updates only
+// if the offset is concrete, because if it is not concrete, we want
+// to do weak update. Also, we don't want to do strong updates for
+// heap allocated objects, since they are all represented by the call site.
+// Sets 'is_unknown' if the definition must be kept as defining
+// an unknown offset.
+static bool isOverwritten(const DefSite& ds, const DefSiteSetT& no_update,
+                          bool strong_update_unknown, bool& is_unknown)
+{
+    // if the memory is defined at unknown offset, we can
+    // still do a strong update provided this is the update
+    // of whole memory (so we need to know the size of the memory).
+    if (strong_update_unknown &&
+        is_unknown && ds.target->getSize() > 0) {
+        // get the writes that should overwrite this definition
+        auto range = std::equal_range(no_update.begin(),
+                                      no_update.end(),
+                                      ds, comp_ds);
+        // XXX: we could check wether all the strong updates
+        // together overwrite the memory, but that could be
+        // to much work. Just check wether there's is just a one
+        // update that overwrites the whole memory
+        for (auto I = range.first; I!= range.second; ++I) {
+            const DefSite& ds2 = *I;
+            assert(ds.target == ds2.target);
+            if (*ds2.offset == 0 && *ds2.len >= ds.target->getSize())
+                return true;
+        }
+    } else if (ds.target->getType() != RDNodeType::DYN_ALLOC) {
+        auto range = std::equal_range(no_update.begin(),
+                                      no_update.end(),
+                                      ds, comp_ds);
+        for (auto I = range.first; I!= range.second; ++I) {
+            const DefSite& ds2 = *I;
+            assert(ds.target == ds2.target);
+            // if the 'no_update' set contains target with unknown
+            // pointer, we should always keep that value
+            // and the value being merged (just all possible definitions)
+            if (ds2.offset.isUnknown()) {
+                is_unknown = true;
+                return false;
+            }
+
+            // targets are the same, check if the what we have
+            // in 'no_update' set overwrites the values that are in
+            // the other map
+            if ((*ds.offset >= *ds2.offset)
+                && (*ds.offset + *ds.len <= *ds2.offset + *ds2.len))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+// add the values from the other map to 'our_vals'
+// and crop the set to UNKNOWN_MEMORY if it is too big.
+// But only in the case that the  DefSite is not also UNKNOWN,
+// because then we would be 'unknown memory defined @ unknown place'
+static bool mergeValues(RDNodesSet& our_vals, const DefSite& ds,
+                        const RDNodesSet& vals, Offset::type max_set_size)
+{
+    bool changed = our_vals.merge(vals);
+    if (max_set_size != Offset::UNKNOWN && !ds.target->isUnknown() &&
+        our_vals.size() > max_set_size)
+        our_vals.makeUnknown();
+
+    return changed;
+}
+
 ///
 // merge @oth map to this map. If given @no_update set,
 // take those definitions as 'overwrites'. That is -
@@ -64,128 +141,108 @@ bool RDMap::merge(const RDMap *oth,
     if (this == oth)
         return false;
 
+    if (merge_unknown)
+        return mergeToUnknown(oth, no_update,
+                              strong_update_unknown, max_set_size);
+
+    // Both maps are sorted, so walk them at once. First merge
+    // the values of def-sites that we already have and gather
+    // the def-sites that we are missing
     bool changed = false;
+    std::vector<const value_type *> missing;
+    auto our = defs.begin();
+    auto our_end = defs.end();
     for (const auto& it : oth->defs) {
         const DefSite& ds = it.first;
         bool is_unknown = ds.offset.isUnknown();
 
         // STRONG UPDATE
-        // --------------------
-        // should we update this def-site (strong update)?
-        // but only if the offset is concrete, because if
-        // it is not concrete, we want to do weak update
-        // Also, we don't want to do strong updates for
-        // heap allocated objects, since they are all represented
-        // by the call site
-        if (no_update) { // do we have anything for strong update at all?
-            // if the memory is defined at unknown offset, we can
-            // still do a strong update provided this is the update
-            // of whole memory (so we need to know the size of the memory).
-            if (strong_update_unknown &&
-                is_unknown && ds.target->getSize() > 0) {
-                // get the writes that should overwrite this definition
-                auto range = std::equal_range(no_update->begin(),
-                                              no_update->end(),
-                                              ds, comp_ds);
-                // XXX: we could check wether all the strong updates
-                // together overwrite the memory, but that could be
-                // to much work. Just check wether there's is just a one
-                // update that overwrites the whole memory
-                bool overwrites_whole_memory = false;
-                for (auto I = range.first; I!= range.second; ++I) {
-                    const DefSite& ds2 = *I;
-                    assert(ds.target == ds2.target);
-                    if (*ds2.offset == 0 && *ds2.len >= ds.target->getSize()) {
-                        overwrites_whole_memory = true;
-                        break;
-                    }
-                }
-
-                // do strong update - just continue the loop without
-                // merging this definition into our map
-                if (overwrites_whole_memory)
-                    continue;
-            } else if (ds.target->getType() != RDNodeType::DYN_ALLOC) {
-                bool skip = false;
-                auto range = std::equal_range(no_update->begin(),
-                                              no_update->end(),
-                                              ds, comp_ds);
-                for (auto I = range.first; I!= range.second; ++I) {
-                    const DefSite& ds2 = *I;
-                    assert(ds.target == ds2.target);
-                    // if the 'no_update' set contains target with unknown
-                    // pointer, we should always keep that value
-                    // and the value being merged (just all possible definitions)
-                    if (ds2.offset.isUnknown()) {
-                        // break no_update skip = true, thus adding
-                        // the values for UNKOWN to our map
-                        is_unknown = true;
-                        break;
-                    }
-
-                    // targets are the same, check if the what we have
-                    // in 'no_update' set overwrites the values that are in
-                    // the other map
-                    if ((*ds.offset >= *ds2.offset)
-                        && (*ds.offset + *ds.len <= *ds2.offset + *ds2.len)) {
-                        skip = true;
-                        break;
-                    }
-                }
-
-                // if values in 'no_update' map overwrite the coresponding values
-                // in the other map, don't update our map
-                if (skip)
-                    continue;
-            }
-        }
+        if (no_update &&
+            isOverwritten(ds, *no_update, strong_update_unknown, is_unknown))
+            continue;
 
-        // MERGE CONCRETE OFFSETS (if desired)
-        // ------------------------------------
-        RDNodesSet *our_vals = nullptr;
-        if (merge_unknown && is_unknown) {
-            // this loop finds all concrete offsets and merges them into one
-            // defsite with Offset::UNKNOWN. This defsite is set in 'our_vals'
-            // after the loop exit
-            our_vals = &defs[DefSite(ds.target, Offset::UNKNOWN, Offset::UNKNOWN)];
-
-            auto range = getObjectRange(ds);
-            for (auto I = range.first; I != range.second;) {
-                auto cur = I++;
-
-                // this must hold (getObjectRange)
-                assert(cur->first.target == ds.target);
-
-                // don't remove the one with Offset::UNKNOWN
-                if (&cur->second == our_vals)
-                    continue;
-
-                // merge values with concrete offset to
-                // this unknown offset
-                for (RDNode *defnode : cur->second)
-                    changed |= our_vals->insert(defnode);
-
-                // erase the def-site with concrete offset
-                defs.erase(cur);
-            }
+        while (our != our_end && our->first < ds)
+            ++our;
 
-            // fall-through to add the new definitions from the other map
+        if (our != our_end && our->first == ds) {
+            changed |= mergeValues(our->second, ds, it.second, max_set_size);
+            ++our;
         } else {
-            // our values that we have for this definition-site
-            our_vals = &defs[ds];
+            missing.push_back(&it);
         }
+    }
 
-        assert(our_vals && "BUG");
+    if (missing.empty())
+        return changed;
+
+    // now put the missing def-sites to their places from the back,
+    // so that we move every def-site at most once
+    size_t i = defs.size();
+    size_t j = missing.size();
+    defs.reserve(i + j);
+    for (const value_type *m : missing)
+        defs.emplace_back(m->first, RDNodesSet());
+
+    size_t k = defs.size();
+    while (j > 0) {
+        const value_type *m = missing[j - 1];
+        if (i > 0 && m->first < defs[i - 1].first) {
+            defs[--k] = std::move(defs[--i]);
+        } else {
+            value_type& entry = defs[--k];
+            entry.first = m->first;
+            entry.second.clear();
+            changed |= mergeValues(entry.second, m->first,
+                                   m->second, max_set_size);
+            --j;
+        }
+    }
+    assert(k == i && "Merged wrong number of def-sites");
 
-        // copy values that have the map 'oth' for the defsite 'ds' to our map
-        for (RDNode *defnode : it.second)
-            changed |= our_vals->insert(defnode);
+    return changed;
+}
 
-        // crop the set to UNKNOWN_MEMORY if it is too big.
-        // But only in the case that the  DefSite is not also UNKNOWN,
-        // because then we would be 'unknown memory defined @ unknown place'
-        if (!ds.target->isUnknown() && our_vals->size() > max_set_size)
-            our_vals->makeUnknown();
+// the same as merge(), but all definitions with concrete offsets
+// are merged into the definition with unknown offset once
+// the definition with unknown offset is found
+bool RDMap::mergeToUnknown(const RDMap *oth,
+                           DefSiteSetT *no_update,
+                           bool strong_update_unknown,
+                           Offset::type max_set_size)
+{
+    bool changed = false;
+    for (const auto& it : oth->defs) {
+        const DefSite& ds = it.first;
+        bool is_unknown = ds.offset.isUnknown();
+
+        if (no_update &&
+            isOverwritten(ds, *no_update, strong_update_unknown, is_unknown))
+            continue;
+
+        if (!is_unknown) {
+            changed |= mergeValues(get(ds), ds, it.second, max_set_size);
+            continue;
+        }
+
+        // this loop finds all concrete offsets and merges them into one
+        // defsite with Offset::UNKNOWN. The def-site with Offset::UNKNOWN
+        // is the last one in the range of the target
+        DefSite uds(ds.target, Offset::UNKNOWN, Offset::UNKNOWN);
+        get(uds);
+        auto range = getObjectRange(uds);
+        assert(range.first != range.second);
+        auto last = range.second - 1;
+        assert(last->first == uds);
+
+        for (auto I = range.first; I != last; ++I) {
+            // this must hold (getObjectRange)
+            assert(I->first.target == ds.target);
+            changed |= last->second.merge(I->second);
+        }
+
+        // erase the def-sites with concrete offset
+        last = defs.erase(range.first, last);
+        changed |= mergeValues(last->second, uds, it.second, max_set_size);
     }
 
     return changed;
@@ -193,13 +250,13 @@ bool RDMap::merge(const RDMap *oth,
 
 bool RDMap::add(const DefSite& p, RDNode *n)
 {
-    return defs[p].insert(n);
+    return get(p).insert(n);
 }
 
 bool RDMap::update(const DefSite& p, RDNode *n)
 {
     bool ret;
-    RDNodesSet& dfs = defs[p];
+    RDNodesSet& dfs = get(p);
 
     ret = dfs.count(n) == 0 || dfs.size() > 1;
     dfs.clear();
@@ -208,6 +265,26 @@ bool RDMap::update(const DefSite& p, RDNode *n)
     return ret;
 }
 
+static bool lessDefSite(const RDMap::value_type& a, const DefSite& ds)
+{
+    return a.first < ds;
+}
+
+RDMap::const_iterator RDMap::find(const DefSite& ds) const
+{
+    auto it = std::lower_bound(defs.begin(), defs.end(), ds, lessDefSite);
+    return it != defs.end() && it->first == ds ? it : defs.end();
+}
+
+RDNodesSet& RDMap::get(const DefSite& ds)
+{
+    auto it = std::lower_bound(defs.begin(), defs.end(), ds, lessDefSite);
+    if (it != defs.end() && it->first == ds)
+        return it->second;
+
+    return defs.emplace(it, ds, RDNodesSet())->second;
+}
+
 bool RDMap::definesWithAnyOffset(const DefSite& ds)
 {
     auto range = getObjectRange(ds);
@@ -247,17 +324,27 @@ size_t RDMap::get(DefSite& ds, std::set<RDNode *>& ret)
 }
 
 
-static inline bool comp(const std::pair<const DefSite, RDNodesSet>& a,
-                        const std::pair<const DefSite, RDNodesSet>& b)
+static inline bool lessTarget(const RDMap::value_type& a, RDNode *target)
+{
+    return a.first.target < target;
+}
+
+static inline bool greaterTarget(RDNode *target, const RDMap::value_type& a)
+{
+    return target < a.first.target;
+}
+
+std::pair<RDMap::iterator, RDMap::iterator>
+RDMap::getObjectRange(RDNode *target)
 {
-    return a.first.target < b.first.target;
+    auto first = std::lower_bound(defs.begin(), defs.end(), target, lessTarget);
+    return {first, std::upper_bound(first, defs.end(), target, greaterTarget)};
 }
 
 std::pair<RDMap::iterator, RDMap::iterator>
 RDMap::getObjectRange(const DefSite& ds)
 {
-    std::pair<const DefSite, RDNodesSet> what(ds, RDNodesSet());
-    return std::equal_range(defs.begin(), defs.end(), what, comp);
+    return getObjectRange(ds.target);
 }
 
 } // rd
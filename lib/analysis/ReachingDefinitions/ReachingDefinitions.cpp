@@ -1,4 +1,9 @@
+#include <algorithm>
+#include <functional>
+#include <queue>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include "dg/analysis/ReachingDefinitions/RDMap.h"
 #include "dg/analysis/ReachingDefinitions/ReachingDefinitions.h"
@@ -10,50 +15,196 @@ namespace rd {
 RDNode UNKNOWN_MEMLOC;
 RDNode *UNKNOWN_MEMORY = &UNKNOWN_MEMLOC;
 
-bool ReachingDefinitionsAnalysis::processNode(RDNode *node)
+// merge the maps of the predecessors of 'node' to the map 'to'
+static bool mergePredecessors(RDNode *node, RDMap& to,
+                              DefSiteSetT *overwrites,
+                              bool strongUpdateUnknown,
+                              Offset::type maxSetSize)
 {
     bool changed = false;
 
-    // merge maps from predecessors
-    for (RDNode *n : node->predecessors)
-        changed |= node->def_map.merge(&n->def_map,
-                                       &node->overwrites /* strong update */,
-                                       options.strongUpdateUnknown,
-                                       *options.maxSetSize, /* max size of set of reaching definition
-                                                              of one definition site */
-                                       false /* merge unknown */);
+    for (RDNode *n : node->getPredecessors())
+        changed |= to.merge(&n->def_map,
+                            overwrites /* strong update */,
+                            strongUpdateUnknown,
+                            maxSetSize, /* max size of set of reaching definition
+                                           of one definition site */
+                            false /* merge unknown */);
 
     return changed;
 }
 
+bool ReachingDefinitionsAnalysis::processNode(RDNode *node)
+{
+    statistics.mergesNum += node->getPredecessors().size();
+    return mergePredecessors(node, node->def_map, &node->overwrites,
+                             options.strongUpdateUnknown, *options.maxSetSize);
+}
+
+void RDNodesChain::materialize()
+{
+    // the last node has the definitions computed by the analysis,
+    // the maps of the other nodes contain just their own definitions
+    for (size_t i = 0; i + 1 < nodes.size(); ++i) {
+        RDNode *node = nodes[i];
+        mergePredecessors(node, node->def_map, &node->overwrites,
+                          strongUpdateUnknown, maxSetSize);
+    }
+
+    materialized = true;
+}
+
+std::vector<RDNode *> ReachingDefinitionsAnalysis::getNodesRPO()
+{
+    assert(root && "Do not have root");
+
+    ++dfsnum;
+
+    std::vector<RDNode *> nodes;
+    // the nodes on the DFS stack with the index of the next successor
+    std::vector<std::pair<RDNode *, size_t>> stack;
+    stack.emplace_back(root, 0);
+    root->dfsid = dfsnum;
+
+    while (!stack.empty()) {
+        RDNode *cur = stack.back().first;
+        size_t& succIdx = stack.back().second;
+        if (succIdx < cur->successors.size()) {
+            RDNode *succ = cur->successors[succIdx++];
+            if (succ->dfsid != dfsnum) {
+                succ->dfsid = dfsnum;
+                stack.emplace_back(succ, 0);
+            }
+        } else {
+            nodes.push_back(cur);
+            stack.pop_back();
+        }
+    }
+
+    std::reverse(nodes.begin(), nodes.end());
+    return nodes;
+}
+
+std::vector<std::shared_ptr<RDNodesChain>>
+ReachingDefinitionsAnalysis::getBlocks(const std::vector<RDNode *>& nodes)
+{
+    // does the previous node continue to this node?
+    auto continues = [](RDNode *node) {
+        if (node->getPredecessors().size() != 1)
+            return false;
+        RDNode *pred = node->getPredecessors()[0];
+        return pred != node && pred->getSuccessors().size() == 1;
+    };
+
+    std::vector<std::shared_ptr<RDNodesChain>> blocks;
+    for (RDNode *node : nodes) {
+        if (node != root && continues(node))
+            continue;
+
+        // the nodes of the block follow the first node
+        // in the reverse postorder
+        auto block = std::make_shared<RDNodesChain>();
+        block->strongUpdateUnknown = options.strongUpdateUnknown;
+        block->maxSetSize = *options.maxSetSize;
+        node->blockOrder = blocks.size();
+
+        RDNode *cur = node;
+        block->nodes.push_back(cur);
+        while (cur->getSuccessors().size() == 1) {
+            RDNode *succ = cur->getSuccessors()[0];
+            if (succ == root || !continues(succ))
+                break;
+
+            cur = succ;
+            block->nodes.push_back(cur);
+        }
+
+        blocks.push_back(std::move(block));
+    }
+
+    return blocks;
+}
+
 void ReachingDefinitionsAnalysis::run()
 {
     assert(root && "Do not have root");
 
-    std::vector<RDNode *> to_process = getNodes(root);
-    std::vector<RDNode *> changed;
+    statistics = ReachingDefinitionsStatistics();
 
-    // do fixpoint
-    do {
-        unsigned last_processed_num = to_process.size();
-        changed.clear();
+    std::vector<std::shared_ptr<RDNodesChain>> blocks = getBlocks(getNodesRPO());
+    statistics.blocksNum = blocks.size();
+
+    // Compute the summaries of the blocks with more nodes. The last node
+    // gets the definitions generated in the block (as if no definitions
+    // reached the block) and the block gets the def-sites overwritten
+    // by any of its nodes. Then only the last node takes part
+    // in the fixpoint -- merging the definitions that reach the block
+    // to it with the overwritten def-sites is the same as merging them
+    // node by node.
+    for (auto& block : blocks) {
+        if (block->nodes.size() == 1)
+            continue;
+
+        RDMap gen;
+        for (RDNode *node : block->nodes) {
+            RDMap defs(node->def_map);
+            defs.merge(&gen, &node->overwrites,
+                       options.strongUpdateUnknown, *options.maxSetSize);
+            gen = std::move(defs);
 
-        for (RDNode *cur : to_process) {
-            if (processNode(cur))
-                changed.push_back(cur);
+            block->overwrites.insert(node->overwrites.begin(),
+                                     node->overwrites.end());
+            node->chain = block;
         }
 
-        if (!changed.empty()) {
-            to_process.clear();
-            to_process = getNodes(nullptr /* starting node */,
-                                  &changed /* starting set */,
-                                  last_processed_num /* expected num */);
+        block->nodes.back()->def_map = std::move(gen);
+    }
+
+    // the worklist of the blocks (their order in RPO), the first block
+    // in RPO goes first. At the beginning, every block is processed once.
+    std::vector<unsigned> initial(blocks.size());
+    for (unsigned i = 0; i < blocks.size(); ++i)
+        initial[i] = i;
+    std::priority_queue<unsigned, std::vector<unsigned>,
+                        std::greater<unsigned>> worklist(std::greater<unsigned>(),
+                                                         std::move(initial));
+    std::vector<bool> queued(blocks.size(), true);
+
+    // do fixpoint
+    unsigned last = 0;
+    statistics.iterationsNum = 1;
+    while (!worklist.empty()) {
+        unsigned cur = worklist.top();
+        worklist.pop();
+        queued[cur] = false;
+
+        if (cur < last)
+            ++statistics.iterationsNum;
+        last = cur;
+
+        RDNodesChain *block = blocks[cur].get();
+        RDNode *first = block->nodes.front();
+        RDNode *end = block->nodes.back();
+        DefSiteSetT *overwrites = block->nodes.size() == 1 ?
+                                    &first->overwrites : &block->overwrites;
+
+        ++statistics.processedBlocks;
+        statistics.mergesNum += first->getPredecessors().size();
+        if (!mergePredecessors(first, end->def_map, overwrites,
+                               options.strongUpdateUnknown,
+                               *options.maxSetSize))
+            continue;
 
-            // since changed was not empty,
-            // the to_process must not be empty too
-            assert(!to_process.empty());
+        // only the successors of changed blocks can change
+        ++statistics.changedBlocks;
+        for (RDNode *succ : end->getSuccessors()) {
+            assert(succ->dfsid == dfsnum && "Successor was not numbered");
+            if (!queued[succ->blockOrder]) {
+                queued[succ->blockOrder] = true;
+                worklist.push(succ->blockOrder);
+            }
         }
-    } while (!changed.empty());
+    }
 }
 
 } // namespace rd
@@ -1,3 +1,5 @@
+#include <thread>
+
 #include "analysis/ReachingDefinitions/Srg/MarkerSRGBuilderFS.h"
 
 using namespace dg::analysis::rd::srg;
@@ -270,3 +272,97 @@ MarkerSRGBuilderFS::NodeT *MarkerSRGBuilderFS::readUnknown(BlockT *read, std::un
     // TODO: return also coverage information
     return ptr;
 }
+
+std::vector<std::unordered_set<MarkerSRGBuilderFS::NodeT *>>
+MarkerSRGBuilderFS::partitionVariables(const std::vector<BlockT *>& cfg) const {
+    // the variables in the order in which we found them
+    // and the number of their uses and definitions
+    struct VarInfo {
+        NodeT *var;
+        size_t uses;
+        size_t accesses;
+    };
+    std::vector<VarInfo> vars;
+    std::unordered_map<NodeT *, size_t> index;
+
+    auto getInfo = [&](NodeT *var) -> VarInfo& {
+        auto it = index.emplace(var, vars.size());
+        if (it.second)
+            vars.push_back(VarInfo{var, 0, 0});
+        return vars[it.first->second];
+    };
+
+    for (BlockT *BB : cfg) {
+        for (NodeT *node : BB->getNodes()) {
+            for (const DefSite& use : node->getUses()) {
+                // reading unknown memory looks for the definitions
+                // of all variables at once, we can not split it
+                if (use.target == UNKNOWN_MEMORY)
+                    return {};
+
+                VarInfo& info = getInfo(use.target);
+                ++info.uses;
+                ++info.accesses;
+            }
+
+            for (const DefSite& def : node->defs) {
+                if (def.target != UNKNOWN_MEMORY)
+                    ++getInfo(def.target).accesses;
+            }
+        }
+    }
+
+    // the variables that are never read have no edges in the graph
+    vars.erase(std::remove_if(vars.begin(), vars.end(),
+                              [](const VarInfo& info) { return info.uses == 0; }),
+               vars.end());
+
+    size_t num = std::min<size_t>(threads, vars.size());
+    if (num < 2) {
+        return {};
+    }
+
+    // give the variables with the most accesses first,
+    // always to the group that has the least accesses so far
+    std::stable_sort(vars.begin(), vars.end(),
+                     [](const VarInfo& a, const VarInfo& b) { return a.accesses > b.accesses; });
+
+    std::vector<std::unordered_set<NodeT *>> groups(num);
+    std::vector<size_t> accesses(num, 0);
+    for (const VarInfo& info : vars) {
+        size_t smallest = std::min_element(accesses.begin(), accesses.end()) - accesses.begin();
+        groups[smallest].insert(info.var);
+        accesses[smallest] += info.accesses;
+    }
+
+    return groups;
+}
+
+void MarkerSRGBuilderFS::buildParallel(const std::vector<BlockT *>& cfg, std::vector<std::unordered_set<NodeT *>>& groups) {
+    std::vector<std::unique_ptr<MarkerSRGBuilderFS>> builders;
+    for (auto& group : groups) {
+        builders.emplace_back(new MarkerSRGBuilderFS());
+        builders.back()->variables = std::move(group);
+    }
+
+    // the calling thread builds the first group
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < builders.size(); ++i) {
+        workers.emplace_back(&MarkerSRGBuilderFS::buildBlocks, builders[i].get(), std::cref(cfg));
+    }
+    builders[0]->buildBlocks(cfg);
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // the groups do not share any variable, so the edges
+    // of the groups just add up (in the order of the groups)
+    for (auto& builder : builders) {
+        for (auto& it : builder->srg) {
+            auto& edges = srg[it.first];
+            edges.insert(edges.end(), it.second.begin(), it.second.end());
+        }
+        std::move(builder->phi_nodes.begin(), builder->phi_nodes.end(), std::back_inserter(phi_nodes));
+    }
+}
@@ -45,6 +45,35 @@ class MarkerSRGBuilderFS : public SparseRDGraphBuilder
     DefMapT current_weak_def;
     DefMapT last_weak_def;
 
+    /* the number of threads that build the graph */
+    unsigned threads;
+    /* the number of groups of variables built in parallel by the last build() */
+    size_t groupsNum{0};
+
+    /*
+     * the variables that this builder takes care of (all if empty).
+     * Definitions of unknown memory are taken into account always,
+     * as they may define any variable.
+     */
+    std::unordered_set<NodeT *> variables;
+
+    bool isHandled(NodeT *target) const {
+        return variables.empty() || target == UNKNOWN_MEMORY || variables.count(target) > 0;
+    }
+
+    /**
+     * Split the variables used in @cfg into (at most) @threads groups
+     * of similar size that can be built independently.
+     * Returns no groups if the graph can not be built in parallel.
+     */
+    std::vector<std::unordered_set<NodeT *>> partitionVariables(const std::vector<BlockT *>& cfg) const;
+
+    /**
+     * Build the graph for every group of variables in its own thread
+     * and merge the results to @srg and @phi_nodes.
+     */
+    void buildParallel(const std::vector<BlockT *>& cfg, std::vector<std::unordered_set<NodeT *>>& groups);
+
     /**
      * Remember strong definition @assignment of a @var in @block.
      * Side-effect: kill current overlapping strong definitions and current overlapping weak definitions.
@@ -126,6 +155,8 @@ class MarkerSRGBuilderFS : public SparseRDGraphBuilder
     void performLvn(BlockT *block) {
         for (NodeT *node : block->getNodes()) {
             for (const DefSite& def : node->defs) {
+                if (!isHandled(def.target))
+                    continue;
                 if (node->isOverwritten(def) && !def.offset.isUnknown()) {
                     detail::Interval interval = concretize(detail::Interval{def.offset, def.len}, def.target->getSize());
                     last_def[def.target][block].killOverlapping(interval);
@@ -141,6 +172,8 @@ class MarkerSRGBuilderFS : public SparseRDGraphBuilder
     void performGvn(BlockT *block) {
         for (NodeT *node : block->getNodes()) {
             for (const DefSite& use : node->getUses()) {
+                if (!isHandled(use.target))
+                    continue;
                 // remember uses of unknown memory
                std::vector<NodeT *> assignments = readVariable(use, block, block);
                 // add edge from last definition to here
@@ -150,6 +183,8 @@ class MarkerSRGBuilderFS : public SparseRDGraphBuilder
             }
 
             for (const DefSite& def : node->defs) {
+                if (!isHandled(def.target))
+                    continue;
                 if (node->isOverwritten(def) && !def.offset.isUnknown()) {
                     writeVariableStrong(def, node, block);
                 } else {
@@ -159,8 +194,25 @@ class MarkerSRGBuilderFS : public SparseRDGraphBuilder
         }
     }
 
+    void buildBlocks(const std::vector<BlockT *>& cfg) {
+        // local value numbering
+        for (BlockT *BB : cfg) {
+            performLvn(BB);
+        }
+
+        // global value numbering
+        for (BlockT *BB : cfg) {
+            performGvn(BB);
+        }
+    }
+
 public:
 
+    MarkerSRGBuilderFS(unsigned threads = 1) : threads(threads) {}
+
+    /* 0 if the graph was built sequentially */
+    size_t getGroupsNum() const { return groupsNum; }
+
     std::pair<SparseRDGraph, std::vector<std::unique_ptr<NodeT>>>
         build(NodeT *root) override {
 
@@ -174,15 +226,15 @@ public:
             cfg.push_back(block);
         }, nullptr);
 
-        // local value numbering
-        for (BlockT *BB : cfg) {
-            performLvn(BB);
-        }
+        std::vector<std::unordered_set<NodeT *>> groups;
+        if (threads > 1)
+            groups = partitionVariables(cfg);
 
-        // global value numbering
-        for (BlockT *BB : cfg) {
-            performGvn(BB);
-        }
+        groupsNum = groups.size() > 1 ? groups.size() : 0;
+        if (groups.size() > 1)
+            buildParallel(cfg, groups);
+        else
+            buildBlocks(cfg);
 
         return std::make_pair<SparseRDGraph, std::vector<std::unique_ptr<NodeT>>>(std::move(srg), std::move(phi_nodes));
     }
@@ -3,7 +3,8 @@
 #include "analysis/ReachingDefinitions/Srg/MarkerSRGBuilderFS.h"
 #include "analysis/ReachingDefinitions/Srg/SparseRDGraphBuilder.h"
 
-#include <unordered_set>
+#include <algorithm>
+#include <unordered_map>
 
 namespace dg {
 namespace analysis {
@@ -12,53 +13,234 @@ namespace rd {
 using SrgBuilder = dg::analysis::rd::srg::MarkerSRGBuilderFS;
 using SparseRDGraph = dg::analysis::rd::srg::SparseRDGraph;
 
-template< typename T >
-static void bfs(RDNode *from, SparseRDGraph& srg, T&& visitor) {
-    std::unordered_set<RDNode *> visited;
-    std::queue<RDNode *> q;
-    q.push(from);
-    visited.insert(from);
-
-    while (!q.empty()) {
-        RDNode *n = q.front();
-        q.pop();
-        auto edges_it = srg.find(n);
-        if (edges_it != srg.end()) {
-            auto& edges = edges_it->second;
-            for (auto& edge : edges) {
-                RDNode *src = edge.second;
-                if (visited.insert(src).second) {
-                    visitor(edge.first, edge.second);
-                    q.push(src);
+namespace {
+
+///
+// Propagation of definitions over the sparse RD graph. The edges
+// go from the uses (and PHI nodes) to the definitions that reach them,
+// so a node is reached by everything that is reachable from it in
+// the graph. All the nodes of one strongly connected component reach
+// the same definitions, therefore we compute the definitions once
+// for every component and the components reachable from it
+// are reused instead of searching the graph again for every use.
+// The components are found by Tarjan's algorithm, which finishes
+// the components in reverse topological order, so the definitions
+// of the successors of a component are known when we get to it.
+class SrgPropagation
+{
+    enum : unsigned { NO_COMPONENT = ~0u };
+
+    struct NodeInfo {
+        unsigned dfs_id{0};
+        unsigned lowpt{0};
+        unsigned component{NO_COMPONENT};
+        bool on_stack{false};
+    };
+
+    SparseRDGraph& srg;
+    std::unordered_map<RDNode *, NodeInfo> info;
+    unsigned index{0};
+    std::vector<std::vector<RDNode *>> components;
+
+    // the definitions that reach the nodes of the components
+    std::vector<RDMap> reaching;
+    // the number of components that did not take the definitions
+    // of the component yet, we drop the definitions when it gets to 0
+    std::vector<unsigned> users;
+
+    static bool isUse(RDNode *n) {
+        return n->getUses().size() > 0 && n->getType() != RDNodeType::PHI;
+    }
+
+    const std::vector<std::pair<DefSite, RDNode *>> *getEdges(RDNode *n) {
+        auto it = srg.find(n);
+        return it == srg.end() ? nullptr : &it->second;
+    }
+
+    // the definitions that come to the use of 'var' from 'def'.
+    // These are the definitions of the same memory that 'def' makes
+    // (or any if one of the memory is unknown)
+    static void addDefinitions(RDMap& to, const DefSite& var, RDNode *def) {
+        if (def->getType() == RDNodeType::PHI)
+            return;
+
+        to.add(var, def);
+        for (const DefSite& ds : def->getDefines()) {
+            if (ds.target == var.target || ds.target == UNKNOWN_MEMORY ||
+                var.target == UNKNOWN_MEMORY)
+                to.add(ds, def);
+        }
+    }
+
+    // Tarjan's algorithm without recursion, the graphs of the whole
+    // programs are too deep for that
+    void computeComponents(RDNode *start) {
+        struct Frame {
+            RDNode *node;
+            const std::vector<std::pair<DefSite, RDNode *>> *edges;
+            size_t next;
+        };
+
+        std::vector<Frame> frames;
+        std::vector<RDNode *> stack;
+
+        auto enter = [&](RDNode *n) {
+            NodeInfo& ni = info[n];
+            ni.dfs_id = ni.lowpt = ++index;
+            ni.on_stack = true;
+            stack.push_back(n);
+            frames.push_back(Frame{n, getEdges(n), 0});
+        };
+
+        if (info[start].dfs_id != 0)
+            return;
+
+        enter(start);
+        while (!frames.empty()) {
+            Frame& frame = frames.back();
+            if (frame.edges && frame.next < frame.edges->size()) {
+                RDNode *succ = (*frame.edges)[frame.next++].second;
+                // the definitions without uses are not interesting
+                // on their own, we take them from the edges
+                if (!getEdges(succ))
+                    continue;
+
+                NodeInfo& si = info[succ];
+                if (si.dfs_id == 0) {
+                    enter(succ);
+                } else if (si.on_stack) {
+                    NodeInfo& ni = info[frame.node];
+                    ni.lowpt = std::min(ni.lowpt, si.dfs_id);
                 }
+                continue;
+            }
+
+            RDNode *n = frame.node;
+            frames.pop_back();
+            NodeInfo& ni = info[n];
+            if (!frames.empty()) {
+                NodeInfo& pi = info[frames.back().node];
+                pi.lowpt = std::min(pi.lowpt, ni.lowpt);
+            }
+
+            if (ni.lowpt != ni.dfs_id)
+                continue;
+
+            unsigned num = static_cast<unsigned>(components.size());
+            components.emplace_back();
+            RDNode *w;
+            do {
+                w = stack.back();
+                stack.pop_back();
+                NodeInfo& wi = info[w];
+                wi.on_stack = false;
+                wi.component = num;
+                components.back().push_back(w);
+            } while (w != n);
+        }
+    }
+
+    unsigned getComponent(RDNode *n) const {
+        auto it = info.find(n);
+        return it == info.end() ? NO_COMPONENT : it->second.component;
+    }
+
+    // call f(c) for every component other than 'num'
+    // that is reachable by an edge from the component 'num'
+    template <typename F>
+    void forEachSuccessor(unsigned num, std::vector<unsigned>& seen, F f) {
+        for (RDNode *n : components[num]) {
+            for (auto& edge : srg[n]) {
+                unsigned c = getComponent(edge.second);
+                if (c == NO_COMPONENT || c == num || seen[c] == num)
+                    continue;
+                seen[c] = num;
+                f(c);
             }
         }
-        visited.insert(n);
     }
-}
+
+    bool isCyclic(unsigned num) {
+        if (components[num].size() > 1)
+            return true;
+
+        RDNode *n = components[num][0];
+        for (auto& edge : srg[n]) {
+            if (edge.second == n)
+                return true;
+        }
+        return false;
+    }
+
+public:
+    SrgPropagation(SparseRDGraph& srg) : srg(srg) {}
+
+    void run() {
+        for (auto& pair : srg) {
+            if (isUse(pair.first))
+                computeComponents(pair.first);
+        }
+
+        reaching.resize(components.size());
+        users.assign(components.size(), 0);
+        std::vector<unsigned> seen(components.size(), NO_COMPONENT);
+        for (unsigned num = 0; num < components.size(); ++num) {
+            forEachSuccessor(num, seen, [&](unsigned c) { ++users[c]; });
+        }
+
+        std::fill(seen.begin(), seen.end(), NO_COMPONENT);
+        for (unsigned num = 0; num < components.size(); ++num) {
+            RDMap& defs = reaching[num];
+            for (RDNode *n : components[num]) {
+                for (auto& edge : srg[n])
+                    addDefinitions(defs, edge.first, edge.second);
+            }
+
+            forEachSuccessor(num, seen, [&](unsigned c) {
+                defs.merge(&reaching[c]);
+                if (--users[c] == 0)
+                    reaching[c] = RDMap();
+            });
+
+            bool cyclic = isCyclic(num);
+            for (RDNode *n : components[num]) {
+                if (!isUse(n))
+                    continue;
+
+                if (!cyclic) {
+                    n->def_map.merge(&defs);
+                    continue;
+                }
+
+                // the use reaches itself, but it is not
+                // its own reaching definition
+                for (auto& it : defs) {
+                    for (RDNode *def : it.second) {
+                        if (def != n)
+                            n->def_map.add(it.first, def);
+                    }
+                }
+            }
+
+            if (users[num] == 0)
+                reaching[num] = RDMap();
+        }
+    }
+};
+
+} // anonymous namespace
 
 void SemisparseRda::run()
 {
-    SrgBuilder srg_builder;
+    SrgBuilder srg_builder(options.threads);
     SparseRDGraph srg;
 
-    std::unordered_set<RDNode *> to_process;
     std::tie(srg, phi_nodes) = srg_builder.build(root);
+    statistics.groupsNum = srg_builder.getGroupsNum();
 
-    for (auto& pair : srg) {
-        RDNode *dest = pair.first;
-        if (dest->getUses().size() > 0 && dest->getType() != RDNodeType::PHI) {
-            bfs(dest, srg, [&](DefSite& ds, RDNode *n){
-                if (n->getType() != RDNodeType::PHI) {
-                    merge_maps(n, dest, ds);
-                }
-            });
-        }
-    }
+    SrgPropagation(srg).run();
 }
 
 } // namespace rd
 } // namespace analysis
 } // namespace dg
-
-
@@ -149,7 +149,7 @@ private:
             } else {
                 auto& defs = rd->getReachingDefinitions();
                 for (auto& it : defs) {
-                    for (auto& nd : it.second) {
+                    for (analysis::rd::RDNode *nd : it.second) {
                         printDefSite(it.first, os, "RD: ");
                         os << " @ ";
                         if (nd->isUnknown())
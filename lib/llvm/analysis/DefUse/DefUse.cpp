@@ -322,7 +322,7 @@ void LLVMDefUseAnalysis::addDataDependence(LLVMNode *node, PSNode *pts,
         llvm::Value *llvmVal = ptr.target->getUserData<llvm::Value>();
         assert(llvmVal && "Don't have Value in PSNode");
 
-        RDNode *val = RD->getNode(llvmVal);
+        RDNode *val = RD->getTargetNode(ptr.target);
         if(!val) {
             if (reported_mappings.insert(llvmVal).second)
                 llvmutils::printerr("DEF-USE: no information for: ", llvmVal);
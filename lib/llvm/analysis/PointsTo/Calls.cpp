@@ -71,8 +71,8 @@ LLVMPointerSubgraphBuilder::createFuncptrCall(const llvm::CallInst *CInst, const
         // when the pointers are resolved during analysis, the graph
         // will be dynamically created and it will replace these nodes
         PSNode *op = getOperand(calledVal);
-        PSNode *call_funcptr = PS.create(PSNodeType::CALL_FUNCPTR, op);
-        PSNode *ret_call = PS.create(PSNodeType::CALL_RETURN, nullptr);
+        PSNode *call_funcptr = PS.create<PSNodeType::CALL_FUNCPTR>(op);
+        PSNode *ret_call = PS.create<PSNodeType::CALL_RETURN>();
 
         ret_call->setPairedNode(call_funcptr);
         call_funcptr->setPairedNode(ret_call);
@@ -90,7 +90,7 @@ LLVMPointerSubgraphBuilder::createUnknownCall(const llvm::CallInst *CInst)
     // inside bitcast - it defaults to int, but is bitcased
     // to pointer
     //assert(CInst->getType()->isPointerTy());
-    PSNode *call = PS.create(PSNodeType::CALL, nullptr);
+    PSNode *call = PS.create<PSNodeType::CALL>();
 
     call->setPairedNode(call);
 
@@ -122,8 +122,7 @@ PSNode *LLVMPointerSubgraphBuilder::createMemTransfer(const llvm::IntrinsicInst
 
     PSNode *destNode = getOperand(dest);
     PSNode *srcNode = getOperand(src);
-    PSNode *node = PS.create(PSNodeType::MEMCPY,
-                              srcNode, destNode, lenVal);
+    PSNode *node = PS.create<PSNodeType::MEMCPY>(srcNode, destNode, lenVal);
 
     addNode(I, node);
     return node;
@@ -142,8 +141,8 @@ LLVMPointerSubgraphBuilder::createMemSet(const llvm::Instruction *Inst)
 
     PSNode *op = getOperand(Inst->getOperand(0)->stripInBoundsOffsets());
     // we need to make unknown offsets
-    PSNode *G = PS.create(PSNodeType::GEP, op, Offset::UNKNOWN);
-    PSNode *S = PS.create(PSNodeType::STORE, val, G);
+    PSNode *G = PS.create<PSNodeType::GEP>(op, Offset::UNKNOWN);
+    PSNode *S = PS.create<PSNodeType::STORE>(val, G);
     G->addSuccessor(S);
 
     PSNodesSeq ret = PSNodesSeq(G, S);
@@ -170,7 +169,7 @@ LLVMPointerSubgraphBuilder::createVarArg(const llvm::IntrinsicInst *Inst)
     // vastart will be node that will keep the memory
     // with pointers, its argument is the alloca, that
     // alloca will keep pointer to vastart
-    PSNode *vastart = PS.create(PSNodeType::ALLOC);
+    PSNode *vastart = PS.create<PSNodeType::ALLOC>();
 
     // vastart has only one operand which is the struct
     // it uses for storing the va arguments. Strip it so that we'll
@@ -183,10 +182,10 @@ LLVMPointerSubgraphBuilder::createVarArg(const llvm::IntrinsicInst *Inst)
     // get node with the same pointer, but with Offset::UNKNOWN
     // FIXME: we're leaking it
     // make the memory in alloca point to our memory in vastart
-    PSNode *ptr = PS.create(PSNodeType::GEP, op, Offset::UNKNOWN);
-    PSNode *S1 = PS.create(PSNodeType::STORE, vastart, ptr);
+    PSNode *ptr = PS.create<PSNodeType::GEP>(op, Offset::UNKNOWN);
+    PSNode *S1 = PS.create<PSNodeType::STORE>(vastart, ptr);
     // and also make vastart point to the vararg args
-    PSNode *S2 = PS.create(PSNodeType::STORE, arg, vastart);
+    PSNode *S2 = PS.create<PSNodeType::STORE>(arg, vastart);
 
     vastart->addSuccessor(ptr);
     ptr->addSuccessor(S1);
@@ -255,7 +254,7 @@ LLVMPointerSubgraphBuilder::createAsm(const llvm::Instruction *Inst)
         warned = true;
     }
 
-    PSNode *n = PS.create(PSNodeType::CONSTANT, UNKNOWN_MEMORY, Offset::UNKNOWN);
+    PSNode *n = PS.create<PSNodeType::CONSTANT>(UNKNOWN_MEMORY, Offset::UNKNOWN);
     // it is call that returns pointer, so we'd like to have
     // a 'return' node that contains that pointer
     n->setPairedNode(n);
@@ -267,7 +266,7 @@ LLVMPointerSubgraphBuilder::createAsm(const llvm::Instruction *Inst)
 PSNode * LLVMPointerSubgraphBuilder::createFree(const llvm::Instruction *Inst)
 {
     PSNode *op1 = getOperand(Inst->getOperand(0));
-    PSNode *node = PS.create(PSNodeType::FREE, op1);
+    PSNode *node = PS.create<PSNodeType::FREE>(op1);
 
     addNode(Inst, node);
 
@@ -282,7 +281,7 @@ PSNode *LLVMPointerSubgraphBuilder::createDynamicAlloc(const llvm::CallInst *CIn
 
     const Value *op;
     uint64_t size = 0, size2 = 0;
-    PSNodeAlloc *node = PSNodeAlloc::get(PS.create(PSNodeType::DYN_ALLOC));
+    PSNodeAlloc *node = PSNodeAlloc::get(PS.create<PSNodeType::DYN_ALLOC>());
 
     switch (type) {
         case MemAllocationFuncs::MALLOC:
@@ -325,11 +324,11 @@ LLVMPointerSubgraphBuilder::createRealloc(const llvm::CallInst *CInst)
 
     // we create new allocation node and memcpy old pointers there
     PSNode *orig_mem = getOperand(CInst->getOperand(0));
-    PSNodeAlloc *reall = PSNodeAlloc::get(PS.create(PSNodeType::DYN_ALLOC));
+    PSNodeAlloc *reall = PSNodeAlloc::get(PS.create<PSNodeType::DYN_ALLOC>());
     // copy everything that is in orig_mem to reall
-    PSNode *mcp = PS.create(PSNodeType::MEMCPY, orig_mem, reall, Offset::UNKNOWN);
+    PSNode *mcp = PS.create<PSNodeType::MEMCPY>(orig_mem, reall, Offset::UNKNOWN);
     // we need the pointer in the last node that we return
-    PSNode *ptr = PS.create(PSNodeType::CONSTANT, reall, 0);
+    PSNode *ptr = PS.create<PSNodeType::CONSTANT>(reall, 0);
 
     reall->setIsHeap();
     reall->setSize(getConstantSizeValue(CInst->getOperand(1)));
@@ -0,0 +1,315 @@
+#include <cassert>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// ignore unused parameters in LLVM libraries
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
+
+#include "dg/llvm/analysis/PointsTo/PointerSubgraph.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+///
+// Get the nodes of the subgraph of a function and of the subgraphs
+// that are called only from this subgraph (recursively). Return false
+// if the nodes are connected to the rest of the graph otherwise than
+// by the calls of the function, then they cannot be cloned.
+// 'depth' is set to the number of the nested subgraphs and 'allocates'
+// is set to true if the nodes allocate memory on the heap.
+bool
+LLVMPointerSubgraphBuilder::getCloneableNodes(const Subgraph& subg,
+                                              std::vector<PSNode *>& region,
+                                              unsigned& depth, bool& allocates)
+{
+    region.clear();
+    depth = 0;
+    allocates = false;
+
+    // the number of the subgraphs between the node and 'subg'
+    // (-1 if the node is not from 'subg' or from a nested subgraph).
+    // The nodes that do not have the parent set are from the same subgraph
+    // as the predecessor from which we found them.
+    auto getNesting = [&](const PSNode *n, int pred) {
+        const PSNode *r = n->getParent();
+        if (!r)
+            return pred;
+
+        int nesting = 0;
+        while (r != subg.root) {
+            auto it = callerOf.find(r);
+            if (it == callerOf.end())
+                return -1;
+
+            r = it->second;
+            ++nesting;
+        }
+
+        return nesting;
+    };
+
+    std::unordered_set<const PSNode *> inRegion;
+    std::vector<int> nesting;
+    region.push_back(subg.root);
+    nesting.push_back(0);
+    inRegion.insert(subg.root);
+
+    for (size_t i = 0; i < region.size(); ++i) {
+        PSNode *cur = region[i];
+        if (nesting[i] < 0)
+            return false;
+
+        // the functions called via pointers are inserted
+        // to the original nodes later
+        if (cur->getType() == PSNodeType::CALL_FUNCPTR)
+            return false;
+
+        if (cur->getType() == PSNodeType::DYN_ALLOC)
+            allocates = true;
+        depth = std::max(depth, static_cast<unsigned>(nesting[i]));
+
+        // the successors of the return node are the call sites
+        if (cur == subg.ret)
+            continue;
+
+        for (PSNode *succ : cur->getSuccessors()) {
+            if (inRegion.insert(succ).second) {
+                region.push_back(succ);
+                nesting.push_back(getNesting(succ, nesting[i]));
+            }
+        }
+    }
+
+    for (PSNode *pred : subg.root->getPredecessors()) {
+        // the function is recursive or it is not called
+        // only by the regular calls
+        if (pred->getType() != PSNodeType::CALL || inRegion.count(pred) > 0)
+            return false;
+
+        if (subg.ret && pred->getPairedNode() == pred)
+            return false;
+    }
+
+    if (subg.ret) {
+        for (PSNode *succ : subg.ret->getSuccessors()) {
+            PSNode *call = succ->getPairedNode();
+            if (!call || call->getSingleSuccessorOrNull() != subg.root)
+                return false;
+        }
+    }
+
+    for (PSNode *n : region) {
+        if (n != subg.root) {
+            for (PSNode *pred : n->getPredecessors()) {
+                if (inRegion.count(pred) == 0)
+                    return false;
+            }
+        }
+
+        // only the returns from the calls of the function
+        // may use the nodes from outside
+        for (PSNode *user : n->getUsers()) {
+            if (inRegion.count(user) > 0)
+                continue;
+
+            PSNode *call = user->getPairedNode();
+            if (user->getType() != PSNodeType::CALL_RETURN ||
+                !call || call->getSingleSuccessorOrNull() != subg.root)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+///
+// Copy the nodes of the function for the call 'call'
+// and make the call use the copy. Returns the root of the copy.
+PSNode *
+LLVMPointerSubgraphBuilder::cloneForCall(const llvm::Function *F,
+                                         const Subgraph& subg,
+                                         const std::vector<PSNode *>& region,
+                                         PSNode *call)
+{
+    std::vector<PSNode *> copies = PS.copyNodes(region);
+    std::unordered_map<const PSNode *, PSNode *> copyOf;
+    for (size_t i = 0; i < region.size(); ++i) {
+        copyOf.emplace(region[i], copies[i]);
+        if (region[i]->getUserData<llvm::Value>()) {
+            clonedNodes.emplace_back(region[i], copies[i]);
+            clones.insert(copies[i]);
+        }
+    }
+
+    // the nested subgraphs are called from the copies
+    for (PSNode *n : region) {
+        auto it = callerOf.find(n);
+        if (it != callerOf.end() && n != subg.root)
+            callerOf[copyOf[n]] = copyOf[it->second];
+    }
+
+    // the arguments get only the values passed by this call
+    const llvm::CallInst *CI = call->getUserData<llvm::CallInst>();
+    int idx = 0;
+    for (auto A = F->arg_begin(), E = F->arg_end(); A != E; ++A, ++idx) {
+        auto it = nodes_map.find(&*A);
+        if (it == nodes_map.end())
+            continue;
+
+        auto cit = copyOf.find(it->second.first);
+        if (cit == copyOf.end())
+            continue;
+
+        cit->second->removeAllOperands();
+        if (idx < static_cast<int>(CI->getNumArgOperands()))
+            addArgumentOperands(CI, cit->second, idx);
+    }
+
+    PSNode *root = copyOf[subg.root];
+    call->replaceSingleSuccessor(root);
+
+    if (subg.ret) {
+        PSNode *callReturn = call->getPairedNode();
+        subg.ret->removeSuccessor(callReturn);
+        copyOf[subg.ret]->addSuccessor(callReturn);
+
+        std::vector<PSNode *> ops = callReturn->getOperands();
+        callReturn->removeAllOperands();
+        for (PSNode *op : ops) {
+            auto it = copyOf.find(op);
+            callReturn->addOperand(it == copyOf.end() ? op : it->second);
+        }
+    }
+
+    return root;
+}
+
+void LLVMPointerSubgraphBuilder::cloneFunctions()
+{
+    if ((_options.cloneDepth == 0 && !_options.cloneAllocWrappers) ||
+        _options.isDemand())
+        return;
+
+    cloningStats = CloningStatistics();
+    cloningStats.nodesBefore = PS.size();
+    size_t budget = _options.cloningBudget > 0 ? _options.cloningBudget
+                                               : PS.size();
+
+    // the calls in the subgraphs and the functions of the subgraphs
+    std::unordered_map<const PSNode *, std::vector<PSNode *>> callsIn;
+    std::unordered_map<const PSNode *, const llvm::Function *> functionOf;
+    for (const auto& it : subgraphs_map)
+        functionOf.emplace(it.second.root, it.first);
+    for (const auto& nd : PS.getNodes()) {
+        if (nd && nd->getType() == PSNodeType::CALL && nd->getParent())
+            callsIn[nd->getParent()].push_back(nd.get());
+    }
+
+    // clone the called functions before the functions that call them,
+    // so that the clones of the callers contain the clones of the callees.
+    // Go through the functions in the order from the module,
+    // so that the built graph is always the same.
+    std::vector<const llvm::Function *> order;
+    std::unordered_set<const llvm::Function *> visited;
+    std::vector<std::pair<const llvm::Function *, size_t>> stack;
+    for (const llvm::Function& Fn : *M) {
+        if (subgraphs_map.count(&Fn) == 0 || !visited.insert(&Fn).second)
+            continue;
+
+        stack.emplace_back(&Fn, 0);
+        while (!stack.empty()) {
+            const llvm::Function *cur = stack.back().first;
+            const auto& calls = callsIn[subgraphs_map[cur].root];
+            if (stack.back().second < calls.size()) {
+                PSNode *called = calls[stack.back().second++]->getSingleSuccessorOrNull();
+                auto it = called ? functionOf.find(called) : functionOf.end();
+                if (it != functionOf.end() && visited.insert(it->second).second)
+                    stack.emplace_back(it->second, 0);
+            } else {
+                order.push_back(cur);
+                stack.pop_back();
+            }
+        }
+    }
+
+    std::vector<PSNode *> region;
+    for (const llvm::Function *F : order) {
+        Subgraph& subg = subgraphs_map[F];
+        if (subg.vararg)
+            continue;
+
+        unsigned depth;
+        bool allocates;
+        if (!getCloneableNodes(subg, region, depth, allocates))
+            continue;
+
+        std::vector<PSNode *> roots{subg.root};
+        std::vector<PSNode *> calls = subg.root->getPredecessors();
+        if (depth < _options.cloneDepth ||
+            (_options.cloneAllocWrappers && allocates && subg.ret)) {
+            // the first call keeps the original nodes
+            size_t i = 1;
+            for (; i < calls.size() && budget >= region.size(); ++i) {
+                roots.push_back(cloneForCall(F, subg, region, calls[i]));
+                budget -= region.size();
+            }
+
+            if (roots.size() > 1) {
+                ++cloningStats.functions;
+                cloningStats.clones += roots.size() - 1;
+
+                // the original arguments get only the values
+                // from the calls that were not cloned
+                calls.erase(calls.begin() + 1, calls.begin() + i);
+                int idx = 0;
+                for (auto A = F->arg_begin(), E = F->arg_end(); A != E; ++A, ++idx) {
+                    auto it = nodes_map.find(&*A);
+                    if (it == nodes_map.end())
+                        continue;
+
+                    it->second.first->removeAllOperands();
+                    for (PSNode *call : calls) {
+                        const llvm::CallInst *CI = call->getUserData<llvm::CallInst>();
+                        if (idx < static_cast<int>(CI->getNumArgOperands()))
+                            addArgumentOperands(CI, it->second.first, idx);
+                    }
+                }
+            }
+        }
+
+        // the subgraphs called from one place are parts of the callers
+        for (PSNode *r : roots) {
+            if (r->predecessorsNum() != 1)
+                continue;
+
+            PSNode *caller = r->getPredecessors()[0]->getParent();
+            if (caller && caller != r)
+                callerOf[r] = caller;
+        }
+    }
+
+    cloningStats.nodesAfter = PS.size();
+}
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
@@ -206,7 +206,7 @@ Pointer LLVMPointerSubgraphBuilder::getConstantExprPointer(const llvm::ConstantE
 PSNode *LLVMPointerSubgraphBuilder::createConstantExpr(const llvm::ConstantExpr *CE)
 {
     Pointer ptr = getConstantExprPointer(CE);
-    PSNode *node = PS.create(PSNodeType::CONSTANT, ptr.target, ptr.offset);
+    PSNode *node = PS.create<PSNodeType::CONSTANT>(ptr.target, ptr.offset);
 
     addNode(CE, node);
 
@@ -220,7 +220,7 @@ PSNode *LLVMPointerSubgraphBuilder::createUnknown(const llvm::Value *val)
     // completely change the value of pointer...
 
     // FIXME: or there's enough unknown offset? Check it out!
-    PSNode *node = PS.create(PSNodeType::CONSTANT, UNKNOWN_MEMORY, Offset::UNKNOWN);
+    PSNode *node = PS.create<PSNodeType::CONSTANT>(UNKNOWN_MEMORY, Offset::UNKNOWN);
 
     addNode(val, node);
 
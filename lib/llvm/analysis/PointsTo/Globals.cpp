@@ -65,8 +65,8 @@ LLVMPointerSubgraphBuilder::handleGlobalVariableInitializer(const llvm::Constant
         }
     } else if (C->getType()->isPointerTy()) {
         PSNode *op = getOperand(C);
-        PSNode *target = PS.create(PSNodeType::CONSTANT, node, offset);
-        PSNode *store = PS.create(PSNodeType::STORE, op, target);
+        PSNode *target = PS.create<PSNodeType::CONSTANT>(node, offset);
+        PSNode *store = PS.create<PSNodeType::STORE>(op, target);
         store->insertAfter(last);
         last = store;
     } else if (isa<ConstantExpr>(C)
@@ -76,14 +76,14 @@ LLVMPointerSubgraphBuilder::handleGlobalVariableInitializer(const llvm::Constant
            PSNode *value = getOperand(C);
            assert(value->pointsTo.size() == 1 && "BUG: We should have constant");
            // FIXME: we're leaking the target
-           PSNode *store = PS.create(PSNodeType::STORE, value, node);
+           PSNode *store = PS.create<PSNodeType::STORE>(value, node);
            store->insertAfter(last);
            last = store;
        }
     } else if (isa<UndefValue>(C)) {
         // undef value means unknown memory
-        PSNode *target = PS.create(PSNodeType::CONSTANT, node, offset);
-        PSNode *store = PS.create(PSNodeType::STORE, UNKNOWN_MEMORY, target);
+        PSNode *target = PS.create<PSNodeType::CONSTANT>(node, offset);
+        PSNode *store = PS.create<PSNodeType::STORE>(UNKNOWN_MEMORY, target);
         store->insertAfter(last);
         last = store;
     } else if (!isa<ConstantInt>(C) && !isa<ConstantFP>(C)) {
@@ -113,7 +113,7 @@ PSNodesSeq LLVMPointerSubgraphBuilder::buildGlobals()
         prev = cur;
 
         // every global node is like memory allocation
-        PSNodeAlloc *nd = PSNodeAlloc::get(PS.create(PSNodeType::ALLOC));
+        PSNodeAlloc *nd = PSNodeAlloc::get(PS.create<PSNodeType::ALLOC>());
         nd->setIsGlobal();
         cur = nd;
 
@@ -145,7 +145,7 @@ PSNodesSeq LLVMPointerSubgraphBuilder::buildGlobals()
         } else {
             // without initializer we can not do anything else than
             // assume that it can point everywhere
-            cur = PS.create(PSNodeType::STORE, UNKNOWN_MEMORY, node);
+            cur = PS.create<PSNodeType::STORE>(UNKNOWN_MEMORY, node);
             cur->insertAfter(node);
         }
     }
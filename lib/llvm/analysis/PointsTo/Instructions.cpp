@@ -8,7 +8,7 @@ namespace pta {
 
 PSNode *LLVMPointerSubgraphBuilder::createAlloc(const llvm::Instruction *Inst)
 {
-    PSNodeAlloc *node = PSNodeAlloc::get(PS.create(PSNodeType::ALLOC));
+    PSNodeAlloc *node = PSNodeAlloc::get(PS.create<PSNodeType::ALLOC>());
     addNode(Inst, node);
 
     const llvm::AllocaInst *AI = llvm::dyn_cast<llvm::AllocaInst>(Inst);
@@ -21,7 +21,7 @@ PSNode *LLVMPointerSubgraphBuilder::createAlloc(const llvm::Instruction *Inst)
 PSNode * LLVMPointerSubgraphBuilder::createLifetimeEnd(const llvm::Instruction *Inst)
 {
     PSNode *op1 = getOperand(Inst->getOperand(1));
-    PSNode *node = PS.create(PSNodeType::INVALIDATE_OBJECT, op1);
+    PSNode *node = PS.create<PSNodeType::INVALIDATE_OBJECT>(op1);
 
     addNode(Inst, node);
 
@@ -36,7 +36,7 @@ PSNode *LLVMPointerSubgraphBuilder::createStore(const llvm::Instruction *Inst)
     PSNode *op1 = getOperand(valOp);
     PSNode *op2 = getOperand(Inst->getOperand(1));
 
-    PSNode *node = PS.create(PSNodeType::STORE, op1, op2);
+    PSNode *node = PS.create<PSNodeType::STORE>(op1, op2);
     addNode(Inst, node);
 
     assert(node);
@@ -48,7 +48,7 @@ PSNode *LLVMPointerSubgraphBuilder::createLoad(const llvm::Instruction *Inst)
     const llvm::Value *op = Inst->getOperand(0);
 
     PSNode *op1 = getOperand(op);
-    PSNode *node = PS.create(PSNodeType::LOAD, op1);
+    PSNode *node = PS.create<PSNodeType::LOAD>(op1);
 
     addNode(Inst, node);
 
@@ -75,7 +75,7 @@ PSNode *LLVMPointerSubgraphBuilder::createGEP(const llvm::Instruction *Inst)
             // is 0 < offset < field_sensitivity ?
             uint64_t off = offset.getLimitedValue(*_options.fieldSensitivity);
             if (off == 0 || off < *_options.fieldSensitivity)
-                node = PS.create(PSNodeType::GEP, op, offset.getZExtValue());
+                node = PS.create<PSNodeType::GEP>(op, offset.getZExtValue());
         } else
             errs() << "WARN: GEP offset greater than " << bitwidth << "-bit";
             // fall-through to Offset::UNKNOWN in this case
@@ -85,7 +85,7 @@ PSNode *LLVMPointerSubgraphBuilder::createGEP(const llvm::Instruction *Inst)
     // in which case we are supposed to create a node
     // with Offset::UNKNOWN
     if (!node)
-        node = PS.create(PSNodeType::GEP, op, Offset::UNKNOWN);
+        node = PS.create<PSNodeType::GEP>(op, Offset::UNKNOWN);
 
     addNode(Inst, node);
 
@@ -103,7 +103,7 @@ PSNode *LLVMPointerSubgraphBuilder::createSelect(const llvm::Instruction *Inst)
     PSNode *op2 = getOperand(Inst->getOperand(2));
 
     // select works as a PHI in points-to analysis
-    PSNode *node = PS.create(PSNodeType::PHI, op1, op2, nullptr);
+    PSNode *node = PS.create<PSNodeType::PHI>(op1, op2);
     addNode(Inst, node);
 
     assert(node);
@@ -145,8 +145,8 @@ LLVMPointerSubgraphBuilder::createExtract(const llvm::Instruction *Inst)
 
     // extract <agg> <idx> {<idx>, ...}
     PSNode *op1 = getOperand(EI->getAggregateOperand());
-    PSNode *G = PS.create(PSNodeType::GEP, op1, accumulateEVOffsets(EI, *DL));
-    PSNode *L = PS.create(PSNodeType::LOAD, G);
+    PSNode *G = PS.create<PSNodeType::GEP>(op1, accumulateEVOffsets(EI, *DL));
+    PSNode *L = PS.create<PSNodeType::LOAD>(G);
 
     G->addSuccessor(L);
 
@@ -158,7 +158,7 @@ LLVMPointerSubgraphBuilder::createExtract(const llvm::Instruction *Inst)
 
 PSNode *LLVMPointerSubgraphBuilder::createPHI(const llvm::Instruction *Inst)
 {
-    PSNode *node = PS.create(PSNodeType::PHI, nullptr);
+    PSNode *node = PS.create<PSNodeType::PHI>();
     addNode(Inst, node);
 
     // NOTE: we didn't add operands to PHI node here, but after building
@@ -173,7 +173,7 @@ PSNode *LLVMPointerSubgraphBuilder::createCast(const llvm::Instruction *Inst)
 {
     const llvm::Value *op = Inst->getOperand(0);
     PSNode *op1 = getOperand(op);
-    PSNode *node = PS.create(PSNodeType::CAST, op1);
+    PSNode *node = PS.create<PSNodeType::CAST>(op1);
 
     addNode(Inst, node);
 
@@ -191,8 +191,8 @@ PSNode *LLVMPointerSubgraphBuilder::createPtrToInt(const llvm::Instruction *Inst
     // just casting the value do gep with unknown offset -
     // this way we cover any shift of the pointer due to arithmetic
     // operations
-    // PSNode *node = PS.create(PSNodeType::CAST, op1);
-    PSNode *node = PS.create(PSNodeType::GEP, op1, 0);
+    // PSNode *node = PS.create<PSNodeType::CAST>(op1);
+    PSNode *node = PS.create<PSNodeType::GEP>(op1, 0);
     addNode(Inst, node);
 
     assert(node);
@@ -213,7 +213,7 @@ PSNode *LLVMPointerSubgraphBuilder::createIntToPtr(const llvm::Instruction *Inst
     } else
         op1 = getOperand(op);
 
-    PSNode *node = PS.create(PSNodeType::CAST, op1);
+    PSNode *node = PS.create<PSNodeType::CAST>(op1);
     addNode(Inst, node);
 
     assert(node);
@@ -252,7 +252,7 @@ PSNode *LLVMPointerSubgraphBuilder::createAdd(const llvm::Instruction *Inst)
     if (val)
         off = getConstantValue(val);
 
-    node = PS.create(PSNodeType::GEP, op, off);
+    node = PS.create<PSNodeType::GEP>(op, off);
     addNode(Inst, node);
 
     assert(node);
@@ -287,7 +287,7 @@ PSNode *LLVMPointerSubgraphBuilder::createArithmetic(const llvm::Instruction *In
 
     // we don't know what the operation does,
     // so set unknown offset
-    node = PS.create(PSNodeType::GEP, op, Offset::UNKNOWN);
+    node = PS.create<PSNodeType::GEP>(op, Offset::UNKNOWN);
     addNode(Inst, node);
 
     assert(node);
@@ -337,7 +337,7 @@ PSNode *LLVMPointerSubgraphBuilder::createReturn(const llvm::Instruction *Inst)
     assert((op1 || !retVal || !retVal->getType()->isPointerTy())
            && "Don't have an operand for ReturnInst with pointer");
 
-    PSNode *node = PS.create(PSNodeType::RETURN, op1, nullptr);
+    PSNode *node = PS.create<PSNodeType::RETURN>(op1);
     addNode(Inst, node);
 
     return node;
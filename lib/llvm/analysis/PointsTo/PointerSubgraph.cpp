@@ -38,6 +38,7 @@
 
 #include "dg/analysis/PointsTo/PointerSubgraph.h"
 #include "dg/analysis/PointsTo/PointerSubgraphOptimizations.h"
+#include "dg/analysis/PointsTo/PointsToCache.h"
 #include "dg/llvm/analysis/PointsTo/PointerSubgraph.h"
 
 #include "llvm/analysis/PointsTo/PointerSubgraphValidator.h"
@@ -78,7 +79,7 @@ PSNode *LLVMPointerSubgraphBuilder::getConstant(const llvm::Value *val)
                     = llvm::dyn_cast<llvm::ConstantExpr>(val)) {
         return createConstantExpr(CE);
     } else if (llvm::isa<llvm::Function>(val)) {
-        PSNode *ret = PS.create(PSNodeType::FUNCTION);
+        PSNode *ret = PS.create<PSNodeType::FUNCTION>();
         addNode(val, ret);
         return ret;
     } else if (llvm::isa<llvm::Constant>(val)) {
@@ -143,7 +144,7 @@ PSNodesSeq
 LLVMPointerSubgraphBuilder::createCallToFunction(const llvm::CallInst *CInst,
                                                  const llvm::Function *F)
 {
-    PSNodeCall *callNode = PSNodeCall::get(PS.create(PSNodeType::CALL));
+    PSNodeCall *callNode = PSNodeCall::get(PS.create<PSNodeType::CALL>());
 
     // reuse built subgraphs if available
     Subgraph& subg = createOrGetSubgraph(F);
@@ -159,7 +160,7 @@ LLVMPointerSubgraphBuilder::createCallToFunction(const llvm::CallInst *CInst,
     // are going to be added when the subgraph is built
     PSNode *returnNode = nullptr;
     if (subg.ret) {
-        returnNode = PS.create(PSNodeType::CALL_RETURN, nullptr);
+        returnNode = PS.create<PSNodeType::CALL_RETURN>();
         returnNode->setPairedNode(callNode);
         callNode->setPairedNode(returnNode);
         subg.ret->addSuccessor(returnNode);
@@ -219,6 +220,7 @@ LLVMPointerSubgraphBuilder::insertFunctionCall(PSNode *callsite, PSNode *called)
     // create new instructions
     auto cf = createFuncptrCall(CI, F);
     assert(cf.first && "Failed building the subgraph");
+    inserted_calls.emplace_back(callsite->getID(), called->getID());
     
     // we got the return site for the call stored as the paired node
     PSNode *ret = callsite->getPairedNode();
@@ -226,6 +228,7 @@ LLVMPointerSubgraphBuilder::insertFunctionCall(PSNode *callsite, PSNode *called)
         // If we have some returns from this function,
         // pass the returned values to the return site.
         ret->addOperand(cf.second);
+        PS.operandsChanged(ret);
         cf.second->addSuccessor(ret);
     }
     
@@ -449,7 +452,7 @@ PSNode *LLVMPointerSubgraphBuilder::createArgument(const llvm::Argument *farg)
 {
     using namespace llvm;
 
-    PSNode *arg = PS.create(PSNodeType::PHI, nullptr);
+    PSNode *arg = PS.create<PSNodeType::PHI>();
     addNode(farg, arg);
 
     return arg;
@@ -612,7 +615,7 @@ LLVMPointerSubgraphBuilder::buildFunction(const llvm::Function& F)
     // create root and later (an unified) return nodes of this subgraph.
     // These are just for our convenience when building the graph,
     // they can be optimized away later since they are noops
-    PSNodeEntry *root = PSNodeEntry::get(PS.create(PSNodeType::ENTRY));
+    PSNodeEntry *root = PSNodeEntry::get(PS.create<PSNodeType::ENTRY>());
     assert(root);
     root->setFunctionName(F.getName().str());
     root->setParent(root);
@@ -621,7 +624,7 @@ LLVMPointerSubgraphBuilder::buildFunction(const llvm::Function& F)
     // then create the node for it
     PSNode *vararg = nullptr;
     if (F.isVarArg()) {
-        vararg = PS.create(PSNodeType::PHI, nullptr);
+        vararg = PS.create<PSNodeType::PHI>();
         vararg->setParent(root);
     }
 
@@ -659,9 +662,9 @@ LLVMPointerSubgraphBuilder::buildFunction(const llvm::Function& F)
     if (have_return) {
         PSNode *ret;
         if (invalidate_nodes) {
-            ret = PS.create(PSNodeType::INVALIDATE_LOCALS, root);
+            ret = PS.create<PSNodeType::INVALIDATE_LOCALS>(root);
         } else {
-            ret = PS.create(PSNodeType::NOOP);
+            ret = PS.create<PSNodeType::NOOP>();
         }
 
         ret->setParent(root);
@@ -701,6 +704,9 @@ void LLVMPointerSubgraphBuilder::addArgumentOperands(const llvm::CallInst *CI,
         // (when a function is called multiple-times with
         // the same actual parameters)
         arg->addOperand(op);
+        // the analysis may have processed the argument already
+        if (ad_hoc_building)
+            PS.operandsChanged(arg);
     }
 }
 
@@ -797,8 +803,11 @@ void LLVMPointerSubgraphBuilder::addReturnNodeOperand(PSNode *callNode, PSNode *
     // so there must be associated the return node
     assert(returnNode);
 
-    if (!returnNode->hasOperand(op))
+    if (!returnNode->hasOperand(op)) {
         returnNode->addOperand(op);
+        if (ad_hoc_building)
+            PS.operandsChanged(returnNode);
+    }
 }
 
 
@@ -885,6 +894,7 @@ PointerSubgraph *LLVMPointerSubgraphBuilder::buildLLVMPointerSubgraph()
     }
 
     PS.setRoot(root);
+    cloneFunctions();
 
 #ifndef NDEBUG
     debug::LLVMPointerSubgraphValidator validator(&PS);
@@ -916,6 +926,18 @@ bool LLVMPointerSubgraphBuilder::validateSubgraph() const
     }
 }
 
+bool LLVMPointerSubgraphBuilder::validateSubgraph(size_t firstNew) const
+{
+    debug::LLVMPointerSubgraphValidator validator(getPS());
+    if (validator.validate(firstNew, PS.getChangedNodes())) {
+        assert(!validator.getErrors().empty());
+        llvm::errs() << validator.getErrors();
+        return false;
+    } else {
+        return true;
+    }
+}
+
 std::vector<PSNode *>
 LLVMPointerSubgraphBuilder::getFunctionNodes(const llvm::Function *F) const
 {
@@ -936,6 +958,47 @@ LLVMPointerSubgraphBuilder::getFunctionNodes(const llvm::Function *F) const
     return ret;
 }
 
+namespace {
+// hash everything that is written into the stream
+class HashingStream : public llvm::raw_ostream {
+    uint64_t hash;
+    uint64_t pos{0};
+
+    void write_impl(const char *ptr, size_t size) override {
+        hash = PointsToCache::hash(ptr, size, hash);
+        pos += size;
+    }
+
+    uint64_t current_pos() const override { return pos; }
+
+public:
+    HashingStream(uint64_t seed) : hash(seed) {}
+    ~HashingStream() { flush(); }
+
+    uint64_t getHash() { flush(); return hash; }
+};
+} // anonymous namespace
+
+uint64_t LLVMPointerSubgraphBuilder::getCacheKey() const
+{
+    HashingStream stream(PointsToCache::hash(nullptr, 0));
+    M->print(stream, nullptr);
+
+    stream << "\n" << static_cast<unsigned>(_options.analysisType)
+           << " " << *_options.fieldSensitivity
+           << " " << _options.entryFunction
+           << " " << _options.preprocessGeps
+           << " " << _options.optimizeSubgraph
+           << " " << _options.cloneDepth
+           << " " << _options.cloneAllocWrappers
+           << " " << _options.cloningBudget
+           << " " << _options.objectFieldsBudget
+           << " " << _options.collapseLoopObjects
+           << " " << invalidate_nodes;
+
+    return stream.getHash();
+}
+
 } // namespace pta
 } // namespace analysis
 } // namespace dg
@@ -49,6 +49,43 @@ protected:
     // list of dummy nodes (used just to keep the track of memory,
     // so that we can delete it later)
     std::vector<RDNode *> dummy_nodes;
+    // the copies of heap allocations from the cloned functions
+    // (see LLVMPointerAnalysisOptions::cloneAllocWrappers)
+    std::unordered_map<const pta::PSNode *, RDNode *> cloned_targets;
+
+    // Get the node for the pointer target 'target' given the node 'node'
+    // of its llvm::Value. The copies of heap allocations are different
+    // memory objects, so each of them gets its own node. The allocation
+    // defines the copies the same way as it defines itself.
+    RDNode *getTarget(pta::PSNode *target, RDNode *node)
+    {
+        if (!node || !PTA->isClone(target))
+            return node;
+
+        pta::PSNodeAlloc *alloc = pta::PSNodeAlloc::get(target);
+        if (!alloc || !alloc->isHeap())
+            return node;
+
+        auto it = cloned_targets.find(target);
+        if (it != cloned_targets.end())
+            return it->second;
+
+        RDNode *copy = new RDNode(node->getType());
+        copy->setUserData(node->getUserData<llvm::Value>());
+        copy->setSize(node->getSize());
+        dummy_nodes.push_back(copy);
+        cloned_targets.emplace(target, copy);
+
+        std::vector<DefSite> defs;
+        for (const DefSite& ds : node->getDefines()) {
+            if (ds.target == node)
+                defs.push_back(ds);
+        }
+        for (const DefSite& ds : defs)
+            node->addDef(copy, ds.offset, ds.len);
+
+        return copy;
+    }
 
 public:
     LLVMRDBuilder(const llvm::Module *m,
@@ -105,6 +142,17 @@ public:
 
         return it->second;
     }
+
+    // the node that represents the memory of the pointer target
+    // (after the graph was built)
+    RDNode *getTargetNode(const pta::PSNode *target)
+    {
+        auto it = cloned_targets.find(target);
+        if (it != cloned_targets.end())
+            return it->second;
+
+        return getNode(target->getUserData<llvm::Value>());
+    }
 };
 
 }
@@ -301,7 +301,7 @@ RDNode *LLVMRDBuilderDense::createStore(const llvm::Instruction *Inst)
         if (llvm::isa<llvm::Function>(ptrVal))
             continue;
 
-        RDNode *ptrNode = getOperand(ptrVal);
+        RDNode *ptrNode = getTarget(ptr.target, getOperand(ptrVal));
         //assert(ptrNode && "Don't have created node for pointer's target");
         if (!ptrNode) {
             // keeping such set is faster then printing it all to terminal
@@ -644,7 +644,7 @@ RDNode *LLVMRDBuilderDense::createUndefinedCall(const llvm::CallInst *CInst)
                 // function may not be redefined
                 continue;
 
-            RDNode *target = getOperand(ptrVal);
+            RDNode *target = getTarget(ptr.target, getOperand(ptrVal));
             assert(target && "Don't have pointer target for call argument");
 
             // this call may define this memory
@@ -730,7 +730,7 @@ RDNode *LLVMRDBuilderDense::createIntrinsicCall(const llvm::CallInst *CInst)
         else
             to = Offset::UNKNOWN;
 
-        RDNode *target = getOperand(ptrVal);
+        RDNode *target = getTarget(ptr.target, getOperand(ptrVal));
         assert(target && "Don't have pointer target for intrinsic call");
 
         // add the definition
@@ -264,7 +264,7 @@ bool LLVMRDBuilderSemisparse::isStrongUpdate(const llvm::Value *val, const DefSi
         if (llvm::isa<llvm::Function>(ptrVal))
             continue;
 
-        RDNode *ptrNode = getOperand(ptrVal, rb);
+        RDNode *ptrNode = getTarget(ptr.target, getOperand(ptrVal, rb));
         if (ptrNode != ds.target)
             continue;
 
@@ -341,7 +341,7 @@ std::vector<DefSite> LLVMRDBuilderSemisparse::getPointsTo(const llvm::Value *val
         if (llvm::isa<llvm::Function>(ptrVal))
             continue;
 
-        RDNode *ptrNode = getOperand(ptrVal, rb);
+        RDNode *ptrNode = getTarget(ptr.target, getOperand(ptrVal, rb));
         if (!ptrNode) {
             // keeping such set is faster then printing it all to terminal
             // ... and we don't flood the terminal that way
@@ -811,7 +811,7 @@ RDNode *LLVMRDBuilderSemisparse::createUndefinedCall(const llvm::CallInst *CInst
                 // function may not be redefined
                 continue;
 
-            RDNode *target = getOperand(ptrVal, rb);
+            RDNode *target = getTarget(ptr.target, getOperand(ptrVal, rb));
             assert(target && "Don't have pointer target for call argument");
 
             // this call may define or use this memory
@@ -883,7 +883,7 @@ RDNode *LLVMRDBuilderSemisparse::createIntrinsicCall(const llvm::CallInst *CInst
                 else
                     to = Offset::UNKNOWN;
 
-                RDNode *target = getOperand(ptrVal, rb);
+                RDNode *target = getTarget(ptr.target, getOperand(ptrVal, rb));
                 assert(target && "Don't have pointer target for intrinsic call");
 
                 // add the definition
@@ -930,7 +930,7 @@ RDNode *LLVMRDBuilderSemisparse::createIntrinsicCall(const llvm::CallInst *CInst
         else
             to = Offset::UNKNOWN;
 
-        RDNode *target = getOperand(ptrVal, rb);
+        RDNode *target = getTarget(ptr.target, getOperand(ptrVal, rb));
         assert(target && "Don't have pointer target for intrinsic call");
 
         // add the definition
@@ -963,7 +963,7 @@ RDNode *LLVMRDBuilderSemisparse::createIntrinsicCall(const llvm::CallInst *CInst
             else
                 to = Offset::UNKNOWN;
 
-            RDNode *target = getOperand(ptrVal, rb);
+            RDNode *target = getTarget(ptr.target, getOperand(ptrVal, rb));
             assert(target && "Don't have pointer target for intrinsic call");
 
             // add the definition
@@ -17,7 +17,7 @@ void LLVMReachingDefinitions::initializeSparseRDA() {
     builder = new LLVMRDBuilderSemisparse(m, pta, _options);
     root = builder->build();
 
-    RDA = std::unique_ptr<ReachingDefinitionsAnalysis>(new SemisparseRda(root));
+    RDA = std::unique_ptr<ReachingDefinitionsAnalysis>(new SemisparseRda(root, _options));
 }
 
 void LLVMReachingDefinitions::initializeDenseRDA() {
@@ -32,6 +32,10 @@ RDNode *LLVMReachingDefinitions::getNode(const llvm::Value *val) {
     return builder->getNode(val);
 }
 
+RDNode *LLVMReachingDefinitions::getTargetNode(const analysis::pta::PSNode *target) {
+    return builder->getTargetNode(target);
+}
+
 // let the user get the nodes map, so that we can
 // map the points-to informatio back to LLVM nodes
 const std::unordered_map<const llvm::Value *, RDNode *>&
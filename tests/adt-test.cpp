@@ -4,8 +4,10 @@
 
 #include "test-runner.h"
 
+#include "dg/ADT/Arena.h"
 #include "dg/ADT/Queue.h"
 #include "dg/ADT/Bitvector.h"
+#include "dg/ADT/BDD.h"
 #include "dg/analysis/ReachingDefinitions/RDMap.h"
 
 using namespace dg::ADT;
@@ -150,6 +152,92 @@ public:
     }
 };
 
+class TestArena : public Test
+{
+public:
+    TestArena() : Test("arena test")
+    {}
+
+    void test()
+    {
+        Arena arena;
+
+        char *c = static_cast<char *>(arena.allocate(1, 1));
+        uint64_t *u = static_cast<uint64_t *>(arena.allocate(sizeof(uint64_t),
+                                                             alignof(uint64_t)));
+        check(reinterpret_cast<uintptr_t>(u) % alignof(uint64_t) == 0,
+              "Misaligned allocation");
+        check(reinterpret_cast<char *>(u) > c, "Objects do not follow each other");
+        check(reinterpret_cast<char *>(u) - c < 16, "Objects are not packed");
+
+        *c = 'x';
+        *u = 0xdeadbeef;
+
+        // allocations bigger than a chunk
+        char *big = static_cast<char *>(arena.allocate(1 << 20, 1));
+        big[0] = big[(1 << 20) - 1] = 'y';
+
+        Arena moved(std::move(arena));
+        uint64_t *u2 = static_cast<uint64_t *>(moved.allocate(sizeof(uint64_t),
+                                                              alignof(uint64_t)));
+        *u2 = 42;
+
+        check(*c == 'x' && *u == 0xdeadbeef, "Memory was overwritten");
+        check(big[0] == 'y' && big[(1 << 20) - 1] == 'y', "Memory was overwritten");
+    }
+};
+
+class TestBDD : public Test
+{
+public:
+    TestBDD() : Test("BDD test")
+    {}
+
+    void test()
+    {
+        BDDManager bdd;
+        // two 4-bit numbers x and y with interleaved bits
+        std::vector<BDDManager::LevelT> x{0, 2, 4, 6}, y{1, 3, 5, 7};
+
+        BDDManager::NodeT S = BDDManager::ZERO;
+        for (uint64_t v : {3, 7, 12, 0})
+            S = bdd.bddOr(S, bdd.minterm(v, x));
+
+        check(bdd.count(S, x) == 4, "Wrong size of the set");
+        check(bdd.contains(S, 7, x) && !bdd.contains(S, 5, x),
+              "Wrong membership");
+        check(bdd.bddOr(S, bdd.minterm(12, x)) == S,
+              "The same set is not the same node");
+
+        std::vector<uint64_t> values;
+        for (auto it = bdd.begin(S, &x), et = bdd.end(); it != et; ++it)
+            values.push_back(*it);
+        check(values == std::vector<uint64_t>({0, 3, 7, 12}),
+              "Wrong iteration over the set");
+
+        // relation x -> x + 1 applied to S
+        unsigned toY = bdd.addRenaming(x, y);
+        unsigned toX = bdd.addRenaming(y, x);
+        BDDManager::NodeT succ = BDDManager::ZERO;
+        for (uint64_t v = 0; v < 15; ++v)
+            succ = bdd.bddOr(succ, bdd.bddAnd(bdd.minterm(v, x),
+                                              bdd.minterm(v + 1, y)));
+
+        BDDManager::NodeT img = bdd.replace(bdd.relProd(S, succ, bdd.cube(x)), toX);
+        values.clear();
+        for (auto it = bdd.begin(img, &x), et = bdd.end(); it != et; ++it)
+            values.push_back(*it);
+        check(values == std::vector<uint64_t>({1, 4, 8, 13}),
+              "Wrong image of the relation");
+
+        check(bdd.replace(bdd.replace(S, toY), toX) == S, "Renaming is not reversible");
+        check(bdd.exists(succ, bdd.cube(y)) ==
+              bdd.bddDiff(BDDManager::ONE, bdd.minterm(15, x)),
+              "Wrong quantification");
+        check(bdd.begin(BDDManager::ZERO, &x) == bdd.end(), "The empty set is not empty");
+    }
+};
+
 }; // namespace tests
 }; // namespace dg
 
@@ -162,6 +250,8 @@ int main()
     Runner.add(new TestFIFO());
     Runner.add(new TestPrioritySet());
     Runner.add(new TestIntervalsHandling());
+    Runner.add(new TestArena());
+    Runner.add(new TestBDD());
 
     return Runner();
 }
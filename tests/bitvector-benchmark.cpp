@@ -0,0 +1,102 @@
+#include <vector>
+#include <string>
+#include <random>
+
+#include "dg/ADT/Bitvector.h"
+#include "../tools/TimeMeasure.h"
+
+using namespace dg::ADT;
+
+std::default_random_engine generator;
+
+// the way the bitvectors were merged before -- bit by bit
+struct BitByBitMerge {
+    static bool merge(SparseBitvector& to, const SparseBitvector& from) {
+        bool changed = false;
+        for (size_t i : from)
+            changed |= (to.set(i) == false);
+        return changed;
+    }
+};
+
+struct WordMerge {
+    static bool merge(SparseBitvector& to, const SparseBitvector& from) {
+        return to.merge(from);
+    }
+};
+
+#define run(func, msg) do { \
+    std::cout << "Running " << msg << "\n"; \
+    dg::debug::TimeMeasure tm; \
+    tm.start(); \
+    for (int i = 0; i < times; ++i) \
+        func<WordMerge>(); \
+    tm.stop(); \
+    tm.report(" -- merge of words took"); \
+    tm.start(); \
+    for (int i = 0; i < times; ++i) \
+        func<BitByBitMerge>(); \
+    tm.stop(); \
+    tm.report(" -- merge bit by bit took"); \
+    } while(0);
+
+static void fill(SparseBitvector& B, size_t num, size_t max) {
+    std::uniform_int_distribution<size_t> distribution(0, max);
+    for (size_t i = 0; i < num; ++i)
+        B.set(distribution(generator));
+}
+
+// merge small dense sets
+template <typename MergeT>
+void test1() {
+    SparseBitvector A, B;
+    fill(A, 30, 64);
+    fill(B, 30, 64);
+    MergeT::merge(A, B);
+}
+
+// merge sets with clustered numbers
+template <typename MergeT>
+void test2() {
+    SparseBitvector A, B;
+    fill(A, 1000, 2000);
+    fill(B, 1000, 2000);
+    MergeT::merge(A, B);
+}
+
+// merge sparse sets
+template <typename MergeT>
+void test3() {
+    SparseBitvector A, B;
+    fill(A, 100, ~static_cast<size_t>(0) - 1);
+    fill(B, 100, ~static_cast<size_t>(0) - 1);
+    MergeT::merge(A, B);
+}
+
+// merge a set into its superset (nothing changes),
+// this is the common case in a fixpoint computation
+template <typename MergeT>
+void test4() {
+    SparseBitvector A, B;
+    fill(B, 1000, 5000);
+    A.merge(B);
+    fill(A, 100, 5000);
+    for (int i = 0; i < 10; ++i)
+        MergeT::merge(A, B);
+}
+
+int main()
+{
+    int times;
+    times = 10000;
+    run(test1, "Merging small dense sets");
+
+    times = 1000;
+    run(test2, "Merging sets of 1000 clustered numbers");
+
+    times = 1000;
+    run(test3, "Merging sparse sets of 100 numbers");
+
+    times = 1000;
+    run(test4, "Merging into superset");
+}
@@ -169,12 +169,38 @@ TEST_CASE("Regression 1", "SparseBitvector") {
     REQUIRE(it == et);
 }
 
-/*
 TEST_CASE("Merge bitvectors (union)", "SparseBitvector") {
-    SparseBitvector B;
-    REQUIRED(false);
+    SparseBitvector B1;
+    SparseBitvector B2;
+
+    // merging empty bitvectors changes nothing
+    REQUIRE(B1.merge(B2) == false);
+
+    B2.set(1);
+    B2.set(100);
+    REQUIRE(B1.merge(B2) == true);
+    REQUIRE(B1.size() == 2);
+    REQUIRE(B1.merge(B2) == false);
+    REQUIRE(B1.merge(B1) == false);
+
+    // the same word, different bits
+    B2.set(2);
+    // new words before, in-between and after the current ones
+    B2.set(0);
+    B2.set(70);
+    B2.set(1000000);
+    REQUIRE(B1.merge(B2) == true);
+    REQUIRE(B1.size() == 6);
+    for (auto x : {0, 1, 2, 70, 100, 1000000})
+        REQUIRE(B1.get(x));
+    REQUIRE(!B1.get(3));
+
+    // B2 is a subset of B1
+    B1.set(5000);
+    REQUIRE(B2.merge(B1) == true);
+    REQUIRE(B2.size() == 7);
+    REQUIRE(B1.merge(B2) == false);
 }
-*/
 
 TEST_CASE("Merge random bitvectors (union)", "SparseBitvector") {
     SparseBitvector B1;
@@ -202,6 +228,13 @@ TEST_CASE("Merge random bitvectors (union)", "SparseBitvector") {
         REQUIRE(B1.get(x));
     }
 
+    size_t num = 0;
+    for (auto x : B1) {
+        REQUIRE((B1_old.get(x) || B2.get(x)));
+        ++num;
+    }
+    REQUIRE(B1.size() == num);
+
 //    B2.merge(B1);
 //    REQUIRE(B1 == B2);
 }
@@ -1,15 +1,31 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 
+#include <random>
+
 #include "dg/analysis/PointsTo/PSNode.h"
 #include "dg/analysis/PointsTo/PointerSubgraph.h"
 #include "dg/analysis/PointsTo/Pointer.h"
+#include "dg/analysis/PointsTo/OffsetMap.h"
 
 using dg::analysis::pta::PSNode;
 using dg::analysis::pta::PSNodeType;
 using dg::analysis::pta::Pointer;
 using dg::analysis::pta::PointerSubgraph;
 using dg::analysis::pta::PointsToSet;
+using dg::analysis::pta::SimplePointsToSet;
+using dg::analysis::pta::HybridPointsToSet;
+using dg::analysis::pta::SharedPointsToSet;
+using dg::analysis::pta::BDDPointsToSet;
+using dg::analysis::pta::PointerIdMapping;
+using dg::analysis::pta::PointsToSetsTable;
+using dg::analysis::pta::NULLPTR;
+using dg::analysis::pta::UNKNOWN_MEMORY;
+using dg::analysis::pta::INVALIDATED;
+using dg::analysis::pta::PointerNull;
+using dg::analysis::pta::PointerUnknown;
+using dg::analysis::pta::OffsetMap;
+using dg::analysis::Offset;
 
 TEST_CASE("Querying empty set", "PointsToSet") {
     PointsToSet B;
@@ -20,7 +36,7 @@ TEST_CASE("Querying empty set", "PointsToSet") {
 TEST_CASE("Add an element", "PointsToSet") {
     PointsToSet B;
     PointerSubgraph PS;
-    PSNode* A = PS.create(PSNodeType::ALLOC);
+    PSNode* A = PS.create<PSNodeType::ALLOC>();
     B.add(Pointer(A, 0));
     REQUIRE(*(B.begin()) == Pointer(A, 0));
 }
@@ -28,7 +44,7 @@ TEST_CASE("Add an element", "PointsToSet") {
 TEST_CASE("Add few elements", "PointsToSet") {
     PointsToSet S;
     PointerSubgraph PS;
-    PSNode* A = PS.create(PSNodeType::ALLOC);
+    PSNode* A = PS.create<PSNodeType::ALLOC>();
     REQUIRE(S.add(Pointer(A, 0)) == true);
     REQUIRE(S.add(Pointer(A, 20)) == true);
     REQUIRE(S.add(Pointer(A, 120)) == true);
@@ -43,8 +59,8 @@ TEST_CASE("Add few elements", "PointsToSet") {
 TEST_CASE("Add few elements 2", "PointsToSet") {
     PointsToSet S;
     PointerSubgraph PS;
-    PSNode* A = PS.create(PSNodeType::ALLOC);
-    PSNode* B = PS.create(PSNodeType::ALLOC);
+    PSNode* A = PS.create<PSNodeType::ALLOC>();
+    PSNode* B = PS.create<PSNodeType::ALLOC>();
     REQUIRE(S.add(Pointer(A, 0)) == true);
     REQUIRE(S.add(Pointer(A, 20)) == true);
     REQUIRE(S.add(Pointer(A, 120)) == true);
@@ -70,8 +86,8 @@ TEST_CASE("Merge points-to sets", "PointsToSet") {
     PointsToSet S1;
     PointsToSet S2;
     PointerSubgraph PS;
-    PSNode* A = PS.create(PSNodeType::ALLOC);
-    PSNode* B = PS.create(PSNodeType::ALLOC);
+    PSNode* A = PS.create<PSNodeType::ALLOC>();
+    PSNode* B = PS.create<PSNodeType::ALLOC>();
 
     REQUIRE(S1.add({A, 0}));
     REQUIRE(S2.add({B, 0}));
@@ -82,3 +98,291 @@ TEST_CASE("Merge points-to sets", "PointsToSet") {
     REQUIRE(S1.size() == 2);
 }
 
+TEST_CASE("Querying empty hybrid set", "HybridPointsToSet") {
+    HybridPointsToSet B;
+    REQUIRE(B.empty());
+    REQUIRE(B.size() == 0);
+    REQUIRE(B.begin() == B.end());
+}
+
+TEST_CASE("Add elements to hybrid set (lifting)", "HybridPointsToSet") {
+    HybridPointsToSet S;
+    PointerSubgraph PS;
+    PSNode* A = PS.create<PSNodeType::ALLOC>();
+    PSNode* B = PS.create<PSNodeType::ALLOC>();
+
+    REQUIRE(S.add(Pointer(A, 0)) == true);
+    REQUIRE(S.add(Pointer(A, 0)) == false);
+    REQUIRE(S.size() == 1);
+    REQUIRE(*(S.begin()) == Pointer(A, 0));
+
+    REQUIRE(S.add(Pointer(B, 8)) == true);
+    REQUIRE(S.size() == 2);
+    // this one does not fit into the inline storage
+    REQUIRE(S.add(Pointer(A, 22332435235)) == true);
+    REQUIRE(S.add(Pointer(B, 8)) == false);
+    REQUIRE(S.size() == 3);
+
+    REQUIRE(S.has(Pointer(A, 0)));
+    REQUIRE(S.has(Pointer(B, 8)));
+    REQUIRE(S.has(Pointer(A, 22332435235)));
+    REQUIRE(!S.has(Pointer(B, 0)));
+
+    size_t n = 0;
+    for (const auto& ptr : S) {
+        REQUIRE(S.has(ptr));
+        ++n;
+    }
+    REQUIRE(n == 3);
+}
+
+TEST_CASE("Unknown offset in hybrid set", "HybridPointsToSet") {
+    PointerSubgraph PS;
+    PSNode* A = PS.create<PSNodeType::ALLOC>();
+    PSNode* B = PS.create<PSNodeType::ALLOC>();
+
+    for (unsigned num : {1, 4}) {
+        HybridPointsToSet S;
+        for (unsigned i = 0; i < num; ++i)
+            REQUIRE(S.add(Pointer(A, i)));
+        REQUIRE(S.add(Pointer(B, 0)));
+
+        REQUIRE(S.add(Pointer(A, Offset::UNKNOWN)));
+        REQUIRE(S.size() == 2);
+        REQUIRE(S.has(Pointer(A, Offset::UNKNOWN)));
+        REQUIRE(S.has(Pointer(B, 0)));
+        REQUIRE(!S.add(Pointer(A, 3)));
+        REQUIRE(!S.add(Pointer(A, Offset::UNKNOWN)));
+        REQUIRE(S.size() == 2);
+    }
+}
+
+TEST_CASE("Copy and merge hybrid sets", "HybridPointsToSet") {
+    PointerSubgraph PS;
+    PSNode* A = PS.create<PSNodeType::ALLOC>();
+    PSNode* B = PS.create<PSNodeType::ALLOC>();
+
+    HybridPointsToSet S1, S2;
+    REQUIRE(S1.add({A, 0}));
+    for (unsigned i = 0; i < 10; ++i)
+        REQUIRE(S2.add({B, i}));
+
+    HybridPointsToSet S3(S2);
+    REQUIRE(S3.size() == 10);
+    REQUIRE(S1.merge(S2));
+    REQUIRE(!S1.merge(S3));
+    REQUIRE(S1.size() == 11);
+    REQUIRE(S2.size() == 10);
+    REQUIRE(S1.has({A, 0}));
+    REQUIRE(S1.has({B, 9}));
+
+    S3 = S1;
+    REQUIRE(S3.size() == 11);
+    S3.swap(S2);
+    REQUIRE(S2.size() == 11);
+    REQUIRE(S3.size() == 10);
+}
+
+// run random operations on the points-to set PTSetT
+// and on SimplePointsToSet and compare the results
+template <typename PTSetT>
+static void compareWithSimpleSet() {
+    std::default_random_engine generator(0x1234);
+    PointerSubgraph PS;
+    PSNode* nodes[] = {
+        PS.create<PSNodeType::ALLOC>(),
+        PS.create<PSNodeType::ALLOC>(),
+        PS.create<PSNodeType::ALLOC>(),
+        PS.create<PSNodeType::ALLOC>(),
+    };
+    const Offset::type offsets[] = {0, 4, 8, 1000, 1UL << 40, Offset::UNKNOWN};
+
+    auto randomPointer = [&]() {
+        auto x = generator();
+        return Pointer(nodes[x % 4], offsets[(x / 4) % 6]);
+    };
+
+    for (unsigned round = 0; round < 100; ++round) {
+        PTSetT H1, H2;
+        SimplePointsToSet S1, S2;
+
+        auto num = generator() % 20;
+        for (unsigned i = 0; i < num; ++i) {
+            auto ptr = randomPointer();
+            REQUIRE(H1.add(ptr) == S1.add(ptr));
+            ptr = randomPointer();
+            REQUIRE(H2.add(ptr) == S2.add(ptr));
+        }
+
+        REQUIRE(H1.merge(H2) == S1.merge(S2));
+        REQUIRE(H1.size() == S1.size());
+        REQUIRE(H1.empty() == S1.empty());
+        for (const auto& ptr : S1)
+            REQUIRE(H1.has(ptr));
+        for (const auto& ptr : H1)
+            REQUIRE(S1.has(ptr));
+    }
+}
+
+TEST_CASE("Compare hybrid set with simple set", "HybridPointsToSet") {
+    compareWithSimpleSet<HybridPointsToSet>();
+}
+
+TEST_CASE("Sharing of interned sets", "SharedPointsToSet") {
+    PointerSubgraph PS;
+    PSNode* A = PS.create<PSNodeType::ALLOC>();
+    PSNode* B = PS.create<PSNodeType::ALLOC>();
+
+    SharedPointsToSet S1, S2, S3;
+    REQUIRE(S1.empty());
+    REQUIRE(S1 == S2);
+
+    REQUIRE(S1.add({A, 0}));
+    REQUIRE(S1.add({B, 4}));
+    REQUIRE(!S1.add({B, 4}));
+    REQUIRE(S1.size() == 2);
+
+    // the same set built in a different order is the same object
+    REQUIRE(S2.add({B, 4}));
+    REQUIRE(S2.add({A, 0}));
+    REQUIRE(S1 == S2);
+    REQUIRE(S1.getId() == S2.getId());
+
+    REQUIRE(S3.merge(S1));
+    REQUIRE(S3 == S1);
+    REQUIRE(!S3.merge(S2));
+
+    REQUIRE(S3.add({A, Offset::UNKNOWN}));
+    REQUIRE(S3 != S1);
+    REQUIRE(S3.size() == 2);
+    REQUIRE(S3.has({A, Offset::UNKNOWN}));
+    REQUIRE(!S3.has({A, 0}));
+    // the original set did not change
+    REQUIRE(S1.has({A, 0}));
+    REQUIRE(S1.size() == 2);
+
+    S3.swap(S1);
+    REQUIRE(S3 == S2);
+}
+
+TEST_CASE("Compare shared set with simple set", "SharedPointsToSet") {
+    compareWithSimpleSet<SharedPointsToSet>();
+}
+
+TEST_CASE("Sharing of BDD sets", "BDDPointsToSet") {
+    PointerSubgraph PS;
+    PSNode* A = PS.create<PSNodeType::ALLOC>();
+    PSNode* B = PS.create<PSNodeType::ALLOC>();
+
+    BDDPointsToSet S1, S2, S3;
+    REQUIRE(S1.empty());
+    REQUIRE(S1 == S2);
+
+    for (unsigned i = 0; i < 100; ++i) {
+        REQUIRE(S1.add({A, i}));
+        REQUIRE(S2.add({A, 99 - i}));
+    }
+    REQUIRE(!S1.add({A, 10}));
+    REQUIRE(S1.size() == 100);
+    REQUIRE(S1 == S2);
+
+    REQUIRE(S3.merge(S1));
+    REQUIRE(S3.add({B, 4}));
+    REQUIRE(!S3.merge(S2));
+    REQUIRE(S3.size() == 101);
+
+    REQUIRE(S3.add({A, Offset::UNKNOWN}));
+    REQUIRE(S3.size() == 2);
+    REQUIRE(S3.has({A, Offset::UNKNOWN}));
+    REQUIRE(S3.has({B, 4}));
+    REQUIRE(!S3.has({A, 0}));
+    // the original set did not change
+    REQUIRE(S1.has({A, 0}));
+    REQUIRE(S1.size() == 100);
+
+    S3.swap(S1);
+    REQUIRE(S1.size() == 2);
+    REQUIRE(S3 == S2);
+}
+
+TEST_CASE("Compare BDD set with simple set", "BDDPointsToSet") {
+    compareWithSimpleSet<BDDPointsToSet>();
+}
+
+TEST_CASE("Release the sets with the last graph", "PointsToSetsTable") {
+    {
+        PointerSubgraph PS;
+        PSNode* A = PS.create<PSNodeType::ALLOC>();
+
+        HybridPointsToSet H;
+        SharedPointsToSet S;
+        BDDPointsToSet B;
+        for (unsigned i = 0; i < 10; ++i) {
+            H.add({A, i});
+            S.add({A, i});
+            B.add({A, i});
+        }
+
+        REQUIRE(PointerIdMapping::get().size() >= 10);
+        REQUIRE(PointsToSetsTable::get().size() > 10);
+        REQUIRE(BDDPointsToSet::nodesNum() > 2);
+    }
+
+    // only the sets of the special nodes are left
+    REQUIRE(PointerIdMapping::get().size() <= 2);
+    REQUIRE(PointsToSetsTable::get().size() <= 3);
+    REQUIRE(NULLPTR->pointsTo.size() == 1);
+    REQUIRE(NULLPTR->pointsTo.count(PointerNull) == 1);
+    REQUIRE(UNKNOWN_MEMORY->pointsTo.size() == 1);
+    REQUIRE(UNKNOWN_MEMORY->pointsTo.count(PointerUnknown) == 1);
+    REQUIRE(INVALIDATED->pointsTo.empty());
+}
+
+TEST_CASE("Offsets are sorted", "OffsetMap") {
+    OffsetMap<int> M;
+    REQUIRE(M.empty());
+    REQUIRE(M.find(0) == M.end());
+
+    M[Offset::UNKNOWN] = 1;
+    M[8] = 2;
+    M[0] = 3;
+    M[16] = 4;
+    M[8] = 5;
+    REQUIRE(M.size() == 4);
+    REQUIRE(M.count(8) == 1);
+    REQUIRE(M.count(4) == 0);
+    REQUIRE(M.find(8)->second == 5);
+    REQUIRE(M.find(Offset::UNKNOWN)->second == 1);
+
+    // the known offsets go in the ascending order, the unknown offset is last
+    std::vector<Offset> offsets;
+    for (const auto& it : M)
+        offsets.push_back(it.first);
+    REQUIRE(offsets == std::vector<Offset>{0, 8, 16, Offset::UNKNOWN});
+    REQUIRE(M.knownEnd() + 1 == M.end());
+}
+
+TEST_CASE("Range of offsets", "OffsetMap") {
+    OffsetMap<int> M;
+    for (int i = 0; i < 10; ++i)
+        M[4 * i] = i;
+
+    REQUIRE(M.knownEnd() == M.end());
+    REQUIRE(M.lower_bound(8)->second == 2);
+    REQUIRE(M.lower_bound(9)->second == 3);
+    REQUIRE(M.lower_bound(100) == M.end());
+    REQUIRE(M.lower_bound(Offset::UNKNOWN) == M.end());
+
+    M[Offset::UNKNOWN] = 42;
+    REQUIRE(M.lower_bound(100) == M.knownEnd());
+    REQUIRE(M.lower_bound(Offset::UNKNOWN) == M.knownEnd());
+
+    int sum = 0;
+    for (auto it = M.lower_bound(10); it != M.knownEnd() && *it->first < 20; ++it)
+        sum += it->second;
+    REQUIRE(sum == 3 + 4);
+
+    M.clear();
+    REQUIRE(M.empty());
+    REQUIRE(M.knownEnd() == M.end());
+}
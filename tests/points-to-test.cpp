@@ -2,13 +2,19 @@
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
+#include <map>
 
 #include "test-runner.h"
 #include "test-dg.h"
 
 #include "dg/analysis/PointsTo/PointerSubgraph.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFI.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFIBDD.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFS.h"
+#include "dg/analysis/PointsTo/PointerAnalysisSFS.h"
+#include "dg/analysis/PointsTo/PointerAnalysisDemand.h"
+#include "dg/analysis/PointsTo/PointerSubgraphOptimizations.h"
+#include "dg/analysis/PointsTo/PointsToCache.h"
 
 namespace dg {
 namespace tests {
@@ -27,10 +33,10 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
-        PSNode *B = PS.create(PSNodeType::ALLOC);
-        PSNode *S = PS.create(PSNodeType::STORE, A, B);
-        PSNode *L = PS.create(PSNodeType::LOAD, B);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *S = PS.create<PSNodeType::STORE>(A, B);
+        PSNode *L = PS.create<PSNodeType::LOAD>(B);
 
         A->addSuccessor(B);
         B->addSuccessor(S);
@@ -48,14 +54,14 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
-        PSNode *B = PS.create(PSNodeType::ALLOC);
-        PSNode *C = PS.create(PSNodeType::ALLOC);
-        PSNode *S1 = PS.create(PSNodeType::STORE, A, B);
-        PSNode *S2 = PS.create(PSNodeType::STORE, C, B);
-        PSNode *L1 = PS.create(PSNodeType::LOAD, B);
-        PSNode *L2 = PS.create(PSNodeType::LOAD, B);
-        PSNode *L3 = PS.create(PSNodeType::LOAD, B);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *C = PS.create<PSNodeType::ALLOC>();
+        PSNode *S1 = PS.create<PSNodeType::STORE>(A, B);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(C, B);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(B);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(B);
+        PSNode *L3 = PS.create<PSNodeType::LOAD>(B);
 
         /*
          *        A
@@ -94,13 +100,13 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
-        PSNode *B = PS.create(PSNodeType::ALLOC);
-        PSNode *C = PS.create(PSNodeType::ALLOC);
-        PSNode *S1 = PS.create(PSNodeType::STORE, A, B);
-        PSNode *L1 = PS.create(PSNodeType::LOAD, B);
-        PSNode *S2 = PS.create(PSNodeType::STORE, C, B);
-        PSNode *L2 = PS.create(PSNodeType::LOAD, B);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *C = PS.create<PSNodeType::ALLOC>();
+        PSNode *S1 = PS.create<PSNodeType::STORE>(A, B);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(B);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(C, B);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(B);
 
         A->addSuccessor(B);
         B->addSuccessor(C);
@@ -122,15 +128,15 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
         A->setSize(8);
-        PSNode *B = PS.create(PSNodeType::ALLOC);
-        PSNode *C = PS.create(PSNodeType::ALLOC);
-        PSNode *GEP = PS.create(PSNodeType::GEP, A, 4);
-        PSNode *S1 = PS.create(PSNodeType::STORE, GEP, B);
-        PSNode *L1 = PS.create(PSNodeType::LOAD, B);
-        PSNode *S2 = PS.create(PSNodeType::STORE, C, B);
-        PSNode *L2 = PS.create(PSNodeType::LOAD, B);
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *C = PS.create<PSNodeType::ALLOC>();
+        PSNode *GEP = PS.create<PSNodeType::GEP>(A, 4);
+        PSNode *S1 = PS.create<PSNodeType::STORE>(GEP, B);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(B);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(C, B);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(B);
 
         A->addSuccessor(B);
         B->addSuccessor(C);
@@ -153,18 +159,18 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
         A->setSize(8);
-        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
         B->setSize(16);
-        PSNode *C = PS.create(PSNodeType::ALLOC);
-        PSNode *GEP1 = PS.create(PSNodeType::GEP, A, 4);
-        PSNode *GEP2 = PS.create(PSNodeType::GEP, B, 8);
-        PSNode *S1 = PS.create(PSNodeType::STORE, GEP1, GEP2);
-        PSNode *GEP3 = PS.create(PSNodeType::GEP, B, 8);
-        PSNode *L1 = PS.create(PSNodeType::LOAD, GEP3);
-        PSNode *S2 = PS.create(PSNodeType::STORE, C, B);
-        PSNode *L2 = PS.create(PSNodeType::LOAD, B);
+        PSNode *C = PS.create<PSNodeType::ALLOC>();
+        PSNode *GEP1 = PS.create<PSNodeType::GEP>(A, 4);
+        PSNode *GEP2 = PS.create<PSNodeType::GEP>(B, 8);
+        PSNode *S1 = PS.create<PSNodeType::STORE>(GEP1, GEP2);
+        PSNode *GEP3 = PS.create<PSNodeType::GEP>(B, 8);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(GEP3);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(C, B);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(B);
 
         A->addSuccessor(B);
         B->addSuccessor(C);
@@ -189,15 +195,15 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
         // we must set size, so that GEP won't
         // make the offset UNKNOWN
         A->setSize(8);
-        PSNode *B = PS.create(PSNodeType::ALLOC);
-        PSNode *GEP1 = PS.create(PSNodeType::GEP, A, 4);
-        PSNode *S = PS.create(PSNodeType::STORE, B, GEP1);
-        PSNode *GEP2 = PS.create(PSNodeType::GEP, A, 4);
-        PSNode *L = PS.create(PSNodeType::LOAD, GEP2);
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *GEP1 = PS.create<PSNodeType::GEP>(A, 4);
+        PSNode *S = PS.create<PSNodeType::STORE>(B, GEP1);
+        PSNode *GEP2 = PS.create<PSNodeType::GEP>(A, 4);
+        PSNode *L = PS.create<PSNodeType::LOAD>(GEP2);
 
         A->addSuccessor(B);
         B->addSuccessor(GEP1);
@@ -219,14 +225,14 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
         A->setSize(16);
-        PSNode *B = PS.create(PSNodeType::ALLOC);
-        PSNode *GEP1 = PS.create(PSNodeType::GEP, A, 4);
-        PSNode *GEP2 = PS.create(PSNodeType::GEP, GEP1, 4);
-        PSNode *S = PS.create(PSNodeType::STORE, B, GEP2);
-        PSNode *GEP3 = PS.create(PSNodeType::GEP, A, 8);
-        PSNode *L = PS.create(PSNodeType::LOAD, GEP3);
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *GEP1 = PS.create<PSNodeType::GEP>(A, 4);
+        PSNode *GEP2 = PS.create<PSNodeType::GEP>(GEP1, 4);
+        PSNode *S = PS.create<PSNodeType::STORE>(B, GEP2);
+        PSNode *GEP3 = PS.create<PSNodeType::GEP>(A, 8);
+        PSNode *L = PS.create<PSNodeType::LOAD>(GEP3);
 
         A->addSuccessor(B);
         B->addSuccessor(GEP1);
@@ -251,18 +257,18 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
-        PSNode *B = PS.create(PSNodeType::ALLOC);
-        PSNode *ARRAY = PS.create(PSNodeType::ALLOC);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *ARRAY = PS.create<PSNodeType::ALLOC>();
         ARRAY->setSize(40);
-        PSNode *GEP1 = PS.create(PSNodeType::GEP, ARRAY, 0);
-        PSNode *GEP2 = PS.create(PSNodeType::GEP, ARRAY, 4);
-        PSNode *S1 = PS.create(PSNodeType::STORE, A, GEP1);
-        PSNode *S2 = PS.create(PSNodeType::STORE, B, GEP2);
-        PSNode *GEP3 = PS.create(PSNodeType::GEP, ARRAY, 0);
-        PSNode *GEP4 = PS.create(PSNodeType::GEP, ARRAY, 4);
-        PSNode *L1 = PS.create(PSNodeType::LOAD, GEP3);
-        PSNode *L2 = PS.create(PSNodeType::LOAD, GEP4);
+        PSNode *GEP1 = PS.create<PSNodeType::GEP>(ARRAY, 0);
+        PSNode *GEP2 = PS.create<PSNodeType::GEP>(ARRAY, 4);
+        PSNode *S1 = PS.create<PSNodeType::STORE>(A, GEP1);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(B, GEP2);
+        PSNode *GEP3 = PS.create<PSNodeType::GEP>(ARRAY, 0);
+        PSNode *GEP4 = PS.create<PSNodeType::GEP>(ARRAY, 4);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(GEP3);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(GEP4);
 
         A->addSuccessor(B);
         B->addSuccessor(ARRAY);
@@ -288,18 +294,18 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
-        PSNode *B = PS.create(PSNodeType::ALLOC);
-        PSNodeAlloc *ARRAY = PSNodeAlloc::get(PS.create(PSNodeType::ALLOC));
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNodeAlloc *ARRAY = PSNodeAlloc::get(PS.create<PSNodeType::ALLOC>());
         ARRAY->setSize(40);
-        PSNode *GEP1 = PS.create(PSNodeType::GEP, ARRAY, 0);
-        PSNode *GEP2 = PS.create(PSNodeType::GEP, ARRAY, 4);
-        PSNode *S1 = PS.create(PSNodeType::STORE, A, GEP1);
-        PSNode *S2 = PS.create(PSNodeType::STORE, B, GEP2);
-        PSNode *GEP3 = PS.create(PSNodeType::GEP, ARRAY, 0);
-        PSNode *GEP4 = PS.create(PSNodeType::GEP, ARRAY, 4);
-        PSNode *L1 = PS.create(PSNodeType::LOAD, GEP3);
-        PSNode *L2 = PS.create(PSNodeType::LOAD, GEP4);
+        PSNode *GEP1 = PS.create<PSNodeType::GEP>(ARRAY, 0);
+        PSNode *GEP2 = PS.create<PSNodeType::GEP>(ARRAY, 4);
+        PSNode *S1 = PS.create<PSNodeType::STORE>(A, GEP1);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(B, GEP2);
+        PSNode *GEP3 = PS.create<PSNodeType::GEP>(ARRAY, 0);
+        PSNode *GEP4 = PS.create<PSNodeType::GEP>(ARRAY, 4);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(GEP3);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(GEP4);
 
         A->addSuccessor(B);
         B->addSuccessor(ARRAY);
@@ -329,21 +335,21 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
-        PSNode *B = PS.create(PSNodeType::ALLOC);
-        PSNode *ARRAY = PS.create(PSNodeType::ALLOC);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *ARRAY = PS.create<PSNodeType::ALLOC>();
         ARRAY->setSize(20);
-        PSNode *GEP1 = PS.create(PSNodeType::GEP, ARRAY, 0);
-        PSNode *GEP2 = PS.create(PSNodeType::GEP, ARRAY, 4);
-        PSNode *S1 = PS.create(PSNodeType::STORE, A, GEP1);
-        PSNode *S2 = PS.create(PSNodeType::STORE, B, GEP2);
-        PSNode *GEP3 = PS.create(PSNodeType::GEP, ARRAY, 0);
-        PSNode *GEP4 = PS.create(PSNodeType::GEP, ARRAY, 4);
-        PSNode *L1 = PS.create(PSNodeType::LOAD, GEP3);
-        PSNode *L2 = PS.create(PSNodeType::LOAD, GEP4);
-        PSNode *GEP5 = PS.create(PSNodeType::GEP, ARRAY, 0);
-        PSNode *S3 = PS.create(PSNodeType::STORE, B, GEP5);
-        PSNode *L3 = PS.create(PSNodeType::LOAD, GEP5);
+        PSNode *GEP1 = PS.create<PSNodeType::GEP>(ARRAY, 0);
+        PSNode *GEP2 = PS.create<PSNodeType::GEP>(ARRAY, 4);
+        PSNode *S1 = PS.create<PSNodeType::STORE>(A, GEP1);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(B, GEP2);
+        PSNode *GEP3 = PS.create<PSNodeType::GEP>(ARRAY, 0);
+        PSNode *GEP4 = PS.create<PSNodeType::GEP>(ARRAY, 4);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(GEP3);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(GEP4);
+        PSNode *GEP5 = PS.create<PSNodeType::GEP>(ARRAY, 0);
+        PSNode *S3 = PS.create<PSNodeType::STORE>(B, GEP5);
+        PSNode *L3 = PS.create<PSNodeType::LOAD>(GEP5);
 
         A->addSuccessor(B);
         B->addSuccessor(ARRAY);
@@ -378,9 +384,9 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *B = PS.create(PSNodeType::ALLOC);
-        PSNode *S = PS.create(PSNodeType::STORE, pta::NULLPTR, B);
-        PSNode *L = PS.create(PSNodeType::LOAD, B);
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *S = PS.create<PSNodeType::STORE>(pta::NULLPTR, B);
+        PSNode *L = PS.create<PSNodeType::LOAD>(B);
 
         B->addSuccessor(S);
         S->addSuccessor(L);
@@ -397,13 +403,13 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
-        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
         B->setSize(16);
-        PSNode *C = PS.create(PSNodeType::CONSTANT, B, 4);
-        PSNode *S = PS.create(PSNodeType::STORE, A, C);
-        PSNode *GEP = PS.create(PSNodeType::GEP, B, 4);
-        PSNode *L = PS.create(PSNodeType::LOAD, GEP);
+        PSNode *C = PS.create<PSNodeType::CONSTANT>(B, 4);
+        PSNode *S = PS.create<PSNodeType::STORE>(A, C);
+        PSNode *GEP = PS.create<PSNodeType::GEP>(B, 4);
+        PSNode *L = PS.create<PSNodeType::LOAD>(GEP);
 
         A->addSuccessor(B);
         B->addSuccessor(S);
@@ -422,9 +428,9 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNodeAlloc *B = PSNodeAlloc::get(PS.create(PSNodeType::ALLOC));
+        PSNodeAlloc *B = PSNodeAlloc::get(PS.create<PSNodeType::ALLOC>());
         B->setZeroInitialized();
-        PSNode *L = PS.create(PSNodeType::LOAD, B);
+        PSNode *L = PS.create<PSNodeType::LOAD>(B);
 
         B->addSuccessor(L);
 
@@ -440,13 +446,13 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
-        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
         B->setSize(20);
-        PSNode *GEP = PS.create(PSNodeType::GEP, B, Offset::UNKNOWN);
-        PSNode *S = PS.create(PSNodeType::STORE, A, GEP);
-        PSNode *GEP2 = PS.create(PSNodeType::GEP, B, 4);
-        PSNode *L = PS.create(PSNodeType::LOAD, GEP2); // load from B + 4
+        PSNode *GEP = PS.create<PSNodeType::GEP>(B, Offset::UNKNOWN);
+        PSNode *S = PS.create<PSNodeType::STORE>(A, GEP);
+        PSNode *GEP2 = PS.create<PSNodeType::GEP>(B, 4);
+        PSNode *L = PS.create<PSNodeType::LOAD>(GEP2); // load from B + 4
 
         A->addSuccessor(B);
         B->addSuccessor(GEP);
@@ -468,13 +474,13 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
-        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
         B->setSize(20);
-        PSNode *GEP = PS.create(PSNodeType::GEP, B, 4);
-        PSNode *S = PS.create(PSNodeType::STORE, A, GEP);
-        PSNode *GEP2 = PS.create(PSNodeType::GEP, B, Offset::UNKNOWN);
-        PSNode *L = PS.create(PSNodeType::LOAD, GEP2); // load from B + Offset::UNKNOWN
+        PSNode *GEP = PS.create<PSNodeType::GEP>(B, 4);
+        PSNode *S = PS.create<PSNodeType::STORE>(A, GEP);
+        PSNode *GEP2 = PS.create<PSNodeType::GEP>(B, Offset::UNKNOWN);
+        PSNode *L = PS.create<PSNodeType::LOAD>(GEP2); // load from B + Offset::UNKNOWN
 
         A->addSuccessor(B);
         B->addSuccessor(GEP);
@@ -496,13 +502,13 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
-        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
         B->setSize(20);
-        PSNode *GEP = PS.create(PSNodeType::GEP, B, Offset::UNKNOWN);
-        PSNode *S = PS.create(PSNodeType::STORE, A, GEP);
-        PSNode *GEP2 = PS.create(PSNodeType::GEP, B, Offset::UNKNOWN);
-        PSNode *L = PS.create(PSNodeType::LOAD, GEP2);
+        PSNode *GEP = PS.create<PSNodeType::GEP>(B, Offset::UNKNOWN);
+        PSNode *S = PS.create<PSNodeType::STORE>(A, GEP);
+        PSNode *GEP2 = PS.create<PSNodeType::GEP>(B, Offset::UNKNOWN);
+        PSNode *L = PS.create<PSNodeType::LOAD>(GEP2);
 
         A->addSuccessor(B);
         B->addSuccessor(GEP);
@@ -522,34 +528,34 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
         A->setSize(20);
-        PSNode *SRC = PS.create(PSNodeType::ALLOC);
+        PSNode *SRC = PS.create<PSNodeType::ALLOC>();
         SRC->setSize(16);
-        PSNode *DEST = PS.create(PSNodeType::ALLOC);
+        PSNode *DEST = PS.create<PSNodeType::ALLOC>();
         DEST->setSize(16);
 
         /* initialize SRC, so that
          * it will point to A + 3 and A + 12
          * at offsets 4 and 8 */
-        PSNode *GEP1 = PS.create(PSNodeType::GEP, A, 3);
-        PSNode *GEP2 = PS.create(PSNodeType::GEP, A, 12);
-        PSNode *G1 = PS.create(PSNodeType::GEP, SRC, 4);
-        PSNode *G2 = PS.create(PSNodeType::GEP, SRC, 8);
-        PSNode *S1 = PS.create(PSNodeType::STORE, GEP1, G1);
-        PSNode *S2 = PS.create(PSNodeType::STORE, GEP2, G2);
+        PSNode *GEP1 = PS.create<PSNodeType::GEP>(A, 3);
+        PSNode *GEP2 = PS.create<PSNodeType::GEP>(A, 12);
+        PSNode *G1 = PS.create<PSNodeType::GEP>(SRC, 4);
+        PSNode *G2 = PS.create<PSNodeType::GEP>(SRC, 8);
+        PSNode *S1 = PS.create<PSNodeType::STORE>(GEP1, G1);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(GEP2, G2);
 
         /* copy the memory,
          * after this node dest should point to
          * A + 3 and A + 12 at offsets 4 and 8 */
-        PSNode *CPY = PS.create(PSNodeType::MEMCPY, SRC, DEST,
+        PSNode *CPY = PS.create<PSNodeType::MEMCPY>(SRC, DEST,
                                 Offset::UNKNOWN /* len = all */);
 
         /* load from the dest memory */
-        PSNode *G3 = PS.create(PSNodeType::GEP, DEST, 4);
-        PSNode *G4 = PS.create(PSNodeType::GEP, DEST, 8);
-        PSNode *L1 = PS.create(PSNodeType::LOAD, G3);
-        PSNode *L2 = PS.create(PSNodeType::LOAD, G4);
+        PSNode *G3 = PS.create<PSNodeType::GEP>(DEST, 4);
+        PSNode *G4 = PS.create<PSNodeType::GEP>(DEST, 8);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(G3);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(G4);
 
         A->addSuccessor(SRC);
         SRC->addSuccessor(DEST);
@@ -578,34 +584,34 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
         A->setSize(20);
-        PSNode *SRC = PS.create(PSNodeType::ALLOC);
+        PSNode *SRC = PS.create<PSNodeType::ALLOC>();
         SRC->setSize(16);
-        PSNode *DEST = PS.create(PSNodeType::ALLOC);
+        PSNode *DEST = PS.create<PSNodeType::ALLOC>();
         DEST->setSize(16);
 
         /* initialize SRC, so that
          * it will point to A + 3 and A + 12
          * at offsets 4 and 8 */
-        PSNode *GEP1 = PS.create(PSNodeType::GEP, A, 3);
-        PSNode *GEP2 = PS.create(PSNodeType::GEP, A, 12);
-        PSNode *G1 = PS.create(PSNodeType::GEP, SRC, 4);
-        PSNode *G2 = PS.create(PSNodeType::GEP, SRC, 8);
-        PSNode *S1 = PS.create(PSNodeType::STORE, GEP1, G1);
-        PSNode *S2 = PS.create(PSNodeType::STORE, GEP2, G2);
+        PSNode *GEP1 = PS.create<PSNodeType::GEP>(A, 3);
+        PSNode *GEP2 = PS.create<PSNodeType::GEP>(A, 12);
+        PSNode *G1 = PS.create<PSNodeType::GEP>(SRC, 4);
+        PSNode *G2 = PS.create<PSNodeType::GEP>(SRC, 8);
+        PSNode *S1 = PS.create<PSNodeType::STORE>(GEP1, G1);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(GEP2, G2);
 
         /* copy first 8 bytes from the memory,
          * after this node dest should point to
          * A + 3 at offset 4  = PS.create(8 is 9th byte,
          * so it should not be included) */
-        PSNode *CPY = PS.create(PSNodeType::MEMCPY, SRC, DEST, 8 /* len*/);
+        PSNode *CPY = PS.create<PSNodeType::MEMCPY>(SRC, DEST, 8 /* len*/);
 
         /* load from the dest memory */
-        PSNode *G3 = PS.create(PSNodeType::GEP, DEST, 4);
-        PSNode *G4 = PS.create(PSNodeType::GEP, DEST, 8);
-        PSNode *L1 = PS.create(PSNodeType::LOAD, G3);
-        PSNode *L2 = PS.create(PSNodeType::LOAD, G4);
+        PSNode *G3 = PS.create<PSNodeType::GEP>(DEST, 4);
+        PSNode *G4 = PS.create<PSNodeType::GEP>(DEST, 8);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(G3);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(G4);
 
         A->addSuccessor(SRC);
         SRC->addSuccessor(DEST);
@@ -634,34 +640,34 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
         A->setSize(20);
-        PSNode *SRC = PS.create(PSNodeType::ALLOC);
+        PSNode *SRC = PS.create<PSNodeType::ALLOC>();
         SRC->setSize(16);
-        PSNode *DEST = PS.create(PSNodeType::ALLOC);
+        PSNode *DEST = PS.create<PSNodeType::ALLOC>();
         DEST->setSize(16);
 
         /* initialize SRC, so that
          * it will point to A + 3 and A + 12
          * at offsets 4 and 8 */
-        PSNode *GEP1 = PS.create(PSNodeType::GEP, A, 3);
-        PSNode *GEP2 = PS.create(PSNodeType::GEP, A, 12);
-        PSNode *G1 = PS.create(PSNodeType::GEP, SRC, 4);
-        PSNode *G2 = PS.create(PSNodeType::GEP, SRC, 8);
-        PSNode *S1 = PS.create(PSNodeType::STORE, GEP1, G1);
-        PSNode *S2 = PS.create(PSNodeType::STORE, GEP2, G2);
+        PSNode *GEP1 = PS.create<PSNodeType::GEP>(A, 3);
+        PSNode *GEP2 = PS.create<PSNodeType::GEP>(A, 12);
+        PSNode *G1 = PS.create<PSNodeType::GEP>(SRC, 4);
+        PSNode *G2 = PS.create<PSNodeType::GEP>(SRC, 8);
+        PSNode *S1 = PS.create<PSNodeType::STORE>(GEP1, G1);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(GEP2, G2);
 
         /* copy memory from 8 bytes and further
          * after this node dest should point to
          * A + 12 at offset 0 */
-        PSNode *CPY = PS.create(PSNodeType::MEMCPY, G2, DEST,
+        PSNode *CPY = PS.create<PSNodeType::MEMCPY>(G2, DEST,
                                 Offset::UNKNOWN /* len*/);
 
         /* load from the dest memory */
-        PSNode *G3 = PS.create(PSNodeType::GEP, DEST, 4);
-        PSNode *G4 = PS.create(PSNodeType::GEP, DEST, 0);
-        PSNode *L1 = PS.create(PSNodeType::LOAD, G3);
-        PSNode *L2 = PS.create(PSNodeType::LOAD, G4);
+        PSNode *G3 = PS.create<PSNodeType::GEP>(DEST, 4);
+        PSNode *G4 = PS.create<PSNodeType::GEP>(DEST, 0);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(G3);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(G4);
 
         A->addSuccessor(SRC);
         SRC->addSuccessor(DEST);
@@ -690,29 +696,29 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNodeAlloc *A = PSNodeAlloc::get(PS.create(PSNodeType::ALLOC));
+        PSNodeAlloc *A = PSNodeAlloc::get(PS.create<PSNodeType::ALLOC>());
         A->setSize(20);
-        PSNodeAlloc *SRC = PSNodeAlloc::get(PS.create(PSNodeType::ALLOC));
+        PSNodeAlloc *SRC = PSNodeAlloc::get(PS.create<PSNodeType::ALLOC>());
         SRC->setSize(16);
         SRC->setZeroInitialized();
-        PSNode *DEST = PS.create(PSNodeType::ALLOC);
+        PSNode *DEST = PS.create<PSNodeType::ALLOC>();
         DEST->setSize(16);
 
         /* initialize SRC, so that it will point to A + 3 at offset 4 */
-        PSNode *GEP1 = PS.create(PSNodeType::GEP, A, 3);
-        PSNode *G1 = PS.create(PSNodeType::GEP, SRC, 4);
-        PSNode *S1 = PS.create(PSNodeType::STORE, GEP1, G1);
+        PSNode *GEP1 = PS.create<PSNodeType::GEP>(A, 3);
+        PSNode *G1 = PS.create<PSNodeType::GEP>(SRC, 4);
+        PSNode *S1 = PS.create<PSNodeType::STORE>(GEP1, G1);
 
         /* copy memory from 8 bytes and further after this node dest should
          * point to NULL */
-        PSNode *G3 = PS.create(PSNodeType::GEP, SRC, 8);
-        PSNode *CPY = PS.create(PSNodeType::MEMCPY, G3, DEST,
+        PSNode *G3 = PS.create<PSNodeType::GEP>(SRC, 8);
+        PSNode *CPY = PS.create<PSNodeType::MEMCPY>(G3, DEST,
                                 Offset::UNKNOWN /* len*/);
 
         /* load from the dest memory */
-        PSNode *G4 = PS.create(PSNodeType::GEP, DEST, 0);
-        PSNode *L1 = PS.create(PSNodeType::LOAD, G3);
-        PSNode *L2 = PS.create(PSNodeType::LOAD, G4);
+        PSNode *G4 = PS.create<PSNodeType::GEP>(DEST, 0);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(G3);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(G4);
 
         A->addSuccessor(SRC);
         SRC->addSuccessor(DEST);
@@ -738,25 +744,25 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
         A->setSize(20);
-        PSNode *SRC = PS.create(PSNodeType::ALLOC);
+        PSNode *SRC = PS.create<PSNodeType::ALLOC>();
         SRC->setSize(16);
-        PSNode *DEST = PS.create(PSNodeType::ALLOC);
+        PSNode *DEST = PS.create<PSNodeType::ALLOC>();
         DEST->setSize(16);
 
-        PSNode *GEP1 = PS.create(PSNodeType::GEP, A, 3);
-        PSNode *G1 = PS.create(PSNodeType::GEP, SRC, 4);
-        PSNode *S1 = PS.create(PSNodeType::STORE, GEP1, G1);
+        PSNode *GEP1 = PS.create<PSNodeType::GEP>(A, 3);
+        PSNode *G1 = PS.create<PSNodeType::GEP>(SRC, 4);
+        PSNode *S1 = PS.create<PSNodeType::STORE>(GEP1, G1);
 
         // copy the only pointer to dest + 0
-        PSNode *CPY = PS.create(PSNodeType::MEMCPY, G1, DEST, 1);
+        PSNode *CPY = PS.create<PSNodeType::MEMCPY>(G1, DEST, 1);
 
         /* load from the dest memory */
-        PSNode *G3 = PS.create(PSNodeType::GEP, DEST, 0);
-        PSNode *L1 = PS.create(PSNodeType::LOAD, G3);
-        PSNode *G4 = PS.create(PSNodeType::GEP, DEST, 1);
-        PSNode *L2 = PS.create(PSNodeType::LOAD, G4);
+        PSNode *G3 = PS.create<PSNodeType::GEP>(DEST, 0);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(G3);
+        PSNode *G4 = PS.create<PSNodeType::GEP>(DEST, 1);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(G4);
 
         A->addSuccessor(SRC);
         SRC->addSuccessor(DEST);
@@ -782,23 +788,23 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
         A->setSize(20);
-        PSNode *SRC = PS.create(PSNodeType::ALLOC);
+        PSNode *SRC = PS.create<PSNodeType::ALLOC>();
         SRC->setSize(16);
-        PSNode *DEST = PS.create(PSNodeType::ALLOC);
+        PSNode *DEST = PS.create<PSNodeType::ALLOC>();
         DEST->setSize(16);
 
-        PSNode *GEP1 = PS.create(PSNodeType::GEP, A, 3);
-        PSNode *G1 = PS.create(PSNodeType::GEP, SRC, 4);
-        PSNode *S1 = PS.create(PSNodeType::STORE, GEP1, G1);
-        PSNode *G3 = PS.create(PSNodeType::GEP, DEST, 5);
-        PSNode *G4 = PS.create(PSNodeType::GEP, DEST, 1);
+        PSNode *GEP1 = PS.create<PSNodeType::GEP>(A, 3);
+        PSNode *G1 = PS.create<PSNodeType::GEP>(SRC, 4);
+        PSNode *S1 = PS.create<PSNodeType::STORE>(GEP1, G1);
+        PSNode *G3 = PS.create<PSNodeType::GEP>(DEST, 5);
+        PSNode *G4 = PS.create<PSNodeType::GEP>(DEST, 1);
 
-        PSNode *CPY = PS.create(PSNodeType::MEMCPY, SRC, G4, 8);
+        PSNode *CPY = PS.create<PSNodeType::MEMCPY>(SRC, G4, 8);
 
         /* load from the dest memory */
-        PSNode *L1 = PS.create(PSNodeType::LOAD, G3);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(G3);
 
         A->addSuccessor(SRC);
         SRC->addSuccessor(DEST);
@@ -822,25 +828,25 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNodeAlloc *A = PSNodeAlloc::get(PS.create(PSNodeType::ALLOC));
-        PSNodeAlloc *SRC = PSNodeAlloc::get(PS.create(PSNodeType::ALLOC));
-        PSNode *DEST = PS.create(PSNodeType::ALLOC);
+        PSNodeAlloc *A = PSNodeAlloc::get(PS.create<PSNodeType::ALLOC>());
+        PSNodeAlloc *SRC = PSNodeAlloc::get(PS.create<PSNodeType::ALLOC>());
+        PSNode *DEST = PS.create<PSNodeType::ALLOC>();
 
         A->setSize(20);
         SRC->setSize(16);
         SRC->setZeroInitialized();
         DEST->setSize(16);
 
-        PSNode *CPY = PS.create(PSNodeType::MEMCPY, SRC, DEST,
+        PSNode *CPY = PS.create<PSNodeType::MEMCPY>(SRC, DEST,
                                 Offset::UNKNOWN /* len*/);
 
         /* load from the dest memory */
-        PSNode *G4 = PS.create(PSNodeType::GEP, DEST, 0);
-        PSNode *G5 = PS.create(PSNodeType::GEP, DEST, 4);
-        PSNode *G6 = PS.create(PSNodeType::GEP, DEST, Offset::UNKNOWN);
-        PSNode *L1 = PS.create(PSNodeType::LOAD, G4);
-        PSNode *L2 = PS.create(PSNodeType::LOAD, G5);
-        PSNode *L3 = PS.create(PSNodeType::LOAD, G6);
+        PSNode *G4 = PS.create<PSNodeType::GEP>(DEST, 0);
+        PSNode *G5 = PS.create<PSNodeType::GEP>(DEST, 4);
+        PSNode *G6 = PS.create<PSNodeType::GEP>(DEST, Offset::UNKNOWN);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(G4);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(G5);
+        PSNode *L3 = PS.create<PSNodeType::LOAD>(G6);
 
         A->addSuccessor(SRC);
         SRC->addSuccessor(DEST);
@@ -866,27 +872,27 @@ public:
         using namespace analysis;
 
         PointerSubgraph PS;
-        PSNodeAlloc *A = PSNodeAlloc::get(PS.create(PSNodeType::ALLOC));
+        PSNodeAlloc *A = PSNodeAlloc::get(PS.create<PSNodeType::ALLOC>());
         A->setSize(20);
-        PSNodeAlloc *SRC = PSNodeAlloc::get(PS.create(PSNodeType::ALLOC));
+        PSNodeAlloc *SRC = PSNodeAlloc::get(PS.create<PSNodeType::ALLOC>());
         SRC->setSize(16);
         SRC->setZeroInitialized();
-        PSNode *DEST = PS.create(PSNodeType::ALLOC);
+        PSNode *DEST = PS.create<PSNodeType::ALLOC>();
         DEST->setSize(16);
 
         /* initialize SRC, so that it will point to A + 3 at offset 0 */
-        PSNode *GEP1 = PS.create(PSNodeType::GEP, A, 3);
-        PSNode *S1 = PS.create(PSNodeType::STORE, GEP1, SRC);
+        PSNode *GEP1 = PS.create<PSNodeType::GEP>(A, 3);
+        PSNode *S1 = PS.create<PSNodeType::STORE>(GEP1, SRC);
 
-        PSNode *CPY = PS.create(PSNodeType::MEMCPY, SRC, DEST, 10);
+        PSNode *CPY = PS.create<PSNodeType::MEMCPY>(SRC, DEST, 10);
 
         /* load from the dest memory */
-        PSNode *G1 = PS.create(PSNodeType::GEP, DEST, 0);
-        PSNode *G3 = PS.create(PSNodeType::GEP, DEST, 4);
-        PSNode *G4 = PS.create(PSNodeType::GEP, DEST, 8);
-        PSNode *L1 = PS.create(PSNodeType::LOAD, G1);
-        PSNode *L2 = PS.create(PSNodeType::LOAD, G3);
-        PSNode *L3 = PS.create(PSNodeType::LOAD, G4);
+        PSNode *G1 = PS.create<PSNodeType::GEP>(DEST, 0);
+        PSNode *G3 = PS.create<PSNodeType::GEP>(DEST, 4);
+        PSNode *G4 = PS.create<PSNodeType::GEP>(DEST, 8);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(G1);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(G3);
+        PSNode *L3 = PS.create<PSNodeType::LOAD>(G4);
 
         A->addSuccessor(SRC);
         SRC->addSuccessor(DEST);
@@ -909,6 +915,92 @@ public:
         check(L3->doesPointsTo(NULLPTR), "L3 does not point to NULL");
     }
 
+    // the pointers stored in the loop must get to the nodes
+    // that have already processed the pointers from the first iteration
+    void loop_propagation()
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS;
+        PSNode *X = PS.create<PSNodeType::ALLOC>();
+        PSNode *Y = PS.create<PSNodeType::ALLOC>();
+        PSNode *P = PS.create<PSNodeType::ALLOC>();
+        P->setSize(8);
+        PSNode *Q = PS.create<PSNodeType::ALLOC>();
+        Q->setSize(8);
+        PSNode *S1 = PS.create<PSNodeType::STORE>(X, P);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(P);
+        PSNode *C = PS.create<PSNodeType::CAST>(L1);
+        PSNode *CPY = PS.create<PSNodeType::MEMCPY>(P, Q, 8);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(Q);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(Y, P);
+
+        X->addSuccessor(Y);
+        Y->addSuccessor(P);
+        P->addSuccessor(Q);
+        Q->addSuccessor(S1);
+        S1->addSuccessor(L1);
+        L1->addSuccessor(C);
+        C->addSuccessor(CPY);
+        CPY->addSuccessor(L2);
+        L2->addSuccessor(S2);
+        S2->addSuccessor(L1);
+
+        PS.setRoot(X);
+        PTStoT PA(&PS);
+        PA.run();
+
+        check(L1->doesPointsTo(X), "L1 does not point to X");
+        check(L1->doesPointsTo(Y), "L1 does not point to Y");
+        check(C->doesPointsTo(X), "C does not point to X");
+        check(C->doesPointsTo(Y), "C does not point to Y");
+        check(L2->doesPointsTo(X), "L2 does not point to X");
+        check(L2->doesPointsTo(Y), "L2 does not point to Y");
+    }
+
+    // the pointers must get to all the nodes on a cycle of copies
+    void copy_cycle()
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS;
+        PSNode *X = PS.create<PSNodeType::ALLOC>();
+        PSNode *Y = PS.create<PSNodeType::ALLOC>();
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        A->setSize(8);
+        PSNode *P1 = PS.create<PSNodeType::PHI>(X);
+        PSNode *C1 = PS.create<PSNodeType::CAST>(P1);
+        PSNode *P2 = PS.create<PSNodeType::PHI>(C1);
+        PSNode *C2 = PS.create<PSNodeType::CAST>(P2);
+        PSNode *S = PS.create<PSNodeType::STORE>(C2, A);
+        PSNode *L = PS.create<PSNodeType::LOAD>(A);
+        P1->addOperand(C2);
+        P2->addOperand(L);
+        PSNode *C3 = PS.create<PSNodeType::CAST>(P2);
+        P2->addOperand(Y);
+
+        X->addSuccessor(Y);
+        Y->addSuccessor(A);
+        A->addSuccessor(P1);
+        P1->addSuccessor(C1);
+        C1->addSuccessor(P2);
+        P2->addSuccessor(C2);
+        C2->addSuccessor(S);
+        S->addSuccessor(L);
+        L->addSuccessor(C3);
+        L->addSuccessor(P1);
+
+        PS.setRoot(X);
+        PTStoT PA(&PS);
+        PA.run();
+
+        for (PSNode *n : {P1, C1, P2, C2, L, C3}) {
+            check(n->doesPointsTo(X), "a node does not point to X");
+            check(n->doesPointsTo(Y), "a node does not point to Y");
+            check(n->pointsTo.size() == 2, "a node points to more than X and Y");
+        }
+    }
+
     void test()
     {
         store_load();
@@ -935,6 +1027,8 @@ public:
         memcpy_test6();
         memcpy_test7();
         memcpy_test8();
+        loop_propagation();
+        copy_cycle();
     }
 };
 
@@ -954,6 +1048,706 @@ public:
     FlowSensitivePointsToTest()
         : PointsToTest<analysis::pta::PointerAnalysisFS>
           ("flow-sensitive points-to test") {}
+
+    void shared_memory()
+    {
+        using namespace analysis;
+
+        // the join node J shares the memory of A with its predecessors,
+        // the stores S3 and S4 must not change the memory seen by L1
+        PointerSubgraph PS;
+        PSNode *X = PS.create<PSNodeType::ALLOC>();
+        PSNode *Y = PS.create<PSNodeType::ALLOC>();
+        PSNode *Z = PS.create<PSNodeType::ALLOC>();
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *S1 = PS.create<PSNodeType::STORE>(X, A);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(Y, B);
+        PSNode *J = PS.create<PSNodeType::NOOP>();
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(A);
+        PSNode *S3 = PS.create<PSNodeType::STORE>(Z, A);
+        PSNode *S4 = PS.create<PSNodeType::STORE>(Z, B);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(A);
+        PSNode *L3 = PS.create<PSNodeType::LOAD>(B);
+
+        X->addSuccessor(Y);
+        Y->addSuccessor(Z);
+        Z->addSuccessor(A);
+        A->addSuccessor(B);
+        B->addSuccessor(S1);
+        B->addSuccessor(S2);
+        S1->addSuccessor(J);
+        S2->addSuccessor(J);
+        J->addSuccessor(L1);
+        L1->addSuccessor(S3);
+        S3->addSuccessor(S4);
+        S4->addSuccessor(L2);
+        L2->addSuccessor(L3);
+
+        PS.setRoot(X);
+        analysis::pta::PointerAnalysisFS PA(&PS);
+        PA.run();
+
+        check(L1->doesPointsTo(X), "L1 does not point to X");
+        check(L1->pointsTo.size() == 1, "L1 points to more than X");
+        check(L2->doesPointsTo(Z), "L2 does not point to Z");
+        check(L2->pointsTo.size() == 1, "L2 points to more than Z");
+        check(L3->doesPointsTo(Z), "L3 does not point to Z");
+        check(L3->pointsTo.size() == 1, "L3 points to more than Z");
+    }
+
+    void test()
+    {
+        PointsToTest<analysis::pta::PointerAnalysisFS>::test();
+        shared_memory();
+    }
+};
+
+class SparseFlowSensitivePointsToTest
+    : public PointsToTest<analysis::pta::PointerAnalysisSFS>
+{
+public:
+    SparseFlowSensitivePointsToTest()
+        : PointsToTest<analysis::pta::PointerAnalysisSFS>
+          ("sparse flow-sensitive points-to test") {}
+
+    void strong_update()
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS;
+        PSNode *X = PS.create<PSNodeType::ALLOC>();
+        PSNode *Y = PS.create<PSNodeType::ALLOC>();
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *S1 = PS.create<PSNodeType::STORE>(X, A);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(A);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(Y, A);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(A);
+
+        X->addSuccessor(Y);
+        Y->addSuccessor(A);
+        A->addSuccessor(S1);
+        S1->addSuccessor(L1);
+        L1->addSuccessor(S2);
+        S2->addSuccessor(L2);
+
+        PS.setRoot(X);
+        analysis::pta::PointerAnalysisSFS PA(&PS);
+        PA.run();
+
+        check(L1->doesPointsTo(X), "L1 does not point to X");
+        check(L1->pointsTo.size() == 1, "L1 points to more than X");
+        check(L2->doesPointsTo(Y), "L2 does not point to Y");
+        check(L2->pointsTo.size() == 1, "L2 points to more than Y");
+    }
+
+    void branches()
+    {
+        using namespace analysis;
+
+        // S1 and S2 are on different branches that join in L1,
+        // S3 is on one of the branches that join in L2
+        PointerSubgraph PS;
+        PSNode *X = PS.create<PSNodeType::ALLOC>();
+        PSNode *Y = PS.create<PSNodeType::ALLOC>();
+        PSNode *Z = PS.create<PSNodeType::ALLOC>();
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *S1 = PS.create<PSNodeType::STORE>(X, A);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(Y, A);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(A);
+        PSNode *S3 = PS.create<PSNodeType::STORE>(Z, A);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(A);
+
+        X->addSuccessor(Y);
+        Y->addSuccessor(Z);
+        Z->addSuccessor(A);
+        A->addSuccessor(S1);
+        A->addSuccessor(S2);
+        S1->addSuccessor(L1);
+        S2->addSuccessor(L1);
+        L1->addSuccessor(S3);
+        L1->addSuccessor(L2);
+        S3->addSuccessor(L2);
+
+        PS.setRoot(X);
+        analysis::pta::PointerAnalysisSFS PA(&PS);
+        PA.run();
+
+        check(L1->doesPointsTo(X), "L1 does not point to X");
+        check(L1->doesPointsTo(Y), "L1 does not point to Y");
+        check(L1->pointsTo.size() == 2, "L1 points to more than X and Y");
+        check(L2->doesPointsTo(X), "L2 does not point to X");
+        check(L2->doesPointsTo(Y), "L2 does not point to Y");
+        check(L2->doesPointsTo(Z), "L2 does not point to Z");
+        check(L2->pointsTo.size() == 3, "L2 points to more than X, Y and Z");
+    }
+
+    // the flow-insensitive stage collapses A, as it has two fields
+    // in the whole program, but there is only one field
+    // when loading from A + 8
+    void collapsed_in_fi_stage()
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS;
+        PSNode *X = PS.create<PSNodeType::ALLOC>();
+        PSNode *Y = PS.create<PSNodeType::ALLOC>();
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        A->setSize(16);
+        PSNode *G1 = PS.create<PSNodeType::GEP>(A, 8);
+        PSNode *S1 = PS.create<PSNodeType::STORE>(X, A);
+        PSNode *L = PS.create<PSNodeType::LOAD>(G1);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(Y, G1);
+
+        X->addSuccessor(Y);
+        Y->addSuccessor(A);
+        A->addSuccessor(G1);
+        G1->addSuccessor(S1);
+        S1->addSuccessor(L);
+        L->addSuccessor(S2);
+
+        PS.setRoot(X);
+        analysis::pta::PointerAnalysisSFS PA(&PS,
+                PointerAnalysisOptions().setObjectFieldsBudget(1));
+        PA.run();
+
+        check(L->pointsTo.empty(), "L reads X from the other field");
+    }
+
+    void test()
+    {
+        PointsToTest<analysis::pta::PointerAnalysisSFS>::test();
+        strong_update();
+        branches();
+        collapsed_in_fi_stage();
+    }
+};
+
+// run the analysis with the worklist solver
+template <typename PTType,
+          analysis::PointerAnalysisOptions::WorklistPolicy policy>
+class WorklistPTA : public PTType
+{
+public:
+    WorklistPTA(analysis::pta::PointerSubgraph *ps)
+        : PTType(ps, analysis::PointerAnalysisOptions()
+                     .setSolver(analysis::PointerAnalysisOptions::Solver::worklist)
+                     .setWorklistPolicy(policy)) {}
+};
+
+template <typename PTType,
+          analysis::PointerAnalysisOptions::WorklistPolicy policy>
+class WorklistPointsToTest
+    : public PointsToTest<WorklistPTA<PTType, policy>>
+{
+public:
+    WorklistPointsToTest(const char *name)
+        : PointsToTest<WorklistPTA<PTType, policy>>(name) {}
+};
+
+// run the analysis with collapsing of cycles
+template <typename PTType,
+          analysis::PointerAnalysisOptions::Solver solver>
+class CollapsingPTA : public PTType
+{
+public:
+    CollapsingPTA(analysis::pta::PointerSubgraph *ps)
+        : PTType(ps, analysis::PointerAnalysisOptions()
+                     .setSolver(solver)
+                     .setCollapseCycles(true)) {}
+};
+
+template <typename PTType,
+          analysis::PointerAnalysisOptions::Solver solver>
+class CollapsingPointsToTest
+    : public PointsToTest<CollapsingPTA<PTType, solver>>
+{
+public:
+    CollapsingPointsToTest(const char *name)
+        : PointsToTest<CollapsingPTA<PTType, solver>>(name) {}
+};
+
+// run the flow-insensitive analysis with the parallel solver
+class ParallelPTA : public analysis::pta::PointerAnalysisFI
+{
+public:
+    ParallelPTA(analysis::pta::PointerSubgraph *ps)
+        : PointerAnalysisFI(ps, analysis::PointerAnalysisOptions()
+                                .setThreads(4)) {}
+};
+
+class ParallelPointsToTest : public PointsToTest<ParallelPTA>
+{
+public:
+    ParallelPointsToTest()
+        : PointsToTest<ParallelPTA>("flow-insensitive points-to test (4 threads)") {}
+
+    // the rounds with a lot of nodes are computed by more threads
+    void many_nodes()
+    {
+        using namespace analysis;
+
+        const unsigned N = 500;
+        PointerSubgraph PS;
+        PSNode *X = PS.create<PSNodeType::ALLOC>();
+        PSNode *LX = PS.create<PSNodeType::LOAD>(X);
+        std::vector<PSNode *> allocs, loads, phis;
+        std::vector<PSNode *> nodes{X, LX};
+
+        for (unsigned i = 0; i < N; ++i) {
+            PSNode *A = PS.create<PSNodeType::ALLOC>();
+            PSNode *C = PS.create<PSNodeType::ALLOC>();
+            PSNode *S1 = PS.create<PSNodeType::STORE>(A, C);
+            PSNode *L = PS.create<PSNodeType::LOAD>(C);
+            PSNode *P = PS.create<PSNodeType::PHI>(L, LX);
+            PSNode *S2 = PS.create<PSNodeType::STORE>(P, X);
+
+            allocs.push_back(A);
+            loads.push_back(L);
+            phis.push_back(P);
+            nodes.insert(nodes.end(), {A, C, S1, L, P, S2});
+        }
+
+        for (size_t i = 1; i < nodes.size(); ++i)
+            nodes[i - 1]->addSuccessor(nodes[i]);
+
+        PS.setRoot(X);
+        ParallelPTA PA(&PS);
+        PA.run();
+
+        for (unsigned i = 0; i < N; ++i) {
+            check(loads[i]->pointsTo.size() == 1 &&
+                  loads[i]->doesPointsTo(allocs[i]), "L does not point to A");
+        }
+
+        check(LX->pointsTo.size() == N, "LX does not point to all A");
+        for (PSNode *A : allocs)
+            check(LX->doesPointsTo(A), "LX does not point to A");
+        for (PSNode *P : phis)
+            check(P->pointsTo.size() == N, "P does not point to all A");
+    }
+
+    void test()
+    {
+        PointsToTest<ParallelPTA>::test();
+        many_nodes();
+    }
+};
+
+class RelationalPointsToTest
+    : public PointsToTest<analysis::pta::PointerAnalysisFIBDD>
+{
+    unsigned seed{1};
+
+    unsigned random(unsigned n) {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) % n;
+    }
+
+    // build a random program with the seed 's' (the same seed
+    // gives the same program with the same IDs of nodes)
+    void random_program(PointerSubgraph& PS, unsigned s)
+    {
+        seed = s;
+        std::vector<PSNode *> nodes, values, phis;
+        for (unsigned i = 0; i < 8; ++i) {
+            PSNode *A = PS.create<PSNodeType::ALLOC>();
+            A->setSize(16);
+            nodes.push_back(A);
+            values.push_back(A);
+        }
+
+        const Offset::type offsets[] = {0, 4, 8, Offset::UNKNOWN};
+        for (unsigned i = 0; i < 60; ++i) {
+            PSNode *a = values[random(values.size())];
+            PSNode *b = values[random(values.size())];
+            PSNode *n = nullptr;
+            switch (random(5)) {
+                case 0:
+                    n = PS.create<PSNodeType::STORE>(a, b);
+                    break;
+                case 1:
+                    n = PS.create<PSNodeType::LOAD>(a);
+                    break;
+                case 2:
+                    n = PS.create<PSNodeType::PHI>(a, b);
+                    phis.push_back(n);
+                    break;
+                case 3:
+                    n = PS.create<PSNodeType::GEP>(a, offsets[random(4)]);
+                    break;
+                default:
+                    n = PS.create<PSNodeType::CAST>(a);
+            }
+
+            if (n->getType() != PSNodeType::STORE)
+                values.push_back(n);
+            nodes.push_back(n);
+        }
+
+        // make cycles of the data flow
+        for (PSNode *phi : phis)
+            phi->addOperand(values[random(values.size())]);
+
+        // the relations do not care about the order of the nodes,
+        // so put the program into a loop (the regular solver would
+        // not load what is stored after the load otherwise)
+        for (size_t i = 1; i < nodes.size(); ++i)
+            nodes[i - 1]->addSuccessor(nodes[i]);
+        nodes.back()->addSuccessor(nodes[0]);
+        PS.setRoot(nodes[0]);
+    }
+
+    // the relations give the same results as the regular solver
+    void compare_with_fi()
+    {
+        using namespace analysis;
+
+        // keep the offsets of the GEPs in the loop
+        auto options = PointerAnalysisOptions().setPreprocessGeps(false);
+        for (unsigned s = 1; s <= 20; ++s) {
+            PointerSubgraph PS1, PS2;
+            random_program(PS1, s);
+            random_program(PS2, s);
+
+            pta::PointerAnalysisFI FI(&PS1, options);
+            FI.run();
+            pta::PointerAnalysisFIBDD BDD(&PS2, options);
+            BDD.run();
+
+            for (size_t i = 1; i < PS1.size(); ++i) {
+                PSNode *n1 = PS1.getNodes()[i].get();
+                PSNode *n2 = PS2.getNodes()[i].get();
+                check(n1->pointsTo.size() == n2->pointsTo.size(),
+                      "The points-to sets differ");
+                for (const Pointer& ptr : n1->pointsTo) {
+                    PSNode *target = PS2.getNodes()[ptr.target->getID()].get();
+                    check(n2->doesPointsTo(target, ptr.offset),
+                          "The points-to sets differ");
+                }
+            }
+        }
+    }
+
+public:
+    RelationalPointsToTest()
+        : PointsToTest<analysis::pta::PointerAnalysisFIBDD>
+          ("flow-insensitive points-to test (BDD relations)") {}
+
+    void test()
+    {
+        PointsToTest<analysis::pta::PointerAnalysisFIBDD>::test();
+        compare_with_fi();
+    }
+};
+
+// answer queries for all the nodes instead of solving the whole graph
+class DemandPTA : public analysis::pta::PointerAnalysisDemand
+{
+public:
+    DemandPTA(analysis::pta::PointerSubgraph *ps,
+              const analysis::PointerAnalysisOptions& opts = {})
+        : PointerAnalysisDemand(ps, opts) {}
+
+    void run() {
+        // querying may add nodes to the graph
+        for (size_t i = 0; i < getPS()->size(); ++i) {
+            if (PSNode *nd = getPS()->getNodes()[i].get())
+                query(nd);
+        }
+    }
+};
+
+class DemandPointsToTest : public PointsToTest<DemandPTA>
+{
+public:
+    DemandPointsToTest()
+        : PointsToTest<DemandPTA>("demand-driven points-to test") {}
+
+    void only_needed()
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS;
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *C = PS.create<PSNodeType::ALLOC>();
+        PSNode *D = PS.create<PSNodeType::ALLOC>();
+        PSNode *S1 = PS.create<PSNodeType::STORE>(A, B);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(C, D);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(B);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(D);
+
+        A->addSuccessor(B);
+        B->addSuccessor(C);
+        C->addSuccessor(D);
+        D->addSuccessor(S1);
+        S1->addSuccessor(S2);
+        S2->addSuccessor(L1);
+        L1->addSuccessor(L2);
+
+        PS.setRoot(A);
+        PointerAnalysisDemand PA(&PS);
+        check(PA.query(L1), "The query failed");
+        check(L1->doesPointsTo(A), "L1 does not point to A");
+        check(L2->pointsTo.empty(), "L2 was computed, but not queried");
+
+        check(PA.query(L2), "The query failed");
+        check(L2->doesPointsTo(C), "L2 does not point to C");
+        check(L1->pointsTo.size() == 1, "L1 changed");
+    }
+
+    void store_through_pointer()
+    {
+        using namespace analysis;
+
+        // p = &a; *p = &b; x = a;
+        PointerSubgraph PS;
+        PSNode *P = PS.create<PSNodeType::ALLOC>();
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *S1 = PS.create<PSNodeType::STORE>(A, P);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(P);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(B, L1);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(A);
+
+        P->addSuccessor(A);
+        A->addSuccessor(B);
+        B->addSuccessor(S1);
+        S1->addSuccessor(L1);
+        L1->addSuccessor(S2);
+        S2->addSuccessor(L2);
+
+        PS.setRoot(P);
+        PointerAnalysisDemand PA(&PS);
+        check(PA.query(L2), "The query failed");
+        check(L2->doesPointsTo(B), "L2 does not point to B");
+        check(L2->pointsTo.size() == 1, "L2 points to more than B");
+    }
+
+    void budget()
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS;
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *S = PS.create<PSNodeType::STORE>(A, B);
+        PSNode *G = PS.create<PSNodeType::GEP>(B, 0);
+        PSNode *C = PS.create<PSNodeType::CAST>(G);
+        PSNode *L = PS.create<PSNodeType::LOAD>(C);
+
+        A->addSuccessor(B);
+        B->addSuccessor(S);
+        S->addSuccessor(G);
+        G->addSuccessor(C);
+        C->addSuccessor(L);
+
+        PS.setRoot(A);
+        PointerAnalysisDemand PA(&PS, PointerAnalysisOptions().setQueryBudget(2));
+        check(!PA.query(L), "The query did not run out of the budget");
+
+        // the next queries continue where the previous stopped
+        unsigned n = 0;
+        while (!PA.query(L) && n < 10)
+            ++n;
+
+        check(n < 10, "The queries did not finish");
+        check(L->doesPointsTo(A), "L does not point to A");
+        check(PA.query(L), "The finished query failed");
+    }
+
+    void funcptr_outside_budget()
+    {
+        using namespace analysis;
+
+        // fp = &f; fp(); and the query for &a
+        PointerSubgraph PS;
+        PSNode *FN = PS.create<PSNodeType::FUNCTION>();
+        PSNode *FP = PS.create<PSNodeType::ALLOC>();
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *S = PS.create<PSNodeType::STORE>(FN, FP);
+        PSNode *LF = PS.create<PSNodeType::LOAD>(FP);
+        PSNode *CALL = PS.create<PSNodeType::CALL_FUNCPTR>(LF);
+        PSNode *G = PS.create<PSNodeType::GEP>(A, 0);
+
+        FN->addSuccessor(FP);
+        FP->addSuccessor(A);
+        A->addSuccessor(S);
+        S->addSuccessor(LF);
+        LF->addSuccessor(CALL);
+        CALL->addSuccessor(G);
+
+        PS.setRoot(FN);
+        // the query itself needs only G and A
+        PointerAnalysisDemand PA(&PS, PointerAnalysisOptions().setQueryBudget(2));
+        check(PA.query(G), "The call via pointer counted against the budget");
+        check(G->doesPointsTo(A), "G does not point to A");
+        check(LF->doesPointsTo(FN), "The call via pointer was not resolved");
+    }
+
+    void address_not_taken()
+    {
+        using namespace analysis;
+
+        // b = &a; q = &c; *q = &a; x = b;
+        PointerSubgraph PS;
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *C = PS.create<PSNodeType::ALLOC>();
+        PSNode *Q = PS.create<PSNodeType::ALLOC>();
+        PSNode *S1 = PS.create<PSNodeType::STORE>(A, B);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(C, Q);
+        PSNode *LQ = PS.create<PSNodeType::LOAD>(Q);
+        PSNode *S3 = PS.create<PSNodeType::STORE>(A, LQ);
+        PSNode *L = PS.create<PSNodeType::LOAD>(B);
+
+        A->addSuccessor(B);
+        B->addSuccessor(C);
+        C->addSuccessor(Q);
+        Q->addSuccessor(S1);
+        S1->addSuccessor(S2);
+        S2->addSuccessor(LQ);
+        LQ->addSuccessor(S3);
+        S3->addSuccessor(L);
+
+        PS.setRoot(A);
+        PointerAnalysisDemand PA(&PS);
+        check(PA.query(L), "The query failed");
+        check(L->doesPointsTo(A), "L does not point to A");
+        // the address of b is not taken, so the store
+        // through q cannot write to b
+        check(LQ->pointsTo.empty(), "The address of the store through q was computed");
+    }
+
+    void test()
+    {
+        PointsToTest<DemandPTA>::test();
+        only_needed();
+        store_through_pointer();
+        budget();
+        funcptr_outside_budget();
+        address_not_taken();
+    }
+};
+
+class PointsToCacheTest : public Test
+{
+    static constexpr const char *path = "points-to-cache-test.pta";
+
+    // the same graph every time
+    static void build(PointerSubgraph& PS)
+    {
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *C = PS.create<PSNodeType::ALLOC>();
+        PSNode *N = PS.create<PSNodeType::CONSTANT>(NULLPTR, 0);
+        PSNode *G = PS.create<PSNodeType::GEP>(A, Offset::UNKNOWN);
+        PSNode *S1 = PS.create<PSNodeType::STORE>(G, B);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(N, C);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(B);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(C);
+        PSNode *P = PS.create<PSNodeType::PHI>(L1, L2);
+
+        A->addSuccessor(B);
+        B->addSuccessor(C);
+        C->addSuccessor(N);
+        N->addSuccessor(G);
+        G->addSuccessor(S1);
+        S1->addSuccessor(S2);
+        S2->addSuccessor(L1);
+        L1->addSuccessor(L2);
+        L2->addSuccessor(P);
+
+        PS.setRoot(A);
+    }
+
+public:
+    PointsToCacheTest()
+          : Test("points-to cache test") {}
+
+    void round_trip()
+    {
+        PointerSubgraph PS1;
+        build(PS1);
+        PointerAnalysisFI PA(&PS1);
+        PA.run();
+        PSNodeAlloc::get(PS1.getRoot())->setIsCollapsed();
+        check(PointsToCache::save(path, 42, PS1, {{3, 1}}), "Saving failed");
+
+        PointerSubgraph PS2;
+        build(PS2);
+        PointsToCache cache;
+        check(cache.open(path, 42), "Opening failed");
+        check(cache.getNodesNum() == PS2.size(), "Wrong number of nodes");
+        auto calls = cache.getCalls();
+        check(calls.size() == 1 && calls[0].first == 3 && calls[0].second == 1,
+              "Wrong calls");
+        // the stored call is not a call via a pointer of a function
+        check(!cache.matchesBeforeCalls(PS2), "Matched a wrong call");
+        check(cache.restore(PS2), "Restoring failed");
+        check(PSNodeAlloc::get(PS2.getRoot())->isCollapsed(),
+              "Collapsed flag not restored");
+        check(!PSNodeAlloc::get(PS2.getNodes()[2].get())->isCollapsed(),
+              "Wrong collapsed flag restored");
+
+        for (size_t i = 1; i < PS1.size(); ++i) {
+            PSNode *n1 = PS1.getNodes()[i].get();
+            PSNode *n2 = PS2.getNodes()[i].get();
+            check(n1->pointsTo.size() == n2->pointsTo.size(),
+                  "Restored points-to set has a different size");
+            for (const Pointer& ptr : n1->pointsTo) {
+                PSNode *target = ptr.target->getID() == 0 ? ptr.target :
+                                    PS2.getNodes()[ptr.target->getID()].get();
+                check(n2->doesPointsTo(target, ptr.offset),
+                      "Restored points-to set misses a pointer");
+            }
+        }
+
+        std::remove(path);
+    }
+
+    void mismatch()
+    {
+        PointerSubgraph PS1;
+        build(PS1);
+        PointerAnalysisFI PA(&PS1);
+        PA.run();
+        check(PointsToCache::save(path, 42, PS1, {}), "Saving failed");
+
+        PointsToCache cache;
+        check(!cache.open(path, 43), "Opened the cache with a wrong key");
+        check(!cache.open("nonexistent-points-to-cache.pta", 42),
+              "Opened nonexistent cache");
+
+        PointerSubgraph PS2;
+        build(PS2);
+        PSNode *L = PS2.create<PSNodeType::LOAD>(PS2.getRoot());
+        check(cache.open(path, 42), "Opening failed");
+        check(cache.matchesBeforeCalls(PS1), "The same graph does not match");
+        check(!cache.matchesBeforeCalls(PS2), "A bigger graph matches");
+        check(!cache.restore(PS2), "Restored the cache into a different graph");
+        check(L->pointsTo.empty(), "Restoring changed the graph");
+
+        // the inserted calls add nodes to the stored graph
+        PointerSubgraph PS3;
+        build(PS3);
+        PS3.create<PSNodeType::FUNCTION>();
+        check(PointsToCache::save(path, 42, PS3, {}), "Saving failed");
+        PointerSubgraph PS4;
+        build(PS4);
+        check(cache.open(path, 42), "Opening failed");
+        check(cache.matchesBeforeCalls(PS4), "A smaller graph does not match");
+        check(!cache.restore(PS4), "Restored the cache into a smaller graph");
+
+        std::remove(path);
+    }
+
+    void test()
+    {
+        round_trip();
+        mismatch();
+    }
 };
 
 class PSNodeTest : public Test
@@ -967,8 +1761,8 @@ public:
     {
         using namespace dg::analysis::pta;
         PointerSubgraph PS;
-        PSNode *N1 = PS.create(PSNodeType::ALLOC);
-        PSNode *N2 = PS.create(PSNodeType::LOAD, N1);
+        PSNode *N1 = PS.create<PSNodeType::ALLOC>();
+        PSNode *N2 = PS.create<PSNodeType::LOAD>(N1);
 
         N2->addPointsTo(N1, 1);
         N2->addPointsTo(N1, 2);
@@ -979,9 +1773,544 @@ public:
         check(N2->addPointsTo(N1, 3) == false);
     }
 
+    void copy_nodes1()
+    {
+        using namespace dg::analysis::pta;
+        PointerSubgraph PS;
+        PSNode *G = PS.create<PSNodeType::ALLOC>();
+        PSNode *E = PS.create<PSNodeType::ENTRY>();
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *S = PS.create<PSNodeType::STORE>(G, A);
+        PSNode *L = PS.create<PSNodeType::LOAD>(A);
+        PSNode *R = PS.create<PSNodeType::NOOP>();
+        G->addSuccessor(E);
+        E->addSuccessor(A);
+        A->addSuccessor(S);
+        S->addSuccessor(L);
+        L->addSuccessor(R);
+        R->addSuccessor(G);
+        A->setParent(E);
+        L->setParent(E);
+
+        PSNodeAlloc::get(A)->setIsHeap();
+
+        auto copies = PS.copyNodes({E, A, S, L, R});
+        check(copies.size() == 5, "Wrong number of copies");
+        PSNode *E2 = copies[0], *A2 = copies[1], *S2 = copies[2];
+        PSNode *L2 = copies[3], *R2 = copies[4];
+
+        check(E2->getType() == PSNodeType::ENTRY &&
+              A2->getType() == PSNodeType::ALLOC &&
+              S2->getType() == PSNodeType::STORE &&
+              L2->getType() == PSNodeType::LOAD &&
+              R2->getType() == PSNodeType::NOOP, "Wrong types of copies");
+        check(A2 != A && PSNodeAlloc::get(A2)->isHeap(), "Alloc not copied");
+        check(A2->pointsTo.size() == 1 && A2->doesPointsTo(A2),
+              "The copy of alloc is not a new object");
+
+        // the operands from the copied nodes are the copies,
+        // the other operands are kept
+        check(S2->getOperand(0) == G && S2->getOperand(1) == A2,
+              "Wrong operands of the copied store");
+        check(L2->getOperand(0) == A2, "Wrong operand of the copied load");
+        check(S->getOperand(1) == A && L->getOperand(0) == A,
+              "The original nodes changed");
+        check(A2->getParent() == E2 && L2->getParent() == E2,
+              "Wrong parents of the copies");
+
+        // the edges lead only between the copies
+        check(E2->predecessorsNum() == 0 && R2->successorsNum() == 0,
+              "Copied the edges out of the nodes");
+        check(E2->getSingleSuccessor() == A2 && A2->getSingleSuccessor() == S2 &&
+              S2->getSingleSuccessor() == L2 && L2->getSingleSuccessor() == R2,
+              "Wrong edges between the copies");
+        check(G->predecessorsNum() == 1 && E->predecessorsNum() == 1,
+              "The original edges changed");
+    }
+
     void test()
     {
         unknown_offset1();
+        copy_nodes1();
+    }
+};
+
+class PSOptimizationsTest : public Test
+{
+
+public:
+    PSOptimizationsTest()
+          : Test("PointerSubgraph optimizations test") {}
+
+    void value_numbering()
+    {
+        using namespace dg::analysis::pta;
+        PointerSubgraph PS;
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        A->setSize(16);
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *C1 = PS.create<PSNodeType::CAST>(A);
+        PSNode *C2 = PS.create<PSNodeType::CAST>(A);
+        PSNode *G1 = PS.create<PSNodeType::GEP>(C1, 4);
+        PSNode *G2 = PS.create<PSNodeType::GEP>(C2, 4);
+        PSNode *G3 = PS.create<PSNodeType::GEP>(C2, 8);
+        PSNode *S = PS.create<PSNodeType::STORE>(B, G2);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(G1);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(G2);
+        PSNode *P = PS.create<PSNodeType::PHI>(L1, L2);
+
+        A->addSuccessor(B);
+        B->addSuccessor(C1);
+        C1->addSuccessor(C2);
+        C2->addSuccessor(G1);
+        G1->addSuccessor(G2);
+        G2->addSuccessor(G3);
+        G3->addSuccessor(S);
+        S->addSuccessor(L1);
+        L1->addSuccessor(L2);
+        L2->addSuccessor(P);
+        PS.setRoot(A);
+
+        PSValueNumbering numbering(&PS, true /* merge loads */);
+        check(numbering.run() == 5, "wrong number of merged nodes");
+
+        const auto& mapping = numbering.getMapping();
+        check(mapping.get(C1) == A, "C1 not merged to A");
+        check(mapping.get(C2) == A, "C2 not merged to A");
+        check(mapping.get(G2) == G1, "G2 not merged to G1");
+        check(mapping.get(L2) == L1, "L2 not merged to L1");
+        check(mapping.get(P) == L1, "P not merged to L1");
+        check(mapping.get(G3) == nullptr, "G3 merged");
+
+        check(G1->getOperand(0) == A, "G1 does not use A");
+        check(S->getOperand(1) == G1, "S does not use G1");
+
+        PointerAnalysisFI PA(&PS);
+        PA.run();
+
+        check(L1->doesPointsTo(B), "L1 does not point to B");
+        check(G3->doesPointsTo(A, 8), "G3 does not point to A + 8");
+    }
+
+    // the PHIs are created before their operands, the allocation
+    // must stay the representative of the chain
+    void value_numbering_phi_chain()
+    {
+        using namespace dg::analysis::pta;
+        PointerSubgraph PS;
+        PSNode *P1 = PS.create<PSNodeType::PHI>();
+        PSNode *P2 = PS.create<PSNodeType::PHI>();
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *S = PS.create<PSNodeType::STORE>(B, P1);
+        PSNode *L = PS.create<PSNodeType::LOAD>(P1);
+        P1->addOperand(P2);
+        P2->addOperand(A);
+
+        A->addSuccessor(B);
+        B->addSuccessor(P2);
+        P2->addSuccessor(P1);
+        P1->addSuccessor(S);
+        S->addSuccessor(L);
+        PS.setRoot(A);
+
+        PSValueNumbering numbering(&PS);
+        check(numbering.run() == 2, "wrong number of merged nodes");
+
+        const auto& mapping = numbering.getMapping();
+        check(mapping.get(P1) == A, "P1 not merged to A");
+        check(mapping.get(P2) == A, "P2 not merged to A");
+        check(mapping.get(A) == nullptr, "A merged");
+        check(S->getOperand(1) == A && L->getOperand(0) == A,
+              "The users do not use A");
+
+        PointerAnalysisFI PA(&PS);
+        PA.run();
+
+        check(L->doesPointsTo(B), "L does not point to B");
+    }
+
+    void optimizer()
+    {
+        using namespace dg::analysis::pta;
+        PointerSubgraph PS;
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *S = PS.create<PSNodeType::STORE>(B, A);
+        PSNode *N = PS.create<PSNodeType::NOOP>();
+        PSNode *C1 = PS.create<PSNodeType::CAST>(A);
+        PSNode *C2 = PS.create<PSNodeType::CAST>(C1);
+        PSNode *P = PS.create<PSNodeType::PHI>(C2, C2);
+        PSNode *L = PS.create<PSNodeType::LOAD>(P);
+
+        A->addSuccessor(B);
+        B->addSuccessor(S);
+        S->addSuccessor(N);
+        N->addSuccessor(C1);
+        C1->addSuccessor(C2);
+        C2->addSuccessor(P);
+        P->addSuccessor(L);
+        PS.setRoot(A);
+
+        PointerSubgraphOptimizer optimizer(&PS);
+        check(optimizer.run() == 4, "wrong number of removed nodes");
+        check(optimizer.getNumOfRemovedNodes() == 4, "wrong number of removed nodes");
+
+        const auto& mapping = optimizer.getMapping();
+        check(mapping.get(C1) == A, "C1 not merged to A");
+        check(mapping.get(C2) == A, "C2 not merged to A");
+        check(mapping.get(P) == A, "P not merged to A");
+        check(L->getOperand(0) == A, "L does not use A");
+        check(S->getSuccessors().size() == 1 &&
+              S->getSuccessors()[0] == L, "S is not followed by L");
+
+        PointerAnalysisFI PA(&PS);
+        PA.run();
+
+        check(L->doesPointsTo(B), "L does not point to B");
+    }
+
+    void test()
+    {
+        value_numbering();
+        value_numbering_phi_chain();
+        optimizer();
+    }
+};
+
+// the components of a graph that grows (like the PointerSubgraph
+// grows when calls via pointers are inserted)
+class IncrementalSCCTest : public Test
+{
+    unsigned seed{1};
+
+    unsigned random(unsigned n) {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) % n;
+    }
+
+    // compare the components with the components computed from scratch
+    void compare(PointerSubgraph& PS, analysis::IncrementalSCC<PSNode>& inc)
+    {
+        const auto& comps = inc.getSCCs();
+        std::vector<unsigned> comp(PS.size(), ~0U);
+        size_t incNodes = 0;
+        for (unsigned i = 0; i < comps.size(); ++i) {
+            incNodes += comps[i].size();
+            for (PSNode *n : comps[i])
+                comp[n->getID()] = i;
+        }
+
+        // (Tarjan's algorithm overwrites scc_id of the nodes)
+        analysis::SCC<PSNode> tarjan;
+        const auto& scc = tarjan.compute(PS.getRoot());
+        size_t nodes = 0;
+        for (const auto& c : scc) {
+            nodes += c.size();
+            unsigned idx = comp[c[0]->getID()];
+            check(idx != ~0U, "A reachable node has no component");
+            if (idx == ~0U)
+                continue;
+
+            check(comps[idx].size() == c.size(), "The components differ");
+            for (PSNode *n : c)
+                check(comp[n->getID()] == idx, "The components differ");
+        }
+        check(nodes == incNodes, "The components have different nodes");
+
+        for (unsigned i = 0; i < comps.size(); ++i) {
+            for (PSNode *n : comps[i])
+                n->scc_id = i;
+        }
+
+        // the order is topological
+        for (const auto& c : comps) {
+            for (PSNode *n : c) {
+                for (PSNode *succ : n->getSuccessors()) {
+                    if (comp[succ->getID()] != comp[n->getID()])
+                        check(inc.getOrder(n) < inc.getOrder(succ),
+                              "An edge goes against the order");
+                }
+            }
+        }
+    }
+
+    void random_graph()
+    {
+        PointerSubgraph PS;
+        std::vector<PSNode *> reachable;
+        std::vector<PSNode *> all;
+
+        for (unsigned i = 0; i < 30; ++i) {
+            PSNode *n = PS.create<PSNodeType::NOOP>();
+            if (!reachable.empty())
+                reachable[random(reachable.size())]->addSuccessor(n);
+            reachable.push_back(n);
+            all.push_back(n);
+        }
+
+        for (unsigned i = 0; i < 30; ++i)
+            reachable[random(30)]->addSuccessor(reachable[random(30)]);
+
+        // the nodes that get reachable later
+        for (unsigned i = 0; i < 5; ++i) {
+            PSNode *n = PS.create<PSNodeType::NOOP>();
+            if (i > 0)
+                all.back()->addSuccessor(n);
+            all.push_back(n);
+        }
+
+        PS.setRoot(reachable[0]);
+        analysis::IncrementalSCC<PSNode> inc;
+        inc.compute(PS.getRoot());
+        compare(PS, inc);
+
+        for (unsigned round = 0; round < 50; ++round) {
+            std::vector<PSNode *> newNodes;
+            for (unsigned i = 0, e = 1 + random(3); i < e; ++i) {
+                PSNode *n = PS.create<PSNodeType::NOOP>();
+                reachable[random(reachable.size())]->addSuccessor(n);
+                newNodes.push_back(n);
+            }
+
+            for (PSNode *n : newNodes) {
+                for (unsigned i = 0, e = random(3); i < e; ++i)
+                    n->addSuccessor(all[random(all.size())]);
+                if (random(2) == 0)
+                    all[random(all.size())]->addSuccessor(n);
+            }
+
+            inc.update(newNodes);
+            all.insert(all.end(), newNodes.begin(), newNodes.end());
+            reachable.insert(reachable.end(), newNodes.begin(), newNodes.end());
+            compare(PS, inc);
+        }
+    }
+
+public:
+    IncrementalSCCTest() : Test("incremental SCC test") {}
+
+    void test()
+    {
+        for (unsigned i = 1; i <= 20; ++i) {
+            seed = i;
+            random_graph();
+        }
+    }
+};
+
+// the calls via pointers insert the called functions into the graph
+// while the analysis is running (like the LLVM analysis does)
+class FuncptrPTA : public PointerAnalysisFI
+{
+    struct Function {
+        PSNode *arg;
+        PSNode *mem;
+    };
+
+    std::map<PSNode *, Function> functions;
+
+public:
+    FuncptrPTA(PointerSubgraph *ps, const analysis::PointerAnalysisOptions& opts)
+        : PointerAnalysisFI(ps, opts) {}
+
+    // the function is called with the argument 'arg', it stores
+    // the argument (shifted by a GEP in a loop) to 'mem' and returns it
+    void addFunction(PSNode *fun, PSNode *arg, PSNode *mem) {
+        functions[fun] = {arg, mem};
+    }
+
+    bool functionPointerCall(PSNode *callsite, PSNode *called) override {
+        auto it = functions.find(called);
+        if (it == functions.end())
+            return false;
+
+        PointerSubgraph *PS = getPS();
+        PSNode *entry = PS->create<PSNodeType::ENTRY>();
+        PSNode *arg = PS->create<PSNodeType::PHI>(it->second.arg);
+        PSNode *gep = PS->create<PSNodeType::GEP>(arg, 4);
+        PSNode *store = PS->create<PSNodeType::STORE>(gep, it->second.mem);
+        PSNode *ret = PS->create<PSNodeType::RETURN>(arg);
+
+        callsite->addSuccessor(entry);
+        entry->addSuccessor(arg);
+        arg->addSuccessor(gep);
+        gep->addSuccessor(store);
+        store->addSuccessor(arg);
+        store->addSuccessor(ret);
+        ret->addSuccessor(callsite->getPairedNode());
+
+        callsite->getPairedNode()->addOperand(ret);
+        PS->operandsChanged(callsite->getPairedNode());
+        return true;
+    }
+};
+
+class FuncptrCallTest : public Test
+{
+    analysis::PointerAnalysisOptions options;
+
+    // the called function is loaded from memory in a loop
+    // and the loop changes it
+    void call_in_loop()
+    {
+        PointerSubgraph PS;
+        PSNode *FN1 = PS.create<PSNodeType::FUNCTION>();
+        PSNode *FN2 = PS.create<PSNodeType::FUNCTION>();
+        PSNode *X = PS.create<PSNodeType::ALLOC>();
+        PSNode *Y = PS.create<PSNodeType::ALLOC>();
+        PSNode *FP = PS.create<PSNodeType::ALLOC>();
+        PSNode *P = PS.create<PSNodeType::ALLOC>();
+        PSNode *S1 = PS.create<PSNodeType::STORE>(FN1, FP);
+        PSNode *LF = PS.create<PSNodeType::LOAD>(FP);
+        PSNode *CALL = PS.create<PSNodeType::CALL_FUNCPTR>(LF);
+        PSNode *RET = PS.create<PSNodeType::CALL_RETURN>();
+        PSNode *L = PS.create<PSNodeType::LOAD>(P);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(FN2, FP);
+
+        CALL->setPairedNode(RET);
+        RET->setPairedNode(CALL);
+
+        FN1->addSuccessor(FN2);
+        FN2->addSuccessor(X);
+        X->addSuccessor(Y);
+        Y->addSuccessor(FP);
+        FP->addSuccessor(P);
+        P->addSuccessor(S1);
+        S1->addSuccessor(LF);
+        LF->addSuccessor(CALL);
+        CALL->addSuccessor(RET);
+        RET->addSuccessor(L);
+        L->addSuccessor(S2);
+        S2->addSuccessor(LF);
+
+        PS.setRoot(FN1);
+        FuncptrPTA PA(&PS, options);
+        PA.addFunction(FN1, X, P);
+        PA.addFunction(FN2, Y, P);
+        PA.run();
+
+        check(CALL->pointsTo.size() == 2, "The call does not call both functions");
+        check(RET->pointsTo.size() == 2 && RET->doesPointsTo(X) &&
+              RET->doesPointsTo(Y), "RET does not point to X and Y");
+        // the GEPs are on a loop, so they have unknown offset
+        check(L->pointsTo.size() == 2 && L->doesPointsTo(X, Offset::UNKNOWN) &&
+              L->doesPointsTo(Y, Offset::UNKNOWN), "L does not point to X and Y");
+    }
+
+public:
+    FuncptrCallTest(const char *name,
+                    const analysis::PointerAnalysisOptions& opts)
+        : Test(name), options(opts) {}
+
+    void test()
+    {
+        call_in_loop();
+    }
+};
+
+template <typename PTType>
+class CollapseObjectsTest : public Test
+{
+    analysis::PointerAnalysisOptions options;
+
+    // store pointers to three fields of A and load from one of them
+    void fields_budget(size_t budget)
+    {
+        PointerSubgraph PS;
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *X = PS.create<PSNodeType::ALLOC>();
+        PSNode *Y = PS.create<PSNodeType::ALLOC>();
+        PSNode *Z = PS.create<PSNodeType::ALLOC>();
+        PSNode *G1 = PS.create<PSNodeType::GEP>(A, 8);
+        PSNode *G2 = PS.create<PSNodeType::GEP>(A, 16);
+        PSNode *S1 = PS.create<PSNodeType::STORE>(X, A);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(Y, G1);
+        PSNode *S3 = PS.create<PSNodeType::STORE>(Z, G2);
+        PSNode *G3 = PS.create<PSNodeType::GEP>(A, 8);
+        PSNode *L = PS.create<PSNodeType::LOAD>(G3);
+        A->setSize(32);
+
+        A->addSuccessor(X);
+        X->addSuccessor(Y);
+        Y->addSuccessor(Z);
+        Z->addSuccessor(G1);
+        G1->addSuccessor(G2);
+        G2->addSuccessor(S1);
+        S1->addSuccessor(S2);
+        S2->addSuccessor(S3);
+        S3->addSuccessor(G3);
+        G3->addSuccessor(L);
+
+        PS.setRoot(A);
+        PTType PA(&PS, analysis::PointerAnalysisOptions(options)
+                       .setObjectFieldsBudget(budget));
+        PA.run();
+
+        if (budget < 3) {
+            check(PSNodeAlloc::get(A)->isCollapsed(), "A is not collapsed");
+            check(PA.getStatistics().getCollapsedObjects() == 1,
+                  "Wrong number of collapsed objects");
+            check(L->doesPointsTo(X) && L->doesPointsTo(Y) &&
+                  L->doesPointsTo(Z), "L does not point to all fields");
+        } else {
+            check(!PSNodeAlloc::get(A)->isCollapsed(), "A is collapsed");
+            check(L->pointsTo.size() == 1 && L->doesPointsTo(Y),
+                  "L does not point only to Y");
+        }
+    }
+
+    // A is accessed via a GEP on a loop
+    void loop_gep()
+    {
+        PointerSubgraph PS;
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *X = PS.create<PSNodeType::ALLOC>();
+        PSNode *Y = PS.create<PSNodeType::ALLOC>();
+        PSNode *S1 = PS.create<PSNodeType::STORE>(Y, A);
+        PSNode *G = PS.create<PSNodeType::GEP>(A, 8);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(X, G);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(A);
+        PSNode *S3 = PS.create<PSNodeType::STORE>(Y, B);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(B);
+        A->setSize(32);
+        B->setSize(32);
+
+        A->addSuccessor(B);
+        B->addSuccessor(X);
+        X->addSuccessor(Y);
+        Y->addSuccessor(S1);
+        S1->addSuccessor(G);
+        G->addSuccessor(S2);
+        S2->addSuccessor(G);
+        S2->addSuccessor(L1);
+        L1->addSuccessor(S3);
+        S3->addSuccessor(L2);
+
+        PS.setRoot(A);
+        PTType PA(&PS, analysis::PointerAnalysisOptions(options)
+                       .setCollapseLoopObjects(true));
+        PA.run();
+
+        check(PSNodeAlloc::get(A)->isCollapsed(), "A is not collapsed");
+        check(!PSNodeAlloc::get(B)->isCollapsed(), "B is collapsed");
+        check(L1->doesPointsTo(X) && L1->doesPointsTo(Y),
+              "L1 does not point to X and Y");
+        check(L2->pointsTo.size() == 1 && L2->doesPointsTo(Y),
+              "L2 does not point only to Y");
+    }
+
+public:
+    CollapseObjectsTest(const char *name,
+                        const analysis::PointerAnalysisOptions& opts)
+        : Test(name), options(opts) {}
+
+    void test()
+    {
+        fields_budget(2);
+        fields_budget(3);
+        loop_gep();
     }
 };
 
@@ -995,7 +2324,47 @@ int main(void)
 
     Runner.add(new FlowInsensitivePointsToTest());
     Runner.add(new FlowSensitivePointsToTest());
+    Runner.add(new SparseFlowSensitivePointsToTest());
+
+    using Policy = dg::analysis::PointerAnalysisOptions::WorklistPolicy;
+    using dg::analysis::pta::PointerAnalysisFI;
+    using dg::analysis::pta::PointerAnalysisFS;
+    Runner.add(new WorklistPointsToTest<PointerAnalysisFI, Policy::fifo>(
+               "flow-insensitive points-to test (FIFO worklist)"));
+    Runner.add(new WorklistPointsToTest<PointerAnalysisFI, Policy::lifo>(
+               "flow-insensitive points-to test (LIFO worklist)"));
+    Runner.add(new WorklistPointsToTest<PointerAnalysisFS, Policy::fifo>(
+               "flow-sensitive points-to test (FIFO worklist)"));
+    Runner.add(new WorklistPointsToTest<PointerAnalysisFS, Policy::lifo>(
+               "flow-sensitive points-to test (LIFO worklist)"));
+    using Solver = dg::analysis::PointerAnalysisOptions::Solver;
+    Runner.add(new CollapsingPointsToTest<PointerAnalysisFI, Solver::batch>(
+               "flow-insensitive points-to test (collapsing cycles)"));
+    Runner.add(new CollapsingPointsToTest<PointerAnalysisFI, Solver::worklist>(
+               "flow-insensitive points-to test (collapsing cycles, worklist)"));
+    Runner.add(new ParallelPointsToTest());
+    Runner.add(new RelationalPointsToTest());
+    Runner.add(new DemandPointsToTest());
+    Runner.add(new PointsToCacheTest());
+    Runner.add(new FuncptrCallTest("calls via pointers test",
+               dg::analysis::PointerAnalysisOptions()));
+    Runner.add(new FuncptrCallTest("calls via pointers test (worklist)",
+               dg::analysis::PointerAnalysisOptions()
+               .setSolver(Solver::worklist)));
+    Runner.add(new FuncptrCallTest("calls via pointers test (4 threads)",
+               dg::analysis::PointerAnalysisOptions().setThreads(4)));
+    Runner.add(new CollapseObjectsTest<PointerAnalysisFI>(
+               "collapsing objects test (flow-insensitive)",
+               dg::analysis::PointerAnalysisOptions()));
+    Runner.add(new CollapseObjectsTest<PointerAnalysisFI>(
+               "collapsing objects test (flow-insensitive, 4 threads)",
+               dg::analysis::PointerAnalysisOptions().setThreads(4)));
+    Runner.add(new CollapseObjectsTest<PointerAnalysisFS>(
+               "collapsing objects test (flow-sensitive)",
+               dg::analysis::PointerAnalysisOptions()));
+    Runner.add(new IncrementalSCCTest());
     Runner.add(new PSNodeTest());
+    Runner.add(new PSOptimizationsTest());
 
     return Runner();
 }
@@ -14,13 +14,38 @@ std::uniform_int_distribution<uint64_t> distribution(0, ~static_cast<uint64_t>(0
     std::cout << "Running " << msg << "\n"; \
     dg::debug::TimeMeasure tm; \
     tm.start(); \
-    for (int i = 0; i < times; ++i) \
+    for (int i = 0; i < times; ++i) { \
         func<PointsToSet>(); \
+        releasePointsToSets(); \
+    } \
     tm.stop(); \
     tm.report(" -- PointsToSet bitvector took"); \
     tm.start(); \
-    for (int i = 0; i < times; ++i) \
+    for (int i = 0; i < times; ++i) { \
+        func<HybridPointsToSet>(); \
+        releasePointsToSets(); \
+    } \
+    tm.stop(); \
+    tm.report(" -- PointsToSet hybrid took"); \
+    tm.start(); \
+    for (int i = 0; i < times; ++i) { \
+        func<SharedPointsToSet>(); \
+        releasePointsToSets(); \
+    } \
+    tm.stop(); \
+    tm.report(" -- PointsToSet shared took"); \
+    tm.start(); \
+    for (int i = 0; i < times; ++i) { \
+        func<BDDPointsToSet>(); \
+        releasePointsToSets(); \
+    } \
+    tm.stop(); \
+    tm.report(" -- PointsToSet BDD took"); \
+    tm.start(); \
+    for (int i = 0; i < times; ++i) { \
         func<SimplePointsToSet>(); \
+        releasePointsToSets(); \
+    } \
     tm.stop(); \
     tm.report(" -- PointsToSet std::set took"); \
     } while(0);
@@ -82,10 +107,24 @@ void test5() {
 
     PTSetT S;
     for (int i = 0; i < 1000; ++i) {
-        S.add(reinterpret_cast<PSNode *>(i), i);
+        S.add(reinterpret_cast<PSNode *>(i + 1), i);
     }
 }
 
+template <typename PTSetT>
+void test6() {
+    PTSetT base;
+    for (int i = 0; i < 1000; ++i) {
+        base.add(reinterpret_cast<PSNode *>(i + 1), 0);
+    }
+
+    // many sets that have most of the pointers in common
+    std::vector<PTSetT> sets(100);
+    for (int i = 0; i < 100; ++i) {
+        sets[i].merge(base);
+        sets[i].add(reinterpret_cast<PSNode *>(2000 + i), 0);
+    }
+}
 
 int main()
 {
@@ -104,4 +143,16 @@ int main()
 
     times = 10000;
     run(test5, "Adding 1000 different pointers");
+
+    times = 100;
+    run(test6, "Merging 1000 pointers to 100 sets");
+
+    // the memory taken by one run of the last test
+    test6<BDDPointsToSet>();
+    test6<SharedPointsToSet>();
+    std::cout << " -- BDD nodes: " << BDDPointsToSet::nodesNum()
+              << ", BDD memory: " << BDDPointsToSet::memoryUsage() / 1024
+              << " kB\n";
+    std::cout << " -- shared sets: " << PointsToSetsTable::get().size() << "\n";
+    releasePointsToSets();
 }
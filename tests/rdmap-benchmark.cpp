@@ -5,13 +5,19 @@
 #include "dg/analysis/ReachingDefinitions/ReachingDefinitions.h"
 #include "../tools/TimeMeasure.h"
 
+using Duration = std::chrono::steady_clock::duration;
+
 // create two random rd maps of the
-// size 'size' and merge them
-void run(int size, int times = 100000)
+// size 'size' and merge them. Only the merging is measured,
+// the first merge adds new def-sites, the second merge is
+// the same as the merges of the fixpoint iterations
+// (nothing changes)
+void run(int size, int times, Duration& first, Duration& second)
 {
     using namespace dg::analysis::rd;
 
-    std::vector<RDNode> rdnodes(size, RDNode());
+    std::vector<RDNode> rdnodes(size);
+    dg::debug::TimeMeasure tm;
 
     while (--times > 0) {
         RDMap A, B;
@@ -34,22 +40,34 @@ void run(int size, int times = 100000)
         }
 
         // merge them
+        tm.start();
+        A.merge(&B);
+        tm.stop();
+        first += tm.duration();
+
+        tm.start();
         A.merge(&B);
+        tm.stop();
+        second += tm.duration();
     }
 
 }
 
-void test(int size)
+static void report(const std::string& msg, const Duration& d)
 {
-    dg::debug::TimeMeasure tm;
-    std::string msg = "[200000 iter] Sets of size max ";
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+    std::cerr << msg << ms / 1000 << " sec " << ms % 1000 << " ms" << std::endl;
+}
+
+void test(int size, int times = 200000)
+{
+    std::string msg = "[" + std::to_string(times) + " iter] Sets of size max ";
     msg += std::to_string(size);
-    msg += " -- ";
 
-    tm.start();
-    run(size, 200000);
-    tm.stop();
-    tm.report(msg.c_str());
+    Duration first{0}, second{0};
+    run(size, times, first, second);
+    report(msg + " -- merge: ", first);
+    report(msg + " -- merge again: ", second);
 }
 
 int main()
@@ -60,9 +78,9 @@ int main()
     test(10);
     test(15);
     test(20);
-    test(30);
-    test(50);
-    test(100);
-    test(200);
-    test(500);
+    test(30, 50000);
+    test(50, 20000);
+    test(100, 5000);
+    test(200, 1000);
+    test(500, 100);
 }
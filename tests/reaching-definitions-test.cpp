@@ -2,17 +2,25 @@
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
+#include <map>
+#include <set>
+#include <tuple>
+#include <vector>
 
 #include "test-runner.h"
 #include "test-dg.h"
 
 #include "dg/analysis/ReachingDefinitions/ReachingDefinitions.h"
 #include "dg/analysis/ReachingDefinitions/RDMap.h"
+#include "dg/analysis/ReachingDefinitions/SemisparseRda.h"
+#include "dg/BBlock.h"
 
 namespace dg {
 namespace tests {
 
 using namespace analysis::rd;
+using analysis::Offset;
+using analysis::ReachingDefinitionsAnalysisOptions;
 
 /*
 #ifdef DEBUG_ENABLED
@@ -237,12 +245,349 @@ public:
         //dumpMap(&S2);
     }
 
+    // a chain of nodes with a loop around it,
+    // the definition from the end of the loop must get to the loop head
+    void loop()
+    {
+        const unsigned N = 50;
+        RDNode AL;
+        std::vector<RDNode> nodes(N);
+
+        AL.addSuccessor(&nodes[0]);
+        for (unsigned i = 0; i + 1 < N; ++i)
+            nodes[i].addSuccessor(&nodes[i + 1]);
+        nodes[N - 1].addSuccessor(&nodes[0]);
+
+        nodes[0].addDef(&AL, 0, 4, true /* strong update */);
+        nodes[N - 1].addDef(&AL, 4, 4, true /* strong update */);
+
+        ReachingDefinitionsAnalysis RD(&AL);
+        RD.run();
+
+        std::set<RDNode *> rd;
+        nodes[0].getReachingDefinitions(&AL, 4, 1, rd);
+        check(rd.size() == 1, "Should have had one r.d.");
+        check(*(rd.begin()) == &nodes[N - 1], "Should be the end of the loop");
+
+        rd.clear();
+        nodes[N / 2].getReachingDefinitions(&AL, 0, 8, rd);
+        check(rd.size() == 2, "Should have had two r.d.");
+
+        // the root and the loop are two blocks. The summary of the loop
+        // already has the definitions from the end of the loop
+        // and these overwrite everything that comes to the loop head
+        const auto& st = RD.getStatistics();
+        check(st.getBlocksNum() == 2, "Wrong number of blocks");
+        check(st.getIterationsNum() == 1, "Wrong number of iterations");
+        check(st.getProcessedBlocks() == 2, "Processed too many blocks");
+    }
+
+    // A random program: the nodes are split into consecutive blocks
+    // with some random jumps between them. The nodes define random parts
+    // of the allocations (strongly or weakly), define unknown memory
+    // or use the allocations. The edges are both between the nodes
+    // (for the dense analysis) and between the blocks (for the sparse one,
+    // the allocations are at the beginning of the first block).
+    // The blocks are in one vector, so that the successors (ordered
+    // by addresses) are in the same order in two graphs from one seed.
+    struct RandomGraph {
+        std::vector<RDNode> allocs;
+        std::vector<RDNode> nodes;
+        std::vector<BBlock<RDNode>> blocks;
+
+        RandomGraph(unsigned seed) : allocs(4), nodes(40), blocks(8) {
+            srand(seed);
+            const unsigned blockSize = nodes.size() / blocks.size();
+            for (RDNode& a : allocs)
+                blocks[0].append(&a);
+            for (unsigned i = 0; i < nodes.size(); ++i) {
+                blocks[i / blockSize].append(&nodes[i]);
+                if (i % blockSize != 0)
+                    nodes[i - 1].addSuccessor(&nodes[i]);
+            }
+
+            auto jump = [&](unsigned from, unsigned to) {
+                blocks[from].addSuccessor(&blocks[to]);
+                nodes[(from + 1) * blockSize - 1].addSuccessor(&nodes[to * blockSize]);
+            };
+            for (unsigned i = 0; i + 1 < blocks.size(); ++i) {
+                jump(i, i + 1);
+                // some branches and loops
+                if (rand() % 3 == 0)
+                    jump(i, rand() % blocks.size());
+            }
+
+            for (RDNode& n : nodes) {
+                RDNode *target = &allocs[rand() % allocs.size()];
+                Offset off = (rand() % 3) * 4;
+                switch (rand() % 4) {
+                    case 0: n.addDef(target, off, 4, true /* strong update */); break;
+                    case 1: n.addDef(target, off, 4); break;
+                    case 2: n.addDef(UNKNOWN_MEMORY, off, 4); break;
+                    default: n.addUse(target, off, 4);
+                }
+            }
+        }
+
+        // the position of the node in the graph (to compare two graphs)
+        int index(RDNode *n) const {
+            if (n == UNKNOWN_MEMORY)
+                return -1;
+            if (n >= &allocs[0] && n <= &allocs.back())
+                return static_cast<int>(n - &allocs[0]);
+            return static_cast<int>(n - &nodes[0]) + 100;
+        }
+
+        // the definitions that reach the node 'i' as positions
+        std::set<std::tuple<int, uint64_t, uint64_t, int>> reaching(unsigned i) {
+            std::set<std::tuple<int, uint64_t, uint64_t, int>> ret;
+            for (const auto& it : nodes[i].getReachingDefinitions())
+                for (RDNode *n : it.second)
+                    ret.emplace(index(it.first.target), *it.first.offset,
+                                *it.first.len, index(n));
+            return ret;
+        }
+    };
+
+    // build the same random graph twice, solve one with the analysis
+    // (blocks) and the other one node by node and compare the results
+    void blocks_random()
+    {
+        for (unsigned seed = 1; seed <= 30; ++seed) {
+            RandomGraph G1(seed), G2(seed);
+
+            ReachingDefinitionsAnalysis RD(&G1.nodes[0]);
+            RD.run();
+
+            // node by node
+            ReachingDefinitionsAnalysis RD2(&G2.nodes[0]);
+            bool changed;
+            do {
+                changed = false;
+                for (RDNode& n : G2.nodes)
+                    changed |= RD2.processNode(&n);
+            } while (changed);
+
+            for (unsigned i = 0; i < G1.nodes.size(); ++i) {
+                // unreachable nodes are not processed by the analysis
+                if (i > 0 && G2.nodes[i].getPredecessors().empty())
+                    continue;
+
+                for (unsigned a = 0; a < G1.allocs.size(); ++a) {
+                    std::set<RDNode *> rd1, rd2;
+                    G1.nodes[i].getReachingDefinitions(&G1.allocs[a],
+                                                       Offset::UNKNOWN,
+                                                       Offset::UNKNOWN, rd1);
+                    G2.nodes[i].getReachingDefinitions(&G2.allocs[a],
+                                                       Offset::UNKNOWN,
+                                                       Offset::UNKNOWN, rd2);
+
+                    // compare the positions of the nodes
+                    std::set<size_t> p1, p2;
+                    for (RDNode *n : rd1)
+                        p1.insert(n - G1.nodes.data());
+                    for (RDNode *n : rd2)
+                        p2.insert(n - G2.nodes.data());
+                    check(p1 == p2, "Blocks and nodes give different results");
+                }
+            }
+
+            check(RD.getStatistics().getBlocksNum() < G1.nodes.size(),
+                  "No blocks with more nodes");
+        }
+    }
+
+    // a loop over blocks, the uses get the definitions
+    // through the PHI nodes of the sparse graph
+    void semisparse_loop()
+    {
+        RDNode AL, S1, L1, S2, L2;
+        BBlock<RDNode> B0(&AL), B1(&L1), B2(&L2);
+        B0.append(&S1);
+        B1.append(&S2);
+        B0.addSuccessor(&B1);
+        B1.addSuccessor(&B1);
+        B1.addSuccessor(&B2);
+
+        S1.addDef(&AL, 0, 4, true /* strong update */);
+        S2.addDef(&AL, 0, 4, true /* strong update */);
+        L1.addUse(&AL, 0, 4);
+        L2.addUse(&AL, 0, 4);
+
+        SemisparseRda RD(&AL);
+        RD.run();
+
+        std::set<RDNode *> rd;
+        L1.getReachingDefinitions(&AL, 0, 4, rd);
+        check(rd == std::set<RDNode *>({&S1, &S2}), "Wrong r.d. in the loop");
+
+        rd.clear();
+        L2.getReachingDefinitions(&AL, 0, 4, rd);
+        check(rd == std::set<RDNode *>({&S2}), "Wrong r.d. after the loop");
+    }
+
+    // a loop of two blocks with a branch inside: the PHI nodes
+    // of the header and of the join block depend on each other
+    // (one component of the sparse graph with W) and all the uses
+    // share them. W uses the memory and defines it weakly (like realloc)
+    void semisparse_phi_cycle()
+    {
+        RDNode AL, S1, L1, S2, L3, W, L4, L5;
+        BBlock<RDNode> B0(&AL), B1(&L1), B2(&S2), B3(&L3), B4(&L4), B5(&L5);
+        B0.append(&S1);
+        B3.append(&W);
+        B0.addSuccessor(&B1);
+        B1.addSuccessor(&B2);
+        B1.addSuccessor(&B3);
+        B2.addSuccessor(&B4);
+        B3.addSuccessor(&B4);
+        B4.addSuccessor(&B1);
+        B4.addSuccessor(&B5);
+
+        S1.addDef(&AL, 0, 4, true /* strong update */);
+        S2.addDef(&AL, 0, 4, true /* strong update */);
+        W.addDef(&AL, 0, 4);
+        for (RDNode *L : {&L1, &L3, &W, &L4, &L5})
+            L->addUse(&AL, 0, 4);
+
+        SemisparseRda RD(&AL);
+        RD.run();
+
+        // the uses get only the definitions, not the PHI nodes,
+        // themselves or the other uses
+        for (RDNode *L : {&L1, &L3, &L4, &L5}) {
+            std::set<RDNode *> rd;
+            L->getReachingDefinitions(&AL, 0, 4, rd);
+            check(rd == std::set<RDNode *>({&S1, &S2, &W}), "Wrong r.d. in the loop");
+        }
+
+        // the map of W has its own definition from the beginning
+        // (the definitions after the node), the loop adds only the stores
+        std::set<RDNode *> rd;
+        W.getReachingDefinitions(&AL, 0, 4, rd);
+        check(rd == std::set<RDNode *>({&S1, &S2, &W}), "Wrong r.d. of the weak update");
+    }
+
+    // build the same random graph twice, build the sparse graph
+    // of one with more threads and compare the results
+    void semisparse_threads()
+    {
+        for (unsigned seed = 0; seed < 20; ++seed) {
+            RandomGraph G1(seed), G2(seed);
+
+            SemisparseRda RD1(&G1.allocs[0]);
+            RD1.run();
+            SemisparseRda RD2(&G2.allocs[0],
+                              ReachingDefinitionsAnalysisOptions().setThreads(3));
+            RD2.run();
+
+            check(RD1.getStatistics().getGroupsNum() == 0, "One thread built groups");
+            check(RD2.getStatistics().getGroupsNum() > 1, "Graph not built in parallel");
+            for (unsigned i = 0; i < G1.nodes.size(); ++i)
+                check(G1.reaching(i) == G2.reaching(i), "Threads changed the r.d.");
+        }
+
+        // a use of unknown memory may read any variable,
+        // so the graph must be built by one thread
+        for (unsigned seed = 0; seed < 5; ++seed) {
+            RandomGraph G1(seed), G2(seed);
+            G1.nodes[22].addUse(UNKNOWN_MEMORY);
+            G2.nodes[22].addUse(UNKNOWN_MEMORY);
+
+            SemisparseRda RD1(&G1.allocs[0]);
+            RD1.run();
+            SemisparseRda RD2(&G2.allocs[0],
+                              ReachingDefinitionsAnalysisOptions().setThreads(3));
+            RD2.run();
+
+            check(RD2.getStatistics().getGroupsNum() == 0,
+                  "Graph built in parallel with a use of unknown memory");
+            for (unsigned i = 0; i < G1.nodes.size(); ++i)
+                check(G1.reaching(i) == G2.reaching(i), "Threads changed the r.d.");
+        }
+    }
+
+    // merge random maps and compare the result
+    // with merging std::map of std::sets
+    void rdmap_merge()
+    {
+        using RefMapT = std::map<DefSite, std::set<RDNode *>>;
+        std::vector<RDNode> nodes(20);
+
+        srand(1);
+        for (int round = 0; round < 100; ++round) {
+            RDMap A, B;
+            RefMapT refA, refB;
+            for (int i = 0; i < 30; ++i) {
+                DefSite ds(&nodes[rand() % 5], (rand() % 4) * 4, 4);
+                RDNode *n = &nodes[rand() % nodes.size()];
+                if (i % 2) {
+                    A.add(ds, n);
+                    refA[ds].insert(n);
+                } else {
+                    B.add(ds, n);
+                    refB[ds].insert(n);
+                }
+            }
+
+            bool changed = A.merge(&B);
+            bool refChanged = false;
+            for (auto& it : refB) {
+                for (RDNode *n : it.second)
+                    refChanged |= refA[it.first].insert(n).second;
+            }
+
+            check(changed == refChanged, "Merge reported wrong change");
+            check(!A.merge(&B), "Second merge changed the map");
+            check(A.size() == refA.size(), "Wrong number of def-sites");
+
+            auto ref = refA.begin();
+            for (const auto& it : A) {
+                check(it.first == ref->first, "Wrong def-site");
+                std::set<RDNode *> vals(it.second.begin(), it.second.end());
+                check(vals == ref->second, "Wrong definitions");
+                ++ref;
+            }
+        }
+    }
+
+    void rdmap_strong_update()
+    {
+        RDNode AL1, S1, S2, S3;
+        RDMap A, B;
+
+        B.add(DefSite(&AL1, 0, 4), &S1);
+        B.add(DefSite(&AL1, 8, 4), &S2);
+        A.add(DefSite(&AL1, 4, 4), &S3);
+
+        DefSiteSetT overwrites{DefSite(&AL1, 0, 4)};
+        check(A.merge(&B, &overwrites), "Merge did not change the map");
+        check(A.size() == 2, "Strong update not applied");
+        check(!A.defines(DefSite(&AL1, 0, 4)), "Strong update not applied");
+        check(A.defines(DefSite(&AL1, 4, 4)), "Lost def-site");
+        check(A.defines(DefSite(&AL1, 8, 4)), "Lost def-site");
+
+        // crop to unknown when the set is too big
+        RDMap C;
+        C.add(DefSite(&AL1, 4, 4), &S1);
+        C.add(DefSite(&AL1, 4, 4), &S2);
+        A.merge(&C, nullptr, true, 2 /* max set size */);
+        check(A[DefSite(&AL1, 4, 4)].isUnknown(), "Set not cropped");
+    }
+
     void test()
     {
         basic1();
         basic2();
         basic3();
         basic4();
+        loop();
+        blocks_random();
+        semisparse_loop();
+        semisparse_phi_cycle();
+        semisparse_threads();
+        rdmap_merge();
+        rdmap_strong_update();
     }
 };
 
@@ -0,0 +1,22 @@
+#!/bin/bash
+
+TESTS_DIR=`dirname $0`
+source "$TESTS_DIR/test-runner.sh"
+
+has_irrelevant_call()
+{
+	llvm-dis "$TESTS_DIR/sources/clone-alloc-wrapper1.sliced" -o - \
+		| grep -q 'call .*@irrelevant'
+}
+
+# both calls of the wrapper return the same memory object,
+# so the store via 'q' may define '*p'
+run_test "sources/clone-alloc-wrapper1.c"
+has_irrelevant_call || errmsg "The store via 'q' was sliced away without cloning"
+
+# every call of the wrapper gets its own copy of the allocation
+DG_TESTS_SLICER_OPTS=-pta-clone-alloc-wrappers
+run_test "sources/clone-alloc-wrapper1.c"
+has_irrelevant_call && errmsg "The store via 'q' is in the slice with cloning"
+
+exit 0
@@ -0,0 +1,23 @@
+#include <stdlib.h>
+
+int *alloc(void)
+{
+	return malloc(sizeof(int));
+}
+
+int irrelevant(void)
+{
+	return 2;
+}
+
+int main(void)
+{
+	int *p = alloc();
+	int *q = alloc();
+
+	*p = 1;
+	*q = irrelevant();
+
+	test_assert(*p == 1);
+	return 0;
+}
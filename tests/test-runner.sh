@@ -103,16 +103,20 @@ run_test()
 	# compile in.c out.bc
 	compile "$CODE" "$BCFILE"
 
-	# slice the code
+	# slice the code (do not change the environment,
+	# a test may call run_test more times)
+	local PTA_OPT=""
+	local RDA_OPT=""
 	if [ ! -z "$DG_TESTS_PTA" ]; then
-		export DG_TESTS_PTA="-pta $DG_TESTS_PTA"
+		PTA_OPT="-pta $DG_TESTS_PTA"
 	fi
 
 	if [ ! -z "$DG_TESTS_RDA" ]; then
-		export DG_TESTS_RDA="-rda $DG_TESTS_RDA"
+		RDA_OPT="-rda $DG_TESTS_RDA"
 	fi
 
-	llvm-slicer $DG_TESTS_RDA $DG_TESTS_PTA -c test_assert "$BCFILE"
+	llvm-slicer $RDA_OPT $PTA_OPT $DG_TESTS_SLICER_OPTS \
+		-c test_assert "$BCFILE"
 
 	# link assert to the code
 	link_with_assert "$SLICEDFILE" "$LINKEDFILE"
@@ -69,6 +69,7 @@ int main(int argc, char *argv[])
     const char *pts = "fi";
     const char *rda = "dense";
     const char *entry_func = "main";
+    const char *pta_cache = "";
     CD_ALG cd_alg = CD_ALG::CLASSIC;
 
     using namespace debug;
@@ -82,6 +83,8 @@ int main(int argc, char *argv[])
             opts &= ~PRINT_USE;
         } else if (strcmp(argv[i], "-pta") == 0) {
             pts = argv[++i];
+        } else if (strcmp(argv[i], "-pta-cache") == 0) {
+            pta_cache = argv[++i];
         } else if (strcmp(argv[i], "-rda") == 0) {
             rda = argv[++i];
         } else if (strcmp(argv[i], "-no-data") == 0) {
@@ -144,6 +147,7 @@ int main(int argc, char *argv[])
     llvmdg::LLVMDependenceGraphOptions options;
 
     options.PTAOptions.entryFunction = entry_func;
+    options.PTAOptions.cacheDirectory = pta_cache;
     options.RDAOptions.entryFunction = entry_func;
     if (strcmp(pts, "fs") == 0) {
         options.PTAOptions.analysisType
@@ -154,8 +158,14 @@ int main(int argc, char *argv[])
     } else if (strcmp(pts, "inv") == 0) {
         options.PTAOptions.analysisType
             = LLVMPointerAnalysisOptions::AnalysisType::inv;
+    } else if (strcmp(pts, "sfs") == 0) {
+        options.PTAOptions.analysisType
+            = LLVMPointerAnalysisOptions::AnalysisType::sfs;
+    } else if (strcmp(pts, "demand") == 0) {
+        options.PTAOptions.analysisType
+            = LLVMPointerAnalysisOptions::AnalysisType::demand;
     } else {
-        llvm::errs() << "Unknown points to analysis, try: fs, fi, inv\n";
+        llvm::errs() << "Unknown points to analysis, try: fs, fi, inv, sfs, demand\n";
         abort();
     }
 
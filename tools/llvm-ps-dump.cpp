@@ -41,8 +41,10 @@
 
 #include "dg/llvm/analysis/PointsTo/PointerAnalysis.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFI.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFIBDD.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFS.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFSInv.h"
+#include "dg/analysis/PointsTo/PointerAnalysisSFS.h"
 #include "dg/analysis/PointsTo/Pointer.h"
 
 #include "TimeMeasure.h"
@@ -68,6 +70,7 @@ enum PTType {
     FLOW_SENSITIVE = 1,
     FLOW_INSENSITIVE,
     WITH_INVALIDATE,
+    SPARSE_FLOW_SENSITIVE,
 };
 
 static std::string
@@ -295,6 +298,8 @@ dumpPSNode(PSNode *n, PTType type)
         (alloc->getSize() || alloc->isHeap() || alloc->isZeroInitialized()))
         printf(" [size: %lu, heap: %u, zeroed: %u]",
                alloc->getSize(), alloc->isHeap(), alloc->isZeroInitialized());
+    if (alloc && alloc->isCollapsed())
+        printf(" [collapsed]");
 
     printf(" (points-to size: %lu)\n", n->pointsTo.size());
 
@@ -324,6 +329,8 @@ dumpNodeToDot(PSNode *node, PTType type)
     if (alloc && (alloc->getSize() || alloc->isHeap() || alloc->isZeroInitialized()))
         printf("\\n[size: %lu, heap: %u, zeroed: %u]",
            alloc->getSize(), alloc->isHeap(), alloc->isZeroInitialized());
+    if (alloc && alloc->isCollapsed())
+        printf("\\n[collapsed]");
 
     if (verbose && node->getOperandsNum() > 0) {
         printf("\\n--- operands ---\\n");
@@ -382,7 +389,7 @@ dumpNodeEdgesToDot(PSNode *node)
 }
 
 PSNode *getNodePtr(PSNode *ptr) { return ptr; }
-PSNode *getNodePtr(const std::unique_ptr<PSNode>& ptr) { return ptr.get(); }
+PSNode *getNodePtr(const PointerSubgraph::NodePtr& ptr) { return ptr.get(); }
 
 
 template <typename ContT> static void
@@ -477,7 +484,18 @@ int main(int argc, char *argv[])
     bool todot = false;
     const char *module = nullptr;
     PTType type = FLOW_INSENSITIVE;
+    bool bdd_relations = false;
     uint64_t field_senitivity = Offset::UNKNOWN;
+    bool worklist = false;
+    bool worklist_lifo = false;
+    bool collapse_cycles = false;
+    unsigned threads = 1;
+    unsigned clone_depth = 0;
+    uint64_t object_fields_budget = 0;
+    bool collapse_loop_objects = false;
+    bool clone_alloc_wrappers = false;
+    bool optimize = false;
+    bool stats = false;
 
     // parse options
     for (int i = 1; i < argc; ++i) {
@@ -487,8 +505,33 @@ int main(int argc, char *argv[])
                 type = FLOW_SENSITIVE;
             else if (strcmp(argv[i+1], "inv") == 0)
                 type = WITH_INVALIDATE;
+            else if (strcmp(argv[i+1], "sfs") == 0)
+                type = SPARSE_FLOW_SENSITIVE;
+            else if (strcmp(argv[i+1], "fi-bdd") == 0)
+                bdd_relations = true;
         } else if (strcmp(argv[i], "-pta-field-sensitive") == 0) {
             field_senitivity = static_cast<uint64_t>(atoll(argv[i + 1]));
+        } else if (strcmp(argv[i], "-pta-solver") == 0) {
+            if (strcmp(argv[i+1], "worklist") == 0)
+                worklist = true;
+            else if (strcmp(argv[i+1], "worklist-lifo") == 0)
+                worklist = worklist_lifo = true;
+        } else if (strcmp(argv[i], "-pta-collapse-cycles") == 0) {
+            collapse_cycles = true;
+        } else if (strcmp(argv[i], "-pta-threads") == 0) {
+            threads = static_cast<unsigned>(atoi(argv[i + 1]));
+        } else if (strcmp(argv[i], "-pta-object-fields-budget") == 0) {
+            object_fields_budget = static_cast<uint64_t>(atoll(argv[i + 1]));
+        } else if (strcmp(argv[i], "-pta-collapse-loop-objects") == 0) {
+            collapse_loop_objects = true;
+        } else if (strcmp(argv[i], "-pta-clone-depth") == 0) {
+            clone_depth = static_cast<unsigned>(atoi(argv[i + 1]));
+        } else if (strcmp(argv[i], "-pta-clone-alloc-wrappers") == 0) {
+            clone_alloc_wrappers = true;
+        } else if (strcmp(argv[i], "-pta-optimize") == 0) {
+            optimize = true;
+        } else if (strcmp(argv[i], "-stats") == 0) {
+            stats = true;
         } else if (strcmp(argv[i], "-dot") == 0) {
             todot = true;
         } else if (strcmp(argv[i], "-ids-only") == 0) {
@@ -540,13 +583,32 @@ int main(int argc, char *argv[])
         }
     }
 
-    LLVMPointerAnalysis PTA(M, entry_func, field_senitivity);
+    LLVMPointerAnalysisOptions opts;
+    opts.setFieldSensitivity(field_senitivity);
+    opts.setEntryFunction(entry_func);
+    if (worklist)
+        opts.setSolver(LLVMPointerAnalysisOptions::Solver::worklist);
+    if (worklist_lifo)
+        opts.setWorklistPolicy(LLVMPointerAnalysisOptions::WorklistPolicy::lifo);
+    opts.setCollapseCycles(collapse_cycles);
+    opts.setThreads(threads);
+    opts.objectFieldsBudget = object_fields_budget;
+    opts.collapseLoopObjects = collapse_loop_objects;
+    opts.cloneDepth = clone_depth;
+    opts.cloneAllocWrappers = clone_alloc_wrappers;
+    opts.optimizeSubgraph = optimize;
+
+    LLVMPointerAnalysis PTA(M, opts);
 
     tm.start();
 
     // use createAnalysis instead of the run() method so that we won't delete
     // the analysis data (like memory objects) which may be needed
-    if (type == FLOW_INSENSITIVE) {
+    if (type == FLOW_INSENSITIVE && bdd_relations) {
+        PA = std::unique_ptr<PointerAnalysis>(
+            PTA.createPTA<analysis::pta::PointerAnalysisFIBDD>()
+            );
+    } else if (type == FLOW_INSENSITIVE) {
         PA = std::unique_ptr<PointerAnalysis>(
             PTA.createPTA<analysis::pta::PointerAnalysisFI>()
             );
@@ -554,6 +616,10 @@ int main(int argc, char *argv[])
         PA = std::unique_ptr<PointerAnalysis>(
             PTA.createPTA<analysis::pta::PointerAnalysisFSInv>()
             );
+    } else if (type == SPARSE_FLOW_SENSITIVE) {
+        PA = std::unique_ptr<PointerAnalysis>(
+            PTA.createPTA<analysis::pta::PointerAnalysisSFS>()
+            );
     } else {
         PA = std::unique_ptr<PointerAnalysis>(
             PTA.createPTA<analysis::pta::PointerAnalysisFS>()
@@ -583,6 +649,21 @@ int main(int argc, char *argv[])
 
     tm.stop();
     tm.report("INFO: Points-to analysis [new] took");
+
+    if (stats) {
+        const auto& st = PA->getStatistics();
+        llvm::errs() << "INFO: Processed nodes: " << st.getProcessedNodes()
+                     << ", changed: " << st.getChangedNodes()
+                     << ", iterations: " << st.getIterationsNum()
+                     << ", collapsed objects: " << st.getCollapsedObjects() << "\n";
+
+        const auto& cst = PTA.getCloningStatistics();
+        if (cst.clones > 0)
+            llvm::errs() << "INFO: Cloned functions: " << cst.functions
+                         << ", clones: " << cst.clones
+                         << ", nodes: " << cst.nodesBefore
+                         << " -> " << cst.nodesAfter << "\n";
+    }
     dumpPointerSubgraph(&PTA, type, todot);
 
     return 0;
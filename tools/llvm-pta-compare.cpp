@@ -40,6 +40,7 @@
 
 #include "dg/analysis/PointsTo/PointerAnalysisFI.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFS.h"
+#include "dg/analysis/PointsTo/PointerAnalysisSFS.h"
 #include "dg/analysis/PointsTo/Pointer.h"
 
 #include "TimeMeasure.h"
@@ -50,7 +51,8 @@ using llvm::errs;
 
 enum PTType {
     FLOW_SENSITIVE = 1,
-    FLOW_INSENSITIVE,
+    FLOW_INSENSITIVE = 2,
+    SPARSE_FLOW_SENSITIVE = 4,
 };
 
 static std::string
@@ -200,22 +202,88 @@ static bool verify_ptsets(llvm::Module *M,
     return ret;
 }
 
+static bool has_pointer(PSNode *node, const Pointer& ptr)
+{
+    for (const Pointer& ptr2 : node->pointsTo) {
+        if (ptr2.target->getUserData<llvm::Value>()
+                == ptr.target->getUserData<llvm::Value>()
+            && ptr2.offset == ptr.offset)
+            return true;
+    }
+
+    return false;
+}
+
+// the sparse analysis must give the same results as the flow-sensitive one
+static bool verify_same_ptsets(const llvm::Value *val,
+                               LLVMPointerAnalysis *fs,
+                               LLVMPointerAnalysis *sfs)
+{
+    PSNode *fsnode = fs->getPointsTo(val);
+    PSNode *sfsnode = sfs->getPointsTo(val);
+
+    if (!fsnode || !sfsnode) {
+        if (fsnode == sfsnode)
+            return true;
+
+        llvm::errs() << "Only " << (fsnode ? "FS" : "SFS")
+                     << " has points-to for: " << *val << "\n";
+        dumpPSNode(fsnode ? fsnode : sfsnode);
+        return false;
+    }
+
+    bool same = true;
+    for (const Pointer& ptr : fsnode->pointsTo)
+        same &= has_pointer(sfsnode, ptr);
+    for (const Pointer& ptr : sfsnode->pointsTo)
+        same &= has_pointer(fsnode, ptr);
+
+    if (!same) {
+        llvm::errs() << "FS and SFS differ: " << *val << "\n";
+        llvm::errs() << "FS ";
+        dumpPSNode(fsnode);
+        llvm::errs() << "SFS ";
+        dumpPSNode(sfsnode);
+        llvm::errs() << " ---- \n";
+    }
+
+    return same;
+}
+
+static bool verify_same_ptsets(llvm::Module *M,
+                               LLVMPointerAnalysis *fs,
+                               LLVMPointerAnalysis *sfs)
+{
+    using namespace llvm;
+    bool ret = true;
+
+    for (Function& F : *M)
+        for (BasicBlock& B : F)
+            for (Instruction& I : B)
+                if (!verify_same_ptsets(&I, fs, sfs))
+                    ret = false;
+
+    return ret;
+}
+
 int main(int argc, char *argv[])
 {
     llvm::Module *M;
     llvm::LLVMContext context;
     llvm::SMDiagnostic SMD;
     const char *module = nullptr;
-    unsigned type = FLOW_SENSITIVE | FLOW_INSENSITIVE;
+    unsigned type = 0;
 
     // parse options
     for (int i = 1; i < argc; ++i) {
-        // run only given points-to analysis
+        // run only given points-to analyses
         if (strcmp(argv[i], "-pta") == 0) {
             if (strcmp(argv[i+1], "fs") == 0)
-                type = FLOW_SENSITIVE;
+                type |= FLOW_SENSITIVE;
             else if (strcmp(argv[i+1], "fi") == 0)
-                type = FLOW_INSENSITIVE;
+                type |= FLOW_INSENSITIVE;
+            else if (strcmp(argv[i+1], "sfs") == 0)
+                type |= SPARSE_FLOW_SENSITIVE;
             else {
                 errs() << "Unknown PTA type" << argv[i + 1] << "\n";
                 abort();
@@ -228,10 +296,14 @@ int main(int argc, char *argv[])
     }
 
     if (!module) {
-        errs() << "Usage: % llvm-pta-compare [-pta fs|fi] IR_module\n";
+        errs() << "Usage: % llvm-pta-compare [-pta fs|fi|sfs]... IR_module\n";
         return 1;
     }
 
+    // by default compare flow-sensitive and flow-insensitive analysis
+    if (type == 0)
+        type = FLOW_SENSITIVE | FLOW_INSENSITIVE;
+
 #if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR <= 5))
     M = llvm::ParseIRFile(module, SMD, context);
 #else
@@ -250,6 +322,7 @@ int main(int argc, char *argv[])
 
     LLVMPointerAnalysis *PTAfs = nullptr;
     LLVMPointerAnalysis *PTAfi = nullptr;
+    LLVMPointerAnalysis *PTAsfs = nullptr;
 
     if (type & FLOW_INSENSITIVE) {
         PTAfi = new LLVMPointerAnalysis(M);
@@ -269,15 +342,32 @@ int main(int argc, char *argv[])
         tm.report("INFO: Points-to flow-sensitive analysis took");
     }
 
+    if (type & SPARSE_FLOW_SENSITIVE) {
+        PTAsfs = new LLVMPointerAnalysis(M);
+
+        tm.start();
+        PTAsfs->run<analysis::pta::PointerAnalysisSFS>();
+        tm.stop();
+        tm.report("INFO: Points-to sparse flow-sensitive analysis took");
+    }
+
     int ret = 0;
-    if (type == (FLOW_SENSITIVE | FLOW_INSENSITIVE)) {
+    if ((type & FLOW_SENSITIVE) && (type & FLOW_INSENSITIVE)) {
         ret = !verify_ptsets(M, PTAfi, PTAfs);
         if (ret == 0)
             llvm::errs() << "FS is a subset of FI, all OK\n";
     }
 
+    if ((type & FLOW_SENSITIVE) && (type & SPARSE_FLOW_SENSITIVE)) {
+        if (!verify_same_ptsets(M, PTAfs, PTAsfs))
+            ret = 1;
+        else
+            llvm::errs() << "SFS is the same as FS, all OK\n";
+    }
+
     delete PTAfi;
     delete PTAfs;
+    delete PTAsfs;
 
     return ret;
 }
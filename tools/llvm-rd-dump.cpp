@@ -258,7 +258,7 @@ dumpRDdot(LLVMReachingDefinitions *RD, bool dump_rd)
                 DefSite var = pair.first;
                 if (colors.find(var.target) == colors.end())
                     colors[var.target] = rand();
-                for (auto& dest: pair.second) {
+                for (RDNode *dest : pair.second) {
                     printf("\tNODE%p -> NODE%p [color=\"#%X\" style=\"dotted\"]",
                            static_cast<void*>(node), static_cast<void*>(dest),
                            colors[var.target]);
@@ -293,10 +293,13 @@ int main(int argc, char *argv[])
     llvm::SMDiagnostic SMD;
     bool todot = false;
     bool dump_rd = false;
+    bool stats = false;
     const char *module = nullptr;
     Offset::type field_senitivity = Offset::UNKNOWN;
     bool rd_strong_update_unknown = false;
     Offset::type max_set_size = Offset::UNKNOWN;
+    unsigned threads = 1;
+    const char *pta_cache = "";
 
     enum {
         FLOW_SENSITIVE = 1,
@@ -317,6 +320,8 @@ int main(int argc, char *argv[])
         } else if (strcmp(argv[i], "-rda") == 0) {
             if (strcmp(argv[i+1], "ss") == 0)
                 rda = RdaType::SEMISPARSE;
+        } else if (strcmp(argv[i], "-pta-cache") == 0) {
+            pta_cache = argv[i+1];
         } else if (strcmp(argv[i], "-pta-field-sensitive") == 0) {
             field_senitivity = static_cast<Offset::type>(atoll(argv[i + 1]));
         } else if (strcmp(argv[i], "-rd-max-set-size") == 0) {
@@ -325,6 +330,12 @@ int main(int argc, char *argv[])
                 llvm::errs() << "Invalid -rd-max-set-size argument\n";
                 abort();
             }
+        } else if (strcmp(argv[i], "-rd-threads") == 0) {
+            threads = static_cast<unsigned>(atoi(argv[i + 1]));
+            if (threads == 0) {
+                llvm::errs() << "Invalid -rd-threads argument\n";
+                abort();
+            }
         } else if (strcmp(argv[i], "-rd-strong-update-unknown") == 0) {
             rd_strong_update_unknown = true;
         } else if (strcmp(argv[i], "-dot") == 0) {
@@ -333,6 +344,8 @@ int main(int argc, char *argv[])
             verbose = true;
         } else if (strcmp(argv[i], "-dump-rd") == 0) {
             dump_rd = true;
+        } else if (strcmp(argv[i], "-stats") == 0) {
+            stats = true;
         } else if (strcmp(argv[i], "-entry") == 0) {
             entryFunc = argv[i+1];
         } else {
@@ -361,7 +374,14 @@ int main(int argc, char *argv[])
 
     debug::TimeMeasure tm;
 
-    LLVMPointerAnalysis PTA(M, entryFunc, field_senitivity);
+    LLVMPointerAnalysisOptions ptaOpts;
+    ptaOpts.setEntryFunction(entryFunc);
+    ptaOpts.setFieldSensitivity(field_senitivity);
+    ptaOpts.cacheDirectory = pta_cache;
+    if (type == FLOW_SENSITIVE)
+        ptaOpts.analysisType = LLVMPointerAnalysisOptions::AnalysisType::fs;
+
+    LLVMPointerAnalysis PTA(M, ptaOpts);
 
     tm.start();
 
@@ -378,6 +398,7 @@ int main(int argc, char *argv[])
     opts.entryFunction = entryFunc;
     opts.strongUpdateUnknown = rd_strong_update_unknown;
     opts.maxSetSize = max_set_size;
+    opts.threads = threads;
 
     LLVMReachingDefinitions RD(M, &PTA, opts);
     tm.start();
@@ -388,6 +409,16 @@ int main(int argc, char *argv[])
     tm.stop();
     tm.report("INFO: Reaching definitions analysis took");
 
+    if (stats) {
+        const auto& st = RD.getStatistics();
+        llvm::errs() << "INFO: Blocks: " << st.getBlocksNum()
+                     << ", processed: " << st.getProcessedBlocks()
+                     << ", changed: " << st.getChangedBlocks()
+                     << ", merges: " << st.getMergesNum()
+                     << ", iterations: " << st.getIterationsNum()
+                     << ", parallel groups: " << st.getGroupsNum() << "\n";
+    }
+
     dumpRD(&RD, todot, dump_rd);
 
     return 0;
@@ -50,6 +50,52 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[]) {
                        llvm::cl::value_desc("N"), llvm::cl::init(dg::analysis::Offset::UNKNOWN),
                        llvm::cl::cat(SlicingOpts));
     
+    llvm::cl::opt<uint64_t> ptaObjectFieldsBudget("pta-object-fields-budget",
+        llvm::cl::desc("Make PTA field insensitive for the memory objects that get\n"
+                       "pointers on more than N offsets. Default is no limit (N = 0).\n"),
+                       llvm::cl::value_desc("N"), llvm::cl::init(0),
+                       llvm::cl::cat(SlicingOpts));
+    
+    llvm::cl::opt<bool> ptaCollapseLoopObjects("pta-collapse-loop-objects",
+        llvm::cl::desc("Make PTA field insensitive for the memory objects accessed\n"
+                       "via GEPs on loops (default=false).\n"),
+                       llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+    
+    llvm::cl::opt<unsigned> ptaThreads("pta-threads",
+        llvm::cl::desc("Solve flow-insensitive PTA using N threads (default 1).\n"),
+                       llvm::cl::value_desc("N"), llvm::cl::init(1),
+                       llvm::cl::cat(SlicingOpts));
+    
+    llvm::cl::opt<uint64_t> ptaQueryBudget("pta-query-budget",
+        llvm::cl::desc("With demand-driven PTA, give up computing the points-to set\n"
+                       "of a pointer (and assume it points anywhere) when the query\n"
+                       "needs more than N nodes. Default is no limit (N = 0).\n"),
+                       llvm::cl::value_desc("N"), llvm::cl::init(0),
+                       llvm::cl::cat(SlicingOpts));
+    
+    llvm::cl::opt<std::string> ptaCache("pta-cache",
+        llvm::cl::desc("Store the results of PTA into the directory DIR and reuse them\n"
+                       "in the next runs on the same module with the same options.\n"),
+                       llvm::cl::value_desc("DIR"), llvm::cl::init(""),
+                       llvm::cl::cat(SlicingOpts));
+    
+    llvm::cl::opt<unsigned> ptaCloneDepth("pta-clone-depth",
+        llvm::cl::desc("Clone the functions for their call sites in PTA if they call\n"
+                       "other functions nested at most K - 1 levels deep.\n"
+                       "Default is no cloning (K = 0).\n"),
+                       llvm::cl::value_desc("K"), llvm::cl::init(0),
+                       llvm::cl::cat(SlicingOpts));
+    
+    llvm::cl::opt<bool> ptaCloneAllocWrappers("pta-clone-alloc-wrappers",
+        llvm::cl::desc("Clone the functions that return heap memory in PTA (default=false).\n"),
+                       llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+    
+    llvm::cl::opt<uint64_t> ptaCloningBudget("pta-cloning-budget",
+        llvm::cl::desc("Create at most N nodes by cloning functions in PTA.\n"
+                       "Default is the size of the graph (N = 0).\n"),
+                       llvm::cl::value_desc("N"), llvm::cl::init(0),
+                       llvm::cl::cat(SlicingOpts));
+    
     llvm::cl::opt<bool> rdaStrongUpdateUnknown("rd-strong-update-unknown",
         llvm::cl::desc("Let reaching defintions analysis do strong updates on memory defined\n"
                        "with uknown offset in the case, that new definition overwrites\n"
@@ -73,7 +119,10 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[]) {
         llvm::cl::values(
             clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::fi, "fi", "Flow-insensitive PTA (default)"),
             clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::fs, "fs", "Flow-sensitive PTA"),
-            clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::inv, "inv", "PTA with invalidate nodes")
+            clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::inv, "inv", "PTA with invalidate nodes"),
+            clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::sfs, "sfs", "Sparse flow-sensitive PTA"),
+            clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::demand, "demand",
+                       "Demand-driven flow-insensitive PTA (computes only what is needed)")
     #if LLVM_VERSION_MAJOR < 4
             , nullptr
     #endif
@@ -133,6 +182,14 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[]) {
     options.dgOptions.PTAOptions.fieldSensitivity
                                     = dg::analysis::Offset(ptaFieldSensitivity);
     options.dgOptions.PTAOptions.analysisType = ptaType;
+    options.dgOptions.PTAOptions.objectFieldsBudget = ptaObjectFieldsBudget;
+    options.dgOptions.PTAOptions.collapseLoopObjects = ptaCollapseLoopObjects;
+    options.dgOptions.PTAOptions.threads = ptaThreads;
+    options.dgOptions.PTAOptions.queryBudget = ptaQueryBudget;
+    options.dgOptions.PTAOptions.cacheDirectory = ptaCache;
+    options.dgOptions.PTAOptions.cloneDepth = ptaCloneDepth;
+    options.dgOptions.PTAOptions.cloneAllocWrappers = ptaCloneAllocWrappers;
+    options.dgOptions.PTAOptions.cloningBudget = ptaCloningBudget;
 
     options.dgOptions.RDAOptions.entryFunction = entryFunction;
     options.dgOptions.RDAOptions.strongUpdateUnknown = rdaStrongUpdateUnknown;
@@ -408,6 +408,12 @@ public:
         else if (options.dgOptions.PTAOptions.analysisType
                     == LLVMPointerAnalysisOptions::AnalysisType::inv)
             module_comment += "flow-sensitive with invalidate\n";
+        else if (options.dgOptions.PTAOptions.analysisType
+                    == LLVMPointerAnalysisOptions::AnalysisType::sfs)
+            module_comment += "sparse flow-sensitive\n";
+        else if (options.dgOptions.PTAOptions.analysisType
+                    == LLVMPointerAnalysisOptions::AnalysisType::demand)
+            module_comment += "demand-driven flow-insensitive\n";
 
         module_comment+= ";   * PTA field sensitivity: ";
         if (options.dgOptions.PTAOptions.fieldSensitivity == Offset::UNKNOWN)